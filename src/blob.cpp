@@ -0,0 +1,235 @@
+/*
+ * BLOB.CPP                         Copyright (c) 2026-, Benoit Germain
+ *
+ * Immutable byte buffer deep userdata.
+ */
+
+/*
+===============================================================================
+
+Copyright (C) 2026- benoit Germain <bnt.germain@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+===============================================================================
+*/
+
+#include "_pch.hpp"
+#include "blob.hpp"
+
+#include "blobfactory.hpp"
+
+// #################################################################################################
+// #################################################################################################
+namespace {
+    // #############################################################################################
+    // #############################################################################################
+
+    template <bool OPT>
+    [[nodiscard]]
+    static inline Blob* ToBlob(lua_State* const L_, StackIndex const idx_)
+    {
+        Blob* const _blob{ static_cast<Blob*>(BlobFactory::Instance.toDeep(L_, idx_)) };
+        if constexpr (!OPT) {
+            luaL_argcheck(L_, _blob != nullptr, idx_, "expecting a blob object"); // doesn't return if blob is nullptr
+            LUA_ASSERT(L_, _blob->U == Universe::Get(L_));
+        }
+        return _blob;
+    }
+
+    // #############################################################################################
+
+    // converts a relative string position as string.sub() and string.byte() do: negative means back from the end
+    [[nodiscard]]
+    static size_t PosRelative(lua_Integer const pos_, size_t const len_)
+    {
+        if (pos_ >= 0) {
+            return static_cast<size_t>(pos_);
+        } else if (static_cast<size_t>(-pos_) > len_) {
+            return 0;
+        }
+        return len_ - static_cast<size_t>(-pos_) + 1;
+    }
+
+    // #############################################################################################
+
+    // reads the [i, j] range arguments at the specified index the way string.sub() and string.byte() do
+    // returns the 0-based start and the length of the range, clamped to the blob contents
+    [[nodiscard]]
+    static std::pair<size_t, size_t> CheckRange(lua_State* const L_, StackIndex const idx_, Blob const& blob_, lua_Integer const defStart_, lua_Integer const defEnd_)
+    {
+        size_t _start{ PosRelative(luaL_optinteger(L_, idx_, defStart_), blob_.size) };
+        size_t _end{ PosRelative(luaL_optinteger(L_, idx_ + 1, defEnd_), blob_.size) };
+        _start = std::max(_start, size_t{ 1 });
+        _end = std::min(_end, blob_.size);
+        if (_start > _end) {
+            return { 0, 0 };
+        }
+        return { _start - 1, _end - _start + 1 };
+    }
+
+} // namespace
+
+// #################################################################################################
+// #################################################################################################
+// ##################################### Blob implementation #######################################
+// #################################################################################################
+// #################################################################################################
+
+Blob::Blob(Universe* const U_, std::string_view const& bytes_)
+: DeepPrelude{ BlobFactory::Instance }
+, U{ U_ }
+, size{ bytes_.size() }
+{
+    std::memcpy(reinterpret_cast<char*>(this + 1), bytes_.data(), bytes_.size());
+}
+
+// #################################################################################################
+
+// allocates the header and the bytes together, so that the contents are copied only once, when the blob is created
+[[nodiscard]]
+Blob* Blob::Create(Universe* const U_, std::string_view const& bytes_)
+{
+    void* const _mem{ U_->internalAllocator.alloc(sizeof(Blob) + bytes_.size()) };
+    return _mem ? new (_mem) Blob{ U_, bytes_ } : nullptr;
+}
+
+// #################################################################################################
+// ######################################## Blob API ###############################################
+// #################################################################################################
+
+/*
+ * string = blob:__concat(blob|string, blob|string)
+ *
+ * Return the concatenation of a pair of items, one of them being a blob
+ */
+LUAG_FUNC(blob_concat)
+{                                                                                                  // L_: blob1? blob2?
+    for (StackIndex const _i : { StackIndex{ 1 }, StackIndex{ 2 } }) {
+        Blob const* const _blob{ ToBlob<true>(L_, _i) };
+        if (_blob != nullptr) {
+            luaW_pushstring(L_, _blob->bytes());
+            lua_replace(L_, _i);
+        }
+    }
+    lua_concat(L_, 2);
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * number = blob:len()
+ *
+ * Return the number of bytes in the blob
+ */
+LUAG_FUNC(blob_len)
+{
+    Blob const* const _blob{ ToBlob<false>(L_, StackIndex{ 1 }) };
+    lua_pushinteger(L_, static_cast<lua_Integer>(_blob->size));
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * [number...] = blob:byte([i [, j]])
+ *
+ * Same as string.byte() on the blob contents
+ */
+LUAG_FUNC(blob_byte)
+{
+    Blob const* const _blob{ ToBlob<false>(L_, StackIndex{ 1 }) };
+    lua_Integer const _first{ luaL_optinteger(L_, 2, 1) };
+    auto const [_start, _count] = CheckRange(L_, StackIndex{ 2 }, *_blob, _first, _first);
+    if (_count >= static_cast<size_t>(std::numeric_limits<int>::max())) {
+        raise_luaL_error(L_, "blob slice too long");
+    }
+    luaL_checkstack(L_, static_cast<int>(_count), "blob slice too long");
+    std::string_view const _bytes{ _blob->bytes().substr(_start, _count) };
+    for (char const _c : _bytes) {
+        lua_pushinteger(L_, static_cast<unsigned char>(_c));
+    }
+    return static_cast<int>(_count);
+}
+
+// #################################################################################################
+
+/*
+ * string = blob:sub(i [, j])
+ *
+ * Same as string.sub() on the blob contents: only the requested range is copied in the state
+ */
+LUAG_FUNC(blob_sub)
+{
+    Blob const* const _blob{ ToBlob<false>(L_, StackIndex{ 1 }) };
+    luaL_checkinteger(L_, 2);
+    auto const [_start, _count] = CheckRange(L_, StackIndex{ 2 }, *_blob, 1, -1);
+    luaW_pushstring(L_, _blob->bytes().substr(_start, _count));
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * string = blob:tostring()
+ *
+ * Return the whole contents of the blob as a Lua string
+ */
+LUAG_FUNC(blob_tostring)
+{
+    Blob const* const _blob{ ToBlob<false>(L_, StackIndex{ 1 }) };
+    luaW_pushstring(L_, _blob->bytes());
+    return 1;
+}
+
+// #################################################################################################
+
+namespace {
+    namespace local {
+        static luaL_Reg const sBlobMT[] = {
+            { "__concat", LG_blob_concat },
+            { "__len", LG_blob_len },
+            { "__tostring", LG_blob_tostring },
+            { "byte", LG_blob_byte },
+            { "len", LG_blob_len },
+            { "sub", LG_blob_sub },
+            { "tostring", LG_blob_tostring },
+            { nullptr, nullptr }
+        };
+    } // namespace local
+} // namespace
+// as for the LindaFactory, the factory is instanciated here to keep sBlobMT private to blob.cpp
+/*static*/ BlobFactory BlobFactory::Instance{ local::sBlobMT };
+
+// #################################################################################################
+// #################################################################################################
+
+/*
+ * ud = lanes.blob(string)
+ *
+ * returns a blob holding a copy of the string, or raises an error if creation failed
+ */
+LUAG_FUNC(blob)
+{
+    luaL_checktype(L_, 1, LUA_TSTRING);
+    luaL_argcheck(L_, lua_gettop(L_) == 1, 2, "too many arguments");
+    BlobFactory::Instance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 0 });                  // L_: string blob
+    return 1;
+}
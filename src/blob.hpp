@@ -0,0 +1,36 @@
+#pragma once
+
+#include "deep.hpp"
+#include "universe.hpp"
+
+// #################################################################################################
+
+// an immutable byte buffer, shared by reference between all the states that hold a proxy on it
+// the bytes are stored right after the header, in a single allocation from the internal allocator
+class Blob final
+: public DeepPrelude // Deep userdata MUST start with this header
+{
+    public:
+    Universe* const U{ nullptr }; // the universe this blob belongs to
+    size_t const size{};
+
+    private:
+    Blob(Universe* const U_, std::string_view const& bytes_);
+
+    public:
+    // always "in-place constructed" inside a buffer large enough to hold the bytes, by Blob::Create()
+    static void operator delete(void* p_) { Blob* const _blob{ static_cast<Blob*>(p_) }; _blob->U->internalAllocator.free(p_, sizeof(Blob) + _blob->size); }
+
+    ~Blob() = default;
+    Blob() = delete;
+    // non-copyable, non-movable
+    Blob(Blob const&) = delete;
+    Blob(Blob const&&) = delete;
+    Blob& operator=(Blob const&) = delete;
+    Blob& operator=(Blob const&&) = delete;
+
+    [[nodiscard]]
+    std::string_view bytes() const { return std::string_view{ reinterpret_cast<char const*>(this + 1), size }; }
+    [[nodiscard]]
+    static Blob* Create(Universe* U_, std::string_view const& bytes_);
+};
@@ -0,0 +1,84 @@
+/*
+ * BLOBFACTORY.CPP                    Copyright (c) 2026-, Benoit Germain
+ *
+ * Blob deep userdata factory
+ */
+
+/*
+===============================================================================
+
+Copyright (C) 2026- benoit Germain <bnt.germain@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+===============================================================================
+*/
+
+#include "_pch.hpp"
+#include "blobfactory.hpp"
+
+#include "blob.hpp"
+
+static constexpr std::string_view kBlobMetatableName{ "Blob" };
+
+// #################################################################################################
+
+void BlobFactory::createMetatable(lua_State* L_) const
+{
+    STACK_CHECK_START_REL(L_, 0);
+    lua_newtable(L_);                                                                              // L_: mt
+
+    // protect metatable from external access
+    luaW_pushstring(L_, kBlobMetatableName);                                                       // L_: mt "<name>"
+    lua_setfield(L_, -2, "__metatable");                                                           // L_: mt
+
+    // the blob functions
+    luaW_registerlibfuncs(L_, mBlobMT);
+
+    // metatable is its own index
+    lua_pushvalue(L_, kIdxTop);                                                                    // L_: mt mt
+    luaW_setfield(L_, StackIndex{ -2 }, std::string_view{ "__index" });                            // L_: mt
+
+    STACK_CHECK(L_, 1);
+}
+
+// #################################################################################################
+
+void BlobFactory::deleteDeepObjectInternal([[maybe_unused]] lua_State* L_, DeepPrelude* o_) const
+{
+    delete static_cast<Blob*>(o_); // operator delete overload ensures things go as expected
+}
+
+// #################################################################################################
+
+std::string_view BlobFactory::moduleName() const
+{
+    // same as lindas: blobs are implemented by the lanes core module, which remains loaded as long as the main state is around
+    return std::string_view{};
+}
+
+// #################################################################################################
+
+DeepPrelude* BlobFactory::newDeepObjectInternal(lua_State* const L_) const
+{
+    // we always expect the string at the bottom of the stack
+    // The deep data is allocated separately of Lua stack; we might no longer be around when last reference to it is being released.
+    // nullptr if the allocation failed, DeepFactory::pushDeepUserdata() raises the error
+    return Blob::Create(Universe::Get(L_), luaW_tostring(L_, StackIndex{ 1 }));
+}
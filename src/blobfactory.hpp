@@ -0,0 +1,28 @@
+#pragma once
+
+#include "deep.hpp"
+
+// #################################################################################################
+
+class BlobFactory final
+: public DeepFactory
+{
+    public:
+    static BlobFactory Instance;
+
+    ~BlobFactory() override = default;
+    BlobFactory(luaL_Reg const blobMT_[])
+    : mBlobMT{ blobMT_ }
+    {
+    }
+
+    private:
+    luaL_Reg const* const mBlobMT{ nullptr };
+
+    void createMetatable(lua_State* L_) const override;
+    void deleteDeepObjectInternal(lua_State* L_, DeepPrelude* o_) const override;
+    [[nodiscard]]
+    std::string_view moduleName() const override;
+    [[nodiscard]]
+    DeepPrelude* newDeepObjectInternal(lua_State* L_) const override;
+};
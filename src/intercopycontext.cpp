@@ -91,7 +91,7 @@ std::string_view InterCopyContext::findLookupName() const
         }
     } else {
         // fetch the name from the source state's lookup table
-        kLookupRegKey.pushValue(L1);                                                               // L1: ... v ... {}
+        tools::PushLookupDatabase(U, L1);                                                          // L1: ... v ... {}
         STACK_CHECK(L1, 1);
         LUA_ASSERT(L1, lua_istable(L1, -1));
         lua_pushvalue(L1, L1_i);                                                                   // L1: ... v ... {} v
@@ -102,6 +102,11 @@ std::string_view InterCopyContext::findLookupName() const
     // popping doesn't invalidate the pointer since this is an interned string gotten from the lookup database
     lua_pop(L1, (mode == LookupMode::FromKeeper) ? 1 : 2);                                         // L1: ... v ...
     STACK_CHECK(L1, 0);
+    // the object can come from a module that was bound from the universe lookup index without being walked in this state
+    // (a table missed that way would be cloned instead of looked up)
+    if (_fqn.empty() && mode != LookupMode::FromKeeper && tools::CompleteLookupDatabase(U, L1)) {
+        return findLookupName();
+    }
     if (_fqn.empty() && !lua_istable(L1, L1_i)) { // raise an error if we try to send an unknown function/userdata (but not for tables)
         // try to discover the name of the function/userdata we want to send
         kLaneNameRegKey.pushValue(L1);                                                             // L1: ... v ... lane_name
@@ -137,6 +142,22 @@ std::string_view InterCopyContext::findLookupName() const
 // xxh64 of string "kMtIdRegKey" generated at https://www.pelock.com/products/hash-calculator
 static constexpr RegistryUniqueKey kMtIdRegKey{ 0xA8895DCF4EC3FE3Cull };
 
+// registry key of the table where copyFunction() caches the bytecode of the functions it dumped, weakly keyed by the functions
+// xxh64 of string "kBytecodeCacheRegKey" generated at https://www.pelock.com/products/hash-calculator
+static constexpr RegistryUniqueKey kBytecodeCacheRegKey{ 0x5745D741A43F5A41ull };
+// when the bytecode cached by a state reaches that many bytes, the cache is emptied
+static constexpr lua_Integer kMaxBytecodeCacheSize{ 256 * 1024 };
+
+// registry key of the table where interCopyRecord() caches the destination key strings of record-like tables, by shape
+// xxh64 of string "kShapeCacheRegKey" generated at https://www.pelock.com/products/hash-calculator
+static constexpr RegistryUniqueKey kShapeCacheRegKey{ 0x7C41E9A3D05B62F8ull };
+
+// a shape is only recorded for tables with that many string keys at most, none of them longer than kMaxShapeKeyLength
+static constexpr int kMaxShapeKeys{ 64 };
+static constexpr size_t kMaxShapeKeyLength{ 40 };
+// when the cache of a state holds that many shapes, it is emptied
+static constexpr lua_Integer kMaxShapes{ 256 };
+
 // get a unique ID for metatable at [i].
 [[nodiscard]]
 static lua_Integer get_mt_id(Universe* const U_, lua_State* const L_, StackIndex const idx_)
@@ -179,27 +200,46 @@ static lua_Integer get_mt_id(Universe* const U_, lua_State* const L_, StackIndex
 void InterCopyContext::copyFunction() const
 {
     LUA_ASSERT(L1, L2_cache_i != 0);                                                               // L1: ... f                                      L2: ... {cache} ... p
-    STACK_GROW(L1, 2);
+    STACK_GROW(L1, 4);
     STACK_CHECK_START_REL(L1, 0);
     STACK_CHECK_START_REL(L2, 0);
 
-    // 'luaW_dump()' needs the function at top of stack
-    // if already on top of the stack, no need to push again
-    bool const _needToPush{ L1_i != lua_gettop(L1) };
-    if (_needToPush) {
-        lua_pushvalue(L1, L1_i);                                                                   // L1: ... f
-    }
-
-    //
-    // "value returned is the error code returned by the last call
-    // to the writer" (and we only return 0)
-    // not sure this could ever fail but for memory shortage reasons
-    // last argument is Lua 5.4-specific (no stripping)
-    tools::PushFunctionBytecode(L1, L2, U->stripFunctions);                                        // L1: ... f                                      L2: ... {cache} ... p "<bytecode>"
-
-    // if pushed, we need to pop
-    if (_needToPush) {
-        lua_pop(L1, 1);                                                                            // L1: ...
+    // a function transferred several times from the same state (a lane body, a callback sent repeatedly) is dumped only once:
+    // its bytecode is cached in the source state, in a table weakly keyed by the function so that the entry goes away with it
+    // there is no way to reach the prototype of the function with the Lua API, so two closures of the same function are dumped separately
+    // no need to key it with the strip flag as well, since the same setting applies to the whole universe
+    kBytecodeCacheRegKey.getSubTableMode(L1, "k");                                                 // L1: ... f ... {bc}
+    lua_pushvalue(L1, L1_i);                                                                       // L1: ... f ... {bc} f
+    if (luaW_rawget(L1, StackIndex{ -2 }) == LuaType::STRING) {                                   // L1: ... f ... {bc} "<bytecode>"
+        luaW_pushstring(L2, luaW_tostring(L1, kIdxTop));                                           //                                                L2: ... {cache} ... p "<bytecode>"
+        lua_pop(L1, 2);                                                                            // L1: ... f ...
+    } else {                                                                                       // L1: ... f ... {bc} nil
+        // 'luaW_dump()' needs the function at top of stack
+        lua_pop(L1, 1);                                                                            // L1: ... f ... {bc}
+        lua_pushvalue(L1, L1_i);                                                                   // L1: ... f ... {bc} f
+        //
+        // "value returned is the error code returned by the last call
+        // to the writer" (and we only return 0)
+        // not sure this could ever fail but for memory shortage reasons
+        // last argument is Lua 5.4-specific (no stripping)
+        tools::PushFunctionBytecode(L1, L2, U->stripFunctions);                                    // L1: ... f ... {bc} f                           L2: ... {cache} ... p "<bytecode>"
+        // keep the cache bounded, even in states where the GC doesn't run often enough to clear the weak entries
+        lua_Integer const _bcSize{ static_cast<lua_Integer>(luaW_tostring(L2, kIdxTop).size()) };
+        lua_rawgeti(L1, -2, 0);                                                                    // L1: ... f ... {bc} f size|nil
+        lua_Integer const _cached{ lua_tointeger(L1, -1) + _bcSize };
+        lua_pop(L1, 1);                                                                            // L1: ... f ... {bc} f
+        if (_cached > kMaxBytecodeCacheSize) {
+            lua_pop(L1, 2);                                                                        // L1: ... f ...
+            kBytecodeCacheRegKey.setValue(L1, [](lua_State* L_) { lua_pushnil(L_); });
+            kBytecodeCacheRegKey.getSubTableMode(L1, "k");                                         // L1: ... f ... {bc}
+            lua_pushvalue(L1, L1_i);                                                               // L1: ... f ... {bc} f
+        }
+        lua_pushinteger(L1, (_cached > kMaxBytecodeCacheSize) ? _bcSize : _cached);                // L1: ... f ... {bc} f size
+        lua_rawseti(L1, -3, 0);                                                                    // L1: ... f ... {bc} f
+        // bc[f] = "<bytecode>"
+        luaW_pushstring(L1, luaW_tostring(L2, kIdxTop));                                           // L1: ... f ... {bc} f "<bytecode>"
+        lua_rawset(L1, -3);                                                                        // L1: ... f ... {bc}
+        lua_pop(L1, 1);                                                                            // L1: ... f ...
     }
 
     // When we are done, the stack of L1 should be the original one, with the bytecode string added on top of L2
@@ -318,11 +358,17 @@ void InterCopyContext::lookupNativeFunction() const
 
     case LookupMode::LaneBody:
     case LookupMode::FromKeeper:
-        kLookupRegKey.pushValue(L2);                                                               // L1: ... f ...                                  L2: {}
+        tools::PushLookupDatabase(U, L2);                                                          // L1: ... f ...                                  L2: {}
         STACK_CHECK(L2, 1);
         LUA_ASSERT(L1, lua_istable(L2, -1));
         luaW_pushstring(L2, _fqn);                                                                 // L1: ... f ...                                  L2: {} "f.q.n"
-        LuaType const _objType{ luaW_rawget(L2, StackIndex{ -2 }) };                               // L1: ... f ...                                  L2: {} f
+        LuaType _objType{ luaW_rawget(L2, StackIndex{ -2 }) };                                     // L1: ... f ...                                  L2: {} f
+        // the name can come from a module that was bound from the universe lookup index without being walked in this state
+        if (_objType == LuaType::NIL && tools::CompleteLookupDatabase(U, L2)) {
+            lua_pop(L2, 1);                                                                        // L1: ... f ...                                  L2: {}
+            luaW_pushstring(L2, _fqn);                                                             // L1: ... f ...                                  L2: {} "f.q.n"
+            _objType = luaW_rawget(L2, StackIndex{ -2 });                                          // L1: ... f ...                                  L2: {} f
+        }
         // nil means we don't know how to transfer stuff: user should do something
         // anything other than function or table should not happen!
         if (_objType != LuaType::FUNCTION && _objType != LuaType::TABLE && _objType != LuaType::USERDATA) {
@@ -421,13 +467,20 @@ bool InterCopyContext::lookupTable() const
 
     case LookupMode::LaneBody:
     case LookupMode::FromKeeper:
-        kLookupRegKey.pushValue(L2);                                                               // L1: ... t ...                                  L2: {}
+        tools::PushLookupDatabase(U, L2);                                                          // L1: ... t ...                                  L2: {}
         STACK_CHECK(L2, 1);
         LUA_ASSERT(L1, lua_istable(L2, -1));
         luaW_pushstring(L2, _fqn);                                                                 //                                                L2: {} "f.q.n"
+        LuaType _objType{ luaW_rawget(L2, StackIndex{ -2 }) };                                     //                                                L2: {} t
+        // the name can come from a module that was bound from the universe lookup index without being walked in this state
+        if (_objType == LuaType::NIL && tools::CompleteLookupDatabase(U, L2)) {
+            lua_pop(L2, 1);                                                                        //                                                L2: {}
+            luaW_pushstring(L2, _fqn);                                                             //                                                L2: {} "f.q.n"
+            _objType = luaW_rawget(L2, StackIndex{ -2 });                                          //                                                L2: {} t
+        }
         // we accept destination lookup failures in the case of transfering the Lanes body function (this will result in the source table being cloned instead)
         // but not when we extract something out of a keeper, as there is nothing to clone!
-        if (luaW_rawget(L2, StackIndex{ -2 }) == LuaType::NIL && mode == LookupMode::LaneBody) {   //                                                L2: {} t
+        if (_objType == LuaType::NIL && mode == LookupMode::LaneBody) {
             lua_pop(L2, 2);                                                                        // L1: ... t ...                                  L2:
             STACK_CHECK(L2, 0);
             return false;
@@ -455,13 +508,76 @@ bool InterCopyContext::lookupTable() const
 
 // #################################################################################################
 
-void InterCopyContext::interCopyKeyValuePair() const
+// pushes on L2_ the value at the top of L1_ if it is a boolean, a number or a string, which need none of the InterCopyContext machinery
+[[nodiscard]]
+static bool PushScalarValue(lua_State* const L1_, lua_State* const L2_)
+{
+    switch (luaW_type(L1_, kIdxTop)) {
+    case LuaType::BOOLEAN:
+        lua_pushboolean(L2_, lua_toboolean(L1_, -1));
+        return true;
+
+    case LuaType::NUMBER:
+#if defined LUA_LNUM || LUA_VERSION_NUM >= 503
+        if (lua_isinteger(L1_, -1)) {
+            lua_pushinteger(L2_, lua_tointeger(L1_, -1));
+            return true;
+        }
+#endif // defined LUA_LNUM || LUA_VERSION_NUM >= 503
+        lua_pushnumber(L2_, lua_tonumber(L1_, -1));
+        return true;
+
+    case LuaType::STRING:
+        luaW_pushstring(L2_, luaW_tostring(L1_, kIdxTop));
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// #################################################################################################
+
+// true if the key at key_ is an integer in [1, narr_], i.e. an entry copied by the array part loop of interCopyTable
+[[nodiscard]]
+static bool IsArrayPartKey(lua_State* const L_, StackIndex const key_, int const narr_)
+{
+    if (luaW_type(L_, key_) != LuaType::NUMBER) {
+        return false;
+    }
+    lua_Number const _k{ lua_tonumber(L_, key_) };
+    return (_k >= 1) && (_k <= narr_) && (static_cast<lua_Number>(static_cast<int>(_k)) == _k);
+}
+
+// #################################################################################################
+
+// copies the non-scalar value at the top of L1 as entry i_ of the table at the top of L2
+void InterCopyContext::interCopyArrayItem(int const i_) const
 {
     SourceIndex const _val_i{ lua_gettop(L1) };
-    SourceIndex const _key_i{ _val_i - 1 };
+
+    char* _valPath{ nullptr };
+    if (U->verboseErrors) {
+        _valPath = static_cast<char*>(alloca(name.size() + 32 + 3)); // +3 for [] and terminating 0
+        *std::format_to(_valPath, "{}[{}]", name, i_) = 0;
+    }
+
+    InterCopyContext const _c{ U, L2, L1, L2_cache_i, _val_i, VT::NORMAL, mode, _valPath ? _valPath : name };
+    if (_c.interCopyOne() != InterCopyResult::Success) {
+        raise_luaL_error(getErrL(), "Unable to copy %s entry '%s' because of value is of type '%s'", (vt == VT::NORMAL) ? "table" : "metatable", _valPath, luaL_typename(L1, _val_i));
+    }
+    LUA_ASSERT(L1, lua_istable(L2, -2));
+    lua_rawseti(L2, -2, i_); // add to table (pops val)
+}
+
+// #################################################################################################
+
+void InterCopyContext::interCopyKeyValuePair() const
+{
+    SourceIndex const _key_i{ lua_gettop(L1) - 1 };
 
     // For the key, only basic key types are copied over. others ignored
-    InterCopyContext _c{ U, L2, L1, L2_cache_i, _key_i, VT::KEY, mode, name };
+    InterCopyContext const _c{ U, L2, L1, L2_cache_i, _key_i, VT::KEY, mode, name };
     if (_c.interCopyOne() != InterCopyResult::Success) {
         return;
         // we could raise an error instead of ignoring the table entry, like so:
@@ -469,6 +585,20 @@ void InterCopyContext::interCopyKeyValuePair() const
         // maybe offer this possibility as a global configuration option, or a linda setting, or as a argument of the call causing the transfer?
     }
 
+    // need a function to prevent overflowing the stack with verboseErrors-induced alloca()
+    interCopyEntryValue();
+    LUA_ASSERT(L1, lua_istable(L2, -3));
+    lua_rawset(L2, -3); // add to table (pops key & val)
+}
+
+// #################################################################################################
+
+// copies the value of the key/value pair at the top of L1, with a name built from the key for error reporting
+void InterCopyContext::interCopyEntryValue() const
+{
+    SourceIndex const _val_i{ lua_gettop(L1) };
+    SourceIndex const _key_i{ _val_i - 1 };
+
     char* _valPath{ nullptr };
     if (U->verboseErrors) {
         // for debug purposes, let's try to build a useful name
@@ -503,15 +633,11 @@ void InterCopyContext::interCopyKeyValuePair() const
         }
     }
 
-    _c.L1_i = SourceIndex{ _val_i };
     // Contents of metatables are copied with cache checking. important to detect loops.
-    _c.vt = VT::NORMAL;
-    _c.name = _valPath ? _valPath : name;
+    InterCopyContext const _c{ U, L2, L1, L2_cache_i, _val_i, VT::NORMAL, mode, _valPath ? _valPath : name };
     if (_c.interCopyOne() != InterCopyResult::Success) {
         raise_luaL_error(getErrL(), "Unable to copy %s entry '%s' because of value is of type '%s'", (vt == VT::NORMAL) ? "table" : "metatable", _valPath, luaL_typename(L1, _val_i));
     }
-    LUA_ASSERT(L1, lua_istable(L2, -3));
-    lua_rawset(L2, -3); // add to table (pops key & val)
 }
 
 // #################################################################################################
@@ -690,12 +816,149 @@ bool InterCopyContext::pushCachedMetatable() const
 
 // #################################################################################################
 
+// A shape is the sequence of the string keys of a record-like table, in lua_next() order. The destination state caches the
+// strings of each shape in an array, indexed by the address of the source string of its first key.
+// Pushes on L2 the shape that matches the first key of the table at L1_i, or nil. Returns the number of keys of the shape, or -1.
+// The shape is only a guess: interCopyRecord() checks each key against it.
+[[nodiscard]]
+int InterCopyContext::pushCachedShape() const
+{
+    STACK_GROW(L1, 2);
+    STACK_GROW(L2, 2);
+    STACK_CHECK_START_REL(L1, 0);
+    STACK_CHECK_START_REL(L2, 0);
+    lua_pushnil(L1);                                                                               // L1: ... t ... nil
+    if (!lua_next(L1, L1_i)) {                                                                     // L1: ... t ... [key val]
+        lua_pushnil(L2);                                                                           //                                                L2: ... nil
+        return -1;
+    }
+    void const* const _firstKey{ (luaW_type(L1, StackIndex{ -2 }) == LuaType::STRING) ? lua_tostring(L1, -2) : nullptr };
+    lua_pop(L1, 2);                                                                                // L1: ... t ...
+    STACK_CHECK(L1, 0);
+    if (_firstKey == nullptr) {
+        lua_pushnil(L2);                                                                           //                                                L2: ... nil
+        return -1;
+    }
+    kShapeCacheRegKey.getSubTableMode(L2, "v");                                                    //                                                L2: ... {shapes}
+    lua_pushlightuserdata(L2, const_cast<void*>(_firstKey));                                       //                                                L2: ... {shapes} p
+    bool const _found{ luaW_rawget(L2, StackIndex{ -2 }) == LuaType::TABLE };                      //                                                L2: ... {shapes} shape|nil
+    lua_remove(L2, -2);                                                                            //                                                L2: ... shape|nil
+    STACK_CHECK(L2, 1);
+    return _found ? static_cast<int>(lua_rawlen(L2, kIdxTop)) : -1;
+}
+
+// #################################################################################################
+
+// Copies the entries of the record-like table at L1_i into the table at the top of L2.
+// String keys are taken from the shape at shape_i_ (a table, or nil if none was cached) as long as they match the source keys,
+// instead of being interned again. If the table turns out to have another shape, it replaces the cached one.
+void InterCopyContext::interCopyRecord(StackIndex const shape_i_, int const nrec_) const
+{
+    STACK_GROW(L1, 2);
+    STACK_GROW(L2, 4);
+    STACK_CHECK_START_REL(L1, 0);
+    STACK_CHECK_START_REL(L2, 0);
+    bool _reuse{ lua_istable(L2, shape_i_) }; // true as long as the source keys match the ones of the cached shape
+    bool _cacheable{ true }; // false once we know the table has a key that can't be part of a shape
+    bool _dirty{ false }; // true once shape_i_ holds a shape built from this table, that must be cached
+    void const* _firstKey{ nullptr };
+    int _n{ 0 };
+
+    // from now on, the table at shape_i_ is built from this table, starting with the first prefix_ keys of the cached shape
+    auto _startNewShape = [this, shape_i_, nrec_](int const prefix_) {
+        lua_createtable(L2, nrec_, 0);                                                             //                                                L2: ... shape? ... newshape
+        for (int const _j : std::ranges::iota_view{ 1, prefix_ + 1 }) {
+            lua_rawgeti(L2, shape_i_, _j);                                                         //                                                L2: ... shape? ... newshape key
+            lua_rawseti(L2, -2, _j);                                                               //                                                L2: ... shape? ... newshape
+        }
+        lua_replace(L2, shape_i_);                                                                 //                                                L2: ... newshape ...
+    };
+
+    lua_pushnil(L1);                                                                               // L1: ... t ... nil
+    while (lua_next(L1, L1_i)) {                                                                   // L1: ... t ... key val       L2: ... shape t
+        ++_n;
+        if (luaW_type(L1, StackIndex{ -2 }) == LuaType::STRING) {
+            std::string_view const _key{ luaW_tostring(L1, StackIndex{ -2 }) };
+            if (_n == 1) {
+                _firstKey = _key.data();
+            }
+            if (_reuse) {
+                lua_rawgeti(L2, shape_i_, _n);                                                     //                                                L2: ... shape t key|nil
+                if (luaW_type(L2, kIdxTop) != LuaType::STRING || luaW_tostring(L2, kIdxTop) != _key) {
+                    lua_pop(L2, 1);                                                                //                                                L2: ... shape t
+                    _reuse = false;
+                }
+            }
+            if (!_reuse) {
+                luaW_pushstring(L2, _key);                                                         //                                                L2: ... shape t key
+                if (_cacheable && (_n > kMaxShapeKeys || _key.size() > kMaxShapeKeyLength)) {
+                    _cacheable = false;
+                }
+                if (_cacheable) {
+                    if (!_dirty) {
+                        // the keys of the cached shape matched up to this one
+                        _startNewShape(_n - 1);
+                        _dirty = true;
+                    }
+                    lua_pushvalue(L2, -1);                                                         //                                                L2: ... shape t key key
+                    lua_rawseti(L2, shape_i_, _n);                                                 //                                                L2: ... shape t key
+                }
+            }
+        } else {
+            // not a record after all
+            _reuse = false;
+            _cacheable = false;
+            InterCopyContext const _c{ U, L2, L1, L2_cache_i, SourceIndex{ lua_gettop(L1) - 1 }, VT::KEY, mode, name };
+            if (_c.interCopyOne() != InterCopyResult::Success) {                                   //                                                L2: ... shape t key?
+                // ignored, like in interCopyKeyValuePair()
+                lua_pop(L1, 1);                                                                    // L1: ... t ... key
+                continue;
+            }
+        }
+        if (!PushScalarValue(L1, L2)) {                                                            //                                                L2: ... shape t key val?
+            // need a function to prevent overflowing the stack with verboseErrors-induced alloca()
+            interCopyEntryValue();                                                                 //                                                L2: ... shape t key val
+        }
+        lua_rawset(L2, -3);                                                                        //                                                L2: ... shape t
+        lua_pop(L1, 1);                                                                            // L1: ... t ... key
+    }                                                                                              // L1: ... t ...
+    STACK_CHECK(L1, 0);
+
+    // a cached shape with more keys than the table is replaced by the prefix that matched
+    if (_reuse && static_cast<int>(lua_rawlen(L2, shape_i_)) != _n) {
+        _startNewShape(_n);                                                                        //                                                L2: ... newshape t
+        _dirty = true;
+    }
+    if (_dirty && _cacheable && _firstKey != nullptr) {
+        kShapeCacheRegKey.getSubTableMode(L2, "v");                                                //                                                L2: ... shape t {shapes}
+        // keep the cache bounded, even in keeper states where the GC doesn't run often enough to clear the weak entries
+        lua_rawgeti(L2, -1, 0);                                                                    //                                                L2: ... shape t {shapes} count|nil
+        lua_Integer const _count{ lua_tointeger(L2, -1) + 1 };
+        lua_pop(L2, 1);                                                                            //                                                L2: ... shape t {shapes}
+        if (_count > kMaxShapes) {
+            lua_pop(L2, 1);                                                                        //                                                L2: ... shape t
+            kShapeCacheRegKey.setValue(L2, [](lua_State* L_) { lua_pushnil(L_); });
+            kShapeCacheRegKey.getSubTableMode(L2, "v");                                            //                                                L2: ... shape t {}
+        }
+        lua_pushinteger(L2, (_count > kMaxShapes) ? 1 : _count);                                   //                                                L2: ... shape t {shapes} count
+        lua_rawseti(L2, -2, 0);                                                                    //                                                L2: ... shape t {shapes}
+        lua_pushlightuserdata(L2, const_cast<void*>(_firstKey));                                   //                                                L2: ... shape t {shapes} p
+        lua_pushvalue(L2, shape_i_);                                                               //                                                L2: ... shape t {shapes} p shape
+        lua_rawset(L2, -3);                                                                        //                                                L2: ... shape t {shapes}
+        lua_pop(L2, 1);                                                                            //                                                L2: ... shape t
+    }
+    STACK_CHECK(L2, 0);
+}
+// #################################################################################################
+
 // Check if we've already copied the same table from 'L1', and reuse the old copy. This allows table upvalues shared by multiple
 // local functions to point to the same table, also in the target.
 // Always pushes a table to 'L2'.
 // Returns true if the table was cached (no need to fill it!); false if it's a virgin.
+// A virgin table is created with room for the narr_ entries of the source array part and the nrec_ other entries.
+// If nrec_ is negative, the source has no array part: its entries are counted on the way, and nrec_ receives their number.
 [[nodiscard]]
-bool InterCopyContext::pushCachedTable() const
+bool InterCopyContext::pushCachedTable(int const narr_, int& nrec_) const
 {
     void const* const _p{ lua_topointer(L1, L1_i) };
 
@@ -712,9 +975,20 @@ bool InterCopyContext::pushCachedTable() const
 
     bool const _not_found_in_cache{ luaW_rawget(L2, L2_cache_i) == LuaType::NIL };                 // L1: ... t ...                                  L2: ... {cached|nil}
     if (_not_found_in_cache) {
+        // count the entries, so that the copy doesn't rehash as it grows
+        if (nrec_ < 0) {
+            LUA_ASSERT(L1, narr_ == 0);
+            STACK_GROW(L1, 2);
+            nrec_ = 0;
+            lua_pushnil(L1);                                                                       // L1: ... t ... nil
+            while (lua_next(L1, L1_i)) {                                                           // L1: ... t ... key val
+                ++nrec_;
+                lua_pop(L1, 1);                                                                    // L1: ... t ... key
+            }                                                                                      // L1: ... t ...
+        }
         // create a new entry in the cache
         lua_pop(L2, 1);                                                                            // L1: ... t ...                                  L2: ...
-        lua_newtable(L2);                                                                          // L1: ... t ...                                  L2: ... {}
+        lua_createtable(L2, narr_, nrec_);                                                         // L1: ... t ...                                  L2: ... {}
         lua_pushlightuserdata(L2, const_cast<void*>(_p));                                          // L1: ... t ...                                  L2: ... {} p
         lua_pushvalue(L2, -2);                                                                     // L1: ... t ...                                  L2: ... {} p {}
         lua_rawset(L2, L2_cache_i);                                                                // L1: ... t ...                                  L2: ... {}
@@ -748,11 +1022,17 @@ bool InterCopyContext::lookupUserdata() const
 
     case LookupMode::LaneBody:
     case LookupMode::FromKeeper:
-        kLookupRegKey.pushValue(L2);                                                               // L1: ... f ...                                  L2: {}
+        tools::PushLookupDatabase(U, L2);                                                          // L1: ... f ...                                  L2: {}
         STACK_CHECK(L2, 1);
         LUA_ASSERT(L1, lua_istable(L2, -1));
         luaW_pushstring(L2, _fqn);                                                                 // L1: ... f ...                                  L2: {} "f.q.n"
-        LuaType const _type{ luaW_rawget(L2, StackIndex{ -2 }) };                                  // L1: ... f ...                                  L2: {} f
+        LuaType _type{ luaW_rawget(L2, StackIndex{ -2 }) };                                        // L1: ... f ...                                  L2: {} f
+        // the name can come from a module that was bound from the universe lookup index without being walked in this state
+        if (_type == LuaType::NIL && tools::CompleteLookupDatabase(U, L2)) {
+            lua_pop(L2, 1);                                                                        // L1: ... f ...                                  L2: {}
+            luaW_pushstring(L2, _fqn);                                                             // L1: ... f ...                                  L2: {} "f.q.n"
+            _type = luaW_rawget(L2, StackIndex{ -2 });                                             // L1: ... f ...                                  L2: {} f
+        }
         // nil means we don't know how to transfer stuff: user should do something
         // anything other than function or table should not happen!
         if (_type != LuaType::FUNCTION && _type != LuaType::TABLE) {
@@ -1134,20 +1414,58 @@ InterCopyOneResult InterCopyContext::interCopyTable() const
      * Note: Even metatables need to go through this test; to detect
      *       loops such as those in required module tables (getmetatable(lanes).lanes == lanes)
      */
-    if (pushCachedTable()) {                                                                       //                                                L2: ... t
+    // the border found by the length operator bounds the part that can be copied with an index loop
+    int const _narr{ static_cast<int>(lua_rawlen(L1, L1_i)) };
+    // a table without array part may be a record whose shape is known: it gives the size of the table and its destination keys
+    // otherwise, its entries are counted. the entries of a table with an array part are not: this would walk the array part once more
+    StackIndex const _shape_i{ (_narr == 0) ? lua_gettop(L2) + 1 : 0 };
+    int _nrec{ (_narr == 0) ? pushCachedShape() : 0 };                                             //                                                L2: ... shape?
+    if (pushCachedTable(_narr, _nrec)) {                                                           //                                                L2: ... shape? t
+        if (_shape_i != 0) {
+            lua_remove(L2, _shape_i);                                                              //                                                L2: ... t
+        }
         LUA_ASSERT(L1, lua_istable(L2, -1)); // from cache
         return InterCopyOneResult::Copied;
     }
     LUA_ASSERT(L1, lua_istable(L2, -1));
 
+    if (_shape_i != 0) {
+        if (_nrec > 0) {
+            interCopyRecord(_shape_i, _nrec);
+        }
+        lua_remove(L2, _shape_i);                                                                  //                                                L2: ... t
+    }
+
     STACK_GROW(L1, 2);
     STACK_GROW(L2, 2);
 
-    lua_pushnil(L1); // start iteration
-    while (lua_next(L1, L1_i)) {
-        // need a function to prevent overflowing the stack with verboseErrors-induced alloca()
-        interCopyKeyValuePair();
-        lua_pop(L1, 1); // pop value (next round)
+    // array part: scalars are pushed directly, the rest goes through interCopyOne()
+    for (int const _i : std::ranges::iota_view{ 1, _narr + 1 }) {
+        lua_rawgeti(L1, L1_i, _i);                                                                 // L1: ... t ... v
+        // holes below the border are skipped
+        if (!lua_isnil(L1, -1)) {
+            if (PushScalarValue(L1, L2)) {                                                         //                                                L2: ... t v
+                lua_rawseti(L2, -2, _i);                                                           //                                                L2: ... t
+            } else {
+                // need a function to prevent overflowing the stack with verboseErrors-induced alloca()
+                interCopyArrayItem(_i);                                                            //                                                L2: ... t
+            }
+        }
+        lua_pop(L1, 1);                                                                            // L1: ... t ...
+    }
+    STACK_CHECK(L1, 0);
+    STACK_CHECK(L2, 1);
+
+    // hash part, skipping the entries that the array loop already copied
+    if (_narr > 0) {
+        lua_pushnil(L1); // start iteration
+        while (lua_next(L1, L1_i)) {
+            if (!IsArrayPartKey(L1, StackIndex{ -2 }, _narr)) {
+                // need a function to prevent overflowing the stack with verboseErrors-induced alloca()
+                interCopyKeyValuePair();
+            }
+            lua_pop(L1, 1); // pop value (next round)
+        }
     }
     STACK_CHECK(L1, 0);
     STACK_CHECK(L2, 1);
@@ -1397,6 +1715,74 @@ InterCopyResult InterCopyContext::interCopyPackage() const
 
 // #################################################################################################
 
+// types that interCopyOne() pushes as-is, without a cache, a lookup or a conversion
+[[nodiscard, maybe_unused]]
+static bool IsScalarType(LuaType const type_)
+{
+    switch (type_) {
+    case LuaType::NIL:
+    case LuaType::BOOLEAN:
+    case LuaType::LIGHTUSERDATA:
+    case LuaType::NUMBER:
+    case LuaType::STRING:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// #################################################################################################
+
+// pushes the n_ values starting at first_, that IsScalarType() accepted, with the same result as interCopyOne() in VT::NORMAL
+void InterCopyContext::interCopyScalars(StackIndex const first_, int const n_) const
+{
+    for (StackIndex const _i : std::ranges::iota_view{ first_, StackIndex{ first_ + n_ } }) {
+        switch (luaW_type(L1, _i)) {
+        case LuaType::NIL:
+            // when copying a nil in a keeper, write a nil sentinel in the destination
+            if (mode == LookupMode::ToKeeper) {
+                kNilSentinel.pushKey(L2);
+            } else {
+                lua_pushnil(L2);
+            }
+            break;
+
+        case LuaType::BOOLEAN:
+            lua_pushboolean(L2, lua_toboolean(L1, _i));
+            break;
+
+        case LuaType::LIGHTUSERDATA:
+            // when copying a nil sentinel in a non-keeper, write a nil in the destination
+            if (mode != LookupMode::ToKeeper && kNilSentinel.equals(L1, _i)) {
+                lua_pushnil(L2);
+            } else {
+                lua_pushlightuserdata(L2, lua_touserdata(L1, _i));
+            }
+            break;
+
+        case LuaType::NUMBER:
+#if defined LUA_LNUM || LUA_VERSION_NUM >= 503
+            if (lua_isinteger(L1, _i)) {
+                lua_pushinteger(L2, lua_tointeger(L1, _i));
+                break;
+            }
+#endif // defined LUA_LNUM || LUA_VERSION_NUM >= 503
+            lua_pushnumber(L2, lua_tonumber(L1, _i));
+            break;
+
+        case LuaType::STRING:
+            luaW_pushstring(L2, luaW_tostring(L1, _i));
+            break;
+
+        default:
+            LUA_ASSERT(L1, !"unexpected type");
+        }
+    }
+}
+
+// #################################################################################################
+
 // Akin to 'lua_xmove' but copies values between _any_ Lua states.
 // NOTE: Both the states must be solely in the current OS thread's possession.
 [[nodiscard]]
@@ -1418,6 +1804,19 @@ InterCopyResult InterCopyContext::interCopy(int const n_) const
     STACK_CHECK_START_REL(L2, 0);
     STACK_GROW(L2, n_ + 1);
 
+    // if L1_i is specified, start here, else take the _n items off the top of the stack
+    StackIndex const _first{ (L1_i != 0) ? L1_i.value() : (_top_L1 - n_ + 1) };
+
+#if USE_SCALAR_COPY_PATH()
+    // most linda operations only carry slots, numbers, short strings and the lightuserdata of packed values:
+    // these don't need a cache table nor the per-value dispatch of interCopyOne()
+    if (std::ranges::all_of(std::ranges::iota_view{ _first, StackIndex{ _first + n_ } }, [L1 = L1.value()](StackIndex const i_) { return IsScalarType(luaW_type(L1, i_)); })) {
+        interCopyScalars(_first, n_);                                                              //                                                L2: ... v...
+        STACK_CHECK(L2, n_);
+        return InterCopyResult::Success;
+    }
+#endif // USE_SCALAR_COPY_PATH()
+
     /*
      * Make a cache table for the duration of this copy. Collects tables and
      * function entries, avoiding the same entries to be passed on as multiple
@@ -1429,8 +1828,7 @@ InterCopyResult InterCopyContext::interCopy(int const n_) const
     InterCopyContext _c{ U, L2, L1, CacheIndex{ _top_L2 + 1 }, {}, VT::NORMAL, mode, "?" };
     InterCopyResult _copyok{ InterCopyResult::Success };
     STACK_CHECK_START_REL(L1, 0);
-    // if L1_i is specified, start here, else take the _n items off the top of the stack
-    for (StackIndex _i{ (L1_i != 0) ? L1_i.value() : (_top_L1 - n_ + 1) }, _j{ 1 }; _j <= n_; ++_i, ++_j) {
+    for (StackIndex _i{ _first }, _j{ 1 }; _j <= n_; ++_i, ++_j) {
         char _tmpBuf[16];
         if (U->verboseErrors) {
             *std::format_to(_tmpBuf, "arg#{}", _j.value()) = 0;
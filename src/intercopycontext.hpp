@@ -70,11 +70,16 @@ class InterCopyContext final
     bool lookupTable() const;
 
     // for use in inter_copy_table
+    void interCopyArrayItem(int i_) const;
+    void interCopyEntryValue() const;
     void interCopyKeyValuePair() const;
+    void interCopyRecord(StackIndex shape_i_, int nrec_) const;
     [[nodiscard]]
     bool pushCachedMetatable() const;
     [[nodiscard]]
-    bool pushCachedTable() const;
+    int pushCachedShape() const;
+    [[nodiscard]]
+    bool pushCachedTable(int narr_, int& nrec_) const;
 
     // for use in inter_copy_userdata
     [[nodiscard]]
@@ -92,6 +97,7 @@ class InterCopyContext final
     [[nodiscard]]
     bool interCopyNil() const;
     void interCopyNumber() const;
+    void interCopyScalars(StackIndex first_, int n_) const;
     void interCopyString() const;
     [[nodiscard]]
     InterCopyOneResult interCopyTable() const;
@@ -47,7 +47,350 @@
 // This table contains entries of the form [Linda*] = {KeysDB...}
 // Each KeysDB contains entries of the form [key] = KeyUD
 // where key is a key used in the Lua Linda API to exchange data, and KeyUD is a full userdata with a table uservalue
-// the table uservalue is the actual fifo, where elements are added and removed.
+// the table uservalue is a ring buffer stored in the array part of a preallocated table, where elements are added and removed.
+// the ring buffer only grows (by doubling its capacity), so that send/receive never cause a table rehash.
+// values sent with linda:send() that can be serialized don't enter the keeper state: the ring buffer holds a kPackedValue sentinel for each of them,
+// and the KeyUD chains their PackedValue in native memory, in the same order.
+
+// #################################################################################################
+// #################################################################################################
+// ######################################### PackedValue ###########################################
+// #################################################################################################
+// #################################################################################################
+
+namespace {
+
+// xxh64 of string "kPackedValue" generated at https://www.pelock.com/products/hash-calculator
+// stored in a keeper slot in place of a value that was packed, and marks the packed values chain in keepercall_XXX results
+static constexpr UniqueKey kPackedValue{ 0xA2CD186734605326ull };
+
+enum class [[nodiscard]] PackedTag : uint8_t
+{
+    Nil,
+    False,
+    True,
+    Integer,
+    Number,
+    String,
+    LightUserData,
+    Table
+};
+
+// #################################################################################################
+
+template <typename T>
+static void Write(std::byte*& cursor_, T const& value_)
+{
+    std::memcpy(cursor_, &value_, sizeof(T));
+    cursor_ += sizeof(T);
+}
+
+// #################################################################################################
+
+template <typename T>
+[[nodiscard]]
+static T Read(std::byte const*& cursor_)
+{
+    T _value;
+    std::memcpy(&_value, cursor_, sizeof(T));
+    cursor_ += sizeof(T);
+    return _value;
+}
+
+// #################################################################################################
+
+// number of bytes needed to serialize the value at the specified index, nothing if it can't be packed
+[[nodiscard]]
+static std::optional<size_t> PackedSize(lua_State* const L_, StackIndex const idx_, bool const inTable_)
+{
+    switch (luaW_type(L_, idx_)) {
+    case LuaType::NIL:
+    case LuaType::BOOLEAN:
+        return sizeof(PackedTag);
+
+    case LuaType::LIGHTUSERDATA:
+        return sizeof(PackedTag) + sizeof(void*);
+
+    case LuaType::NUMBER:
+#if defined LUA_LNUM || LUA_VERSION_NUM >= 503
+        if (lua_isinteger(L_, idx_)) {
+            return sizeof(PackedTag) + sizeof(lua_Integer);
+        }
+#endif // defined LUA_LNUM || LUA_VERSION_NUM >= 503
+        return sizeof(PackedTag) + sizeof(lua_Number);
+
+    case LuaType::STRING:
+        return sizeof(PackedTag) + sizeof(size_t) + luaW_tostring(L_, idx_).size();
+
+    case LuaType::TABLE:
+        {
+            // only flat tables without a metatable, the keeper takes care of everything else
+            if (inTable_ || lua_getmetatable(L_, idx_)) {
+                if (!inTable_) {
+                    lua_pop(L_, 1);
+                }
+                return std::nullopt;
+            }
+            STACK_GROW(L_, 2);
+            STACK_CHECK_START_REL(L_, 0);
+            StackIndex const _idx{ luaW_absindex(L_, idx_) };
+            size_t _size{ sizeof(PackedTag) + 2 * sizeof(int) };
+            lua_pushnil(L_);                                                                       // L_: ... nil
+            while (lua_next(L_, _idx)) {                                                           // L_: ... key val
+                std::optional<size_t> const _keySize{ PackedSize(L_, StackIndex{ -2 }, true) };
+                std::optional<size_t> const _valSize{ PackedSize(L_, StackIndex{ -1 }, true) };
+                lua_pop(L_, 1);                                                                    // L_: ... key
+                if (!_keySize.has_value() || !_valSize.has_value()) {
+                    lua_pop(L_, 1);                                                                // L_: ...
+                    STACK_CHECK(L_, 0);
+                    return std::nullopt;
+                }
+                _size += _keySize.value() + _valSize.value();
+            }                                                                                      // L_: ...
+            STACK_CHECK(L_, 0);
+            return _size;
+        }
+
+    default:
+        return std::nullopt;
+    }
+}
+
+// #################################################################################################
+
+// serializes the value at the specified index, which PackedSize() accepted
+static void PackOne(lua_State* const L_, StackIndex const idx_, std::byte*& cursor_)
+{
+    switch (luaW_type(L_, idx_)) {
+    case LuaType::NIL:
+        Write(cursor_, PackedTag::Nil);
+        break;
+
+    case LuaType::BOOLEAN:
+        Write(cursor_, lua_toboolean(L_, idx_) ? PackedTag::True : PackedTag::False);
+        break;
+
+    case LuaType::LIGHTUSERDATA:
+        Write(cursor_, PackedTag::LightUserData);
+        Write(cursor_, lua_touserdata(L_, idx_));
+        break;
+
+    case LuaType::NUMBER:
+#if defined LUA_LNUM || LUA_VERSION_NUM >= 503
+        if (lua_isinteger(L_, idx_)) {
+            Write(cursor_, PackedTag::Integer);
+            Write(cursor_, lua_tointeger(L_, idx_));
+            break;
+        }
+#endif // defined LUA_LNUM || LUA_VERSION_NUM >= 503
+        Write(cursor_, PackedTag::Number);
+        Write(cursor_, lua_tonumber(L_, idx_));
+        break;
+
+    case LuaType::STRING:
+        {
+            std::string_view const _s{ luaW_tostring(L_, idx_) };
+            Write(cursor_, PackedTag::String);
+            Write(cursor_, _s.size());
+            std::memcpy(cursor_, _s.data(), _s.size());
+            cursor_ += _s.size();
+        }
+        break;
+
+    case LuaType::TABLE:
+        {
+            STACK_GROW(L_, 2);
+            STACK_CHECK_START_REL(L_, 0);
+            StackIndex const _idx{ luaW_absindex(L_, idx_) };
+            Write(cursor_, PackedTag::Table);
+            // the sizes are only hints for lua_createtable() when the table is unpacked
+            std::byte* _sizes{ cursor_ };
+            cursor_ += 2 * sizeof(int);
+            int _narr{ 0 };
+            int _nrec{ 0 };
+            lua_pushnil(L_);                                                                       // L_: ... nil
+            while (lua_next(L_, _idx)) {                                                           // L_: ... key val
+                ++((luaW_type(L_, StackIndex{ -2 }) == LuaType::NUMBER) ? _narr : _nrec);
+                PackOne(L_, StackIndex{ -2 }, cursor_);
+                PackOne(L_, StackIndex{ -1 }, cursor_);
+                lua_pop(L_, 1);                                                                    // L_: ... key
+            }                                                                                      // L_: ...
+            Write(_sizes, _narr);
+            Write(_sizes, _nrec);
+            STACK_CHECK(L_, 0);
+        }
+        break;
+
+    default:
+        LUA_ASSERT(L_, !"unexpected type");
+    }
+}
+
+// #################################################################################################
+
+// pushes the value serialized at the cursor
+// nils and nil sentinels are converted as they would be by an InterCopyContext with the same lookup mode
+static void UnpackOne(lua_State* const L_, std::byte const*& cursor_, LookupMode const mode_)
+{
+    STACK_GROW(L_, 3);
+    switch (Read<PackedTag>(cursor_)) {
+    case PackedTag::Nil:
+        if (mode_ == LookupMode::ToKeeper) {
+            kNilSentinel.pushKey(L_);
+        } else {
+            lua_pushnil(L_);
+        }
+        break;
+
+    case PackedTag::False:
+        lua_pushboolean(L_, 0);
+        break;
+
+    case PackedTag::True:
+        lua_pushboolean(L_, 1);
+        break;
+
+    case PackedTag::Integer:
+        lua_pushinteger(L_, Read<lua_Integer>(cursor_));
+        break;
+
+    case PackedTag::Number:
+        lua_pushnumber(L_, Read<lua_Number>(cursor_));
+        break;
+
+    case PackedTag::String:
+        {
+            size_t const _len{ Read<size_t>(cursor_) };
+            luaW_pushstring(L_, std::string_view{ reinterpret_cast<char const*>(cursor_), _len });
+            cursor_ += _len;
+        }
+        break;
+
+    case PackedTag::LightUserData:
+        lua_pushlightuserdata(L_, Read<void*>(cursor_));
+        if (mode_ != LookupMode::ToKeeper && kNilSentinel.equals(L_, kIdxTop)) {
+            lua_pop(L_, 1);
+            lua_pushnil(L_);
+        }
+        break;
+
+    case PackedTag::Table:
+        {
+            STACK_CHECK_START_REL(L_, 0);
+            int const _narr{ Read<int>(cursor_) };
+            int const _nrec{ Read<int>(cursor_) };
+            lua_createtable(L_, _narr, _nrec);                                                     // L_: ... {}
+            for ([[maybe_unused]] int const _i : std::ranges::iota_view{ 0, _narr + _nrec }) {
+                UnpackOne(L_, cursor_, mode_);                                                     // L_: ... {} key
+                UnpackOne(L_, cursor_, mode_);                                                     // L_: ... {} key val
+                lua_rawset(L_, -3);                                                                // L_: ... {}
+            }
+            STACK_CHECK(L_, 1);
+        }
+        break;
+    }
+}
+
+// #################################################################################################
+
+// replaces the kPackedValue sentinels found among the count_ values at the top of the stack by the values of the chain, in order
+static void UnpackResults(lua_State* const L_, int const count_, PackedValue const* packed_)
+{
+    StackIndex const _top{ lua_gettop(L_) };
+    for (StackIndex const _i : std::ranges::iota_view{ StackIndex{ _top - count_ + 1 }, StackIndex{ _top + 1 } }) {
+        if (kPackedValue.equals(L_, _i)) {
+            LUA_ASSERT(L_, packed_ != nullptr);
+            packed_->push(L_, LookupMode::FromKeeper);
+            lua_replace(L_, _i);
+            packed_ = packed_->next;
+        }
+    }
+}
+
+} // namespace
+
+// #################################################################################################
+
+[[nodiscard]]
+int PackedValue::CountAll(PackedValue const* first_)
+{
+    int _count{ 0 };
+    for (; first_ != nullptr; first_ = first_->next) {
+        ++_count;
+    }
+    return _count;
+}
+
+// #################################################################################################
+
+void PackedValue::FreeAll(Universe* const U_, PackedValue* first_)
+{
+    while (first_ != nullptr) {
+        PackedValue* const _next{ first_->next };
+        size_t const _size{ sizeof(PackedValue) + first_->size };
+        first_->~PackedValue();
+        U_->internalAllocator.free(first_, _size);
+        first_ = _next;
+    }
+}
+
+// #################################################################################################
+
+// serializes count_ values starting at first_ in a chain of PackedValue
+// returns nullptr if any of them can't be packed, in which case they must go through the keeper state
+[[nodiscard]]
+PackedValue* PackedValue::PackAll(Universe* const U_, lua_State* const L_, StackIndex const first_, int const count_)
+{
+    // each packed table is unpacked as a new one: only the keeper copy delivers a table given several times as a single table
+    for (int const _i : std::ranges::iota_view{ 1, count_ }) {
+        if (lua_istable(L_, first_ + _i)) {
+            for (int const _j : std::ranges::iota_view{ 0, _i }) {
+                if (lua_rawequal(L_, first_ + _j, first_ + _i)) {
+                    return nullptr;
+                }
+            }
+        }
+    }
+    PackedValue* _first{ nullptr };
+    PackedValue** _last{ &_first };
+    for (int const _i : std::ranges::iota_view{ 0, count_ }) {
+        StackIndex const _idx{ first_ + _i };
+        std::optional<size_t> const _size{ PackedSize(L_, _idx, false) };
+        void* const _mem{ _size.has_value() ? U_->internalAllocator.alloc(sizeof(PackedValue) + _size.value()) : nullptr };
+        if (_mem == nullptr) {
+            FreeAll(U_, _first);
+            return nullptr;
+        }
+        PackedValue* const _packed{ new (_mem) PackedValue{ _size.value() } };
+        std::byte* _cursor{ _packed->bytes() };
+        PackOne(L_, _idx, _cursor);
+        LUA_ASSERT(L_, _cursor == _packed->bytes() + _packed->size);
+        *_last = _packed;
+        _last = &_packed->next;
+    }
+    return _first;
+}
+
+// #################################################################################################
+
+void PackedValue::push(lua_State* const L_, LookupMode const mode_) const
+{
+    std::byte const* _cursor{ bytes() };
+    UnpackOne(L_, _cursor, mode_);
+}
+
+// #################################################################################################
+
+size_t PackedValue::SizeAll(PackedValue const* first_)
+{
+    size_t _size{ 0 };
+    for (; first_ != nullptr; first_ = first_->next) {
+        _size += first_->size;
+    }
+    return _size;
+}
+
+// #################################################################################################
 
 namespace {
 
@@ -62,24 +405,46 @@ class KeyUD final
 {
     private:
     static constexpr UserValueIndex kContentsTableIndex{ 1 };
+    // xxh64 of string "kKeyUDMetatableRegKey" generated at https://www.pelock.com/products/hash-calculator
+    static constexpr RegistryUniqueKey kKeyUDMetatableRegKey{ 0xA36D1A13F4C300CCull };
+    // smallest ring buffer we allocate when the first value is pushed in an unlimited KeyUD
+    static constexpr int kMinCapacity{ 8 };
 
     public:
     static constexpr std::string_view kUnder{ "under" };
     static constexpr std::string_view kExact{ "exact" };
     static constexpr std::string_view kOver{ "over" };
 
-    int first{ 1 };
+    int first{ 1 }; // logical index of the oldest value, as reported by linda:dump()
     int count{ 0 };
     LindaLimit limit{ -1 };
     LindaRestrict restrict { LindaRestrict::None };
+    // traffic counters, as reported by linda:stats()
+    uint64_t sends{};
+    uint64_t receives{};
+    uint64_t bytes{}; // of the values serialized in native memory
+    int maxCount{ 0 };
+    // the handles created by linda:slot() on this key: while there are some, the KeyUD must stay in the KeysDB
+    int pins{ 0 };
+
+    private:
+    int head{ 0 }; // ring buffer slot of the oldest value, in [0, capacity[
+    int capacity{ 0 }; // number of slots preallocated in the array part of the ring buffer table
+    PackedValue* packedFirst{ nullptr }; // the values of the kPackedValue sentinels of the fifo, oldest first
+    PackedValue* packedLast{ nullptr };
+
+    [[nodiscard]]
+    static int Collect(lua_State* L_);
 
-    // a fifo full userdata has one uservalue, the table that holds the actual fifo contents
+    public:
+    // a fifo full userdata has one uservalue, the table that holds the ring buffer slots
     [[nodiscard]]
     static void* operator new([[maybe_unused]] size_t size_, KeeperState L_) noexcept { return luaW_newuserdatauv<KeyUD>(L_, UserValueCount{ 1 }); }
     // always embedded somewhere else or "in-place constructed" as a full userdata
     // can't actually delete the operator because the compiler generates stack unwinding code that could call it in case of exception
     static void operator delete([[maybe_unused]] void* p_, [[maybe_unused]] KeeperState L_) { LUA_ASSERT(L_, !"should never be called"); }
 
+    void appendPacked(PackedValue* first_); // keepercall_send_packed
     [[nodiscard]]
     bool changeLimit(LindaLimit limit_);
     [[nodiscard]]
@@ -88,20 +453,40 @@ class KeyUD final
     static KeyUD* Create(KeeperState K_);
     [[nodiscard]]
     static KeyUD* GetPtr(KeeperState K_, StackIndex idx_);
+    void grow(KeeperState K_, StackIndex idx_, int minCapacity_);
     void peek(KeeperState K_, int count_) const; // keepercall_get
     [[nodiscard]]
     int pop(KeeperState K_, int minCount_, int maxCount_); // keepercall_receive[_batched]
     void prepareAccess(KeeperState K_, StackIndex idx_) const;
+    void prepareDump(KeeperState K_, StackIndex idx_) const; // Keeper::PushLindaStorage
     [[nodiscard]]
     bool push(KeeperState K_, int count_, bool enforceLimit_); // keepercall_send and keepercall_set
     void pushFillStatus(KeeperState K_) const;
+    void pushOldest(KeeperState K_) const; // keepercall_cas, keepercall_incr and keepercall_swap
     static void PushFillStatus(KeeperState K_, KeyUD const* key_);
+    void pushPackedChain(KeeperState K_, StackIndex first_, bool detach_); // keepercall_get and keepercall_receive[_batched]
+    void releasePacked(KeeperState K_);
     [[nodiscard]]
     bool reset(KeeperState K_);
+    // 1-based index in the ring buffer table of the i-th value (0-based) of the fifo
+    [[nodiscard]]
+    int slotIndex(int const i_) const { return ((head + i_) % capacity) + 1; }
 };
 
 // #################################################################################################
 
+// the KeyUD takes ownership of the chain, which holds the values of the kPackedValue sentinels that were just pushed in the fifo
+void KeyUD::appendPacked(PackedValue* const first_)
+{
+    (packedLast ? packedLast->next : packedFirst) = first_;
+    for (PackedValue* _packed{ first_ }; _packed != nullptr; _packed = _packed->next) {
+        packedLast = _packed;
+    }
+    bytes += PackedValue::SizeAll(first_);
+}
+
+// #################################################################################################
+
 [[nodiscard]]
 bool KeyUD::changeLimit(LindaLimit const limit_)
 {
@@ -124,6 +509,17 @@ LindaRestrict KeyUD::changeRestrict(LindaRestrict const restrict_)
 
 // #################################################################################################
 
+// __gc of the KeyUD
+[[nodiscard]]
+int KeyUD::Collect(lua_State* const L_)
+{
+    KeyUD* const _key{ KeyUD::GetPtr(KeeperState{ L_ }, StackIndex{ 1 }) };
+    _key->releasePacked(KeeperState{ L_ });
+    return 0;
+}
+
+// #################################################################################################
+
 // in: nothing
 // out: { first = 1, count = 0, limit = -1}
 [[nodiscard]]
@@ -136,11 +532,20 @@ KeyUD* KeyUD::Create(KeeperState const K_)
     lua_newtable(K_);
     lua_setiuservalue(K_, StackIndex{ -2 }, kContentsTableIndex);
     STACK_CHECK(K_, 1);
+    // the metatable frees the packed values still in the fifo when the KeyUD is collected
+    if (!kKeyUDMetatableRegKey.getSubTable(K_, NArr{ 0 }, NRec{ 1 })) {                            // K_: KeyUD mt
+        lua_pushcfunction(K_, Collect);                                                            // K_: KeyUD mt Collect
+        lua_setfield(K_, -2, "__gc");                                                              // K_: KeyUD mt
+    }
+    lua_setmetatable(K_, -2);                                                                      // K_: KeyUD
+    STACK_CHECK(K_, 1);
     return _key;
 }
 
 // #################################################################################################
 
+// #################################################################################################
+
 [[nodiscard]]
 KeyUD* KeyUD::GetPtr(KeeperState const K_, StackIndex const idx_)
 {
@@ -149,6 +554,33 @@ KeyUD* KeyUD::GetPtr(KeeperState const K_, StackIndex const idx_)
 
 // #################################################################################################
 
+// expects 'this' at the specified index
+// replaces the ring buffer with a larger one able to hold at least minCapacity_ values, oldest value moved at slot 1
+void KeyUD::grow(KeeperState const K_, StackIndex const idx_, int const minCapacity_)
+{
+    StackIndex const _idx{ luaW_absindex(K_, idx_) };
+    LUA_ASSERT(K_, KeyUD::GetPtr(K_, _idx) == this);
+    int _newCapacity{ std::max(capacity, kMinCapacity) };
+    while (_newCapacity < minCapacity_) {
+        _newCapacity *= 2;
+    }
+    STACK_GROW(K_, 3);
+    STACK_CHECK_START_REL(K_, 0);
+    lua_getiuservalue(K_, _idx, kContentsTableIndex);                                              // K_: ... ring
+    lua_createtable(K_, _newCapacity, 0);                                                          // K_: ... ring newring
+    for (int const _i : std::ranges::iota_view{ 0, count }) {
+        lua_rawgeti(K_, -2, slotIndex(_i));                                                        // K_: ... ring newring val
+        lua_rawseti(K_, -2, _i + 1);                                                               // K_: ... ring newring
+    }
+    lua_setiuservalue(K_, _idx, kContentsTableIndex);                                              // K_: ... ring
+    lua_pop(K_, 1);                                                                                // K_: ...
+    STACK_CHECK(K_, 0);
+    head = 0;
+    capacity = _newCapacity;
+}
+
+// #################################################################################################
+
 // in: fifo
 // out: bool ...
 // pops the fifo, push bool + as much data as is available (up to the specified count) without consuming it
@@ -171,9 +603,9 @@ void KeyUD::peek(KeeperState const K_, int const count_) const
     STACK_CHECK(K_, 2);
     STACK_GROW(K_, _count);
     for (int const _i : std::ranges::iota_view{ 1, _count }) { // push val2 to valN
-        lua_rawgeti(K_, 2, first + _i);                                                            // K_: _count fifo val2..N
+        lua_rawgeti(K_, 2, slotIndex(_i));                                                         // K_: _count fifo val2..N
     }
-    lua_rawgeti(K_, 2, first); // push val1                                                        // K_: _count fifo val2..N val1
+    lua_rawgeti(K_, 2, slotIndex(0)); // push val1                                                 // K_: _count fifo val2..N val1
     lua_replace(K_, 2); // replace fifo by val1 to get the output properly ordered                 // K_: _count val1..N
     STACK_CHECK(K_, 1 + _count);
 }
@@ -200,10 +632,10 @@ int KeyUD::pop(KeeperState const K_, int const minCount_, int const maxCount_)
     STACK_GROW(K_, _popCount + 2);
 
     // remove an element from fifo sequence and push it on the stack
-    auto _extractFifoItem = [K = K_, first = first, fifo_idx = lua_gettop(K_)](int const _i)
+    auto _extractFifoItem = [this, K = K_, fifo_idx = lua_gettop(K_)](int const _i)
     {
         STACK_CHECK_START_REL(K, 0);
-        int const _at{ first + _i };
+        int const _at{ slotIndex(_i) };
         // push item on the stack
         lua_rawgeti(K, fifo_idx, _at);                                                             // K_: ... fifo val
         // remove item from the fifo
@@ -221,10 +653,12 @@ int KeyUD::pop(KeeperState const K_, int const minCount_, int const maxCount_)
     STACK_CHECK(K_, _popCount);
     lua_replace(K_, _fifo_idx);                                                                    // K_: ... val0...valN
 
-    // avoid ever-growing indexes by resetting each time we detect the fifo is empty
+    // restart at the beginning of the ring buffer each time we detect the fifo is empty
     int const _new_count{ count - _popCount };
     first = (_new_count == 0) ? 1 : (first + _popCount);
+    head = (_new_count == 0) ? 0 : ((head + _popCount) % capacity);
     count = _new_count;
+    receives += static_cast<uint64_t>(_popCount);
     return _popCount;
 }
 
@@ -243,6 +677,31 @@ void KeyUD::prepareAccess(KeeperState const K_, StackIndex const idx_) const
 
 // #################################################################################################
 
+// expects 'this' at the specified index
+// replaces it by a table holding the fifo values at indices [first, first + count[, the way linda:dump() has always shown them
+void KeyUD::prepareDump(KeeperState const K_, StackIndex const idx_) const
+{
+    StackIndex const _idx{ luaW_absindex(K_, idx_) };
+    STACK_GROW(K_, 2);
+    STACK_CHECK_START_REL(K_, 0);
+    prepareAccess(K_, _idx);                                                                       // K_: ... ring ...
+    lua_newtable(K_);                                                                              // K_: ... ring ... fifo
+    PackedValue const* _packed{ packedFirst };
+    for (int const _i : std::ranges::iota_view{ 0, count }) {
+        lua_rawgeti(K_, _idx, slotIndex(_i));                                                      // K_: ... ring ... fifo val
+        if (kPackedValue.equals(K_, kIdxTop)) {
+            lua_pop(K_, 1);                                                                        // K_: ... ring ... fifo
+            _packed->push(K_, LookupMode::ToKeeper);                                               // K_: ... ring ... fifo val
+            _packed = _packed->next;
+        }
+        lua_rawseti(K_, -2, first + _i);                                                           // K_: ... ring ... fifo
+    }
+    lua_replace(K_, _idx);                                                                         // K_: ... fifo ...
+    STACK_CHECK(K_, 0);
+}
+
+// #################################################################################################
+
 // in: expect this val... on top of the stack
 // out: nothing, removes all pushed values from the stack
 [[nodiscard]]
@@ -254,14 +713,18 @@ bool KeyUD::push(KeeperState const K_, int const count_, bool const enforceLimit
         return false;
     }
 
+    if (count + count_ > capacity) {
+        grow(K_, _fifoIdx, count + count_);
+    }
+
     prepareAccess(K_, _fifoIdx);                                                                   // K_: fifo val...
-    int const _start{ first + count - 1 };
     // pop all additional arguments, storing them in the fifo
-    for (int const _i : std::ranges::reverse_view{ std::ranges::iota_view{ 1, count_ + 1 } }) {
+    for (int const _i : std::ranges::reverse_view{ std::ranges::iota_view{ 0, count_ } }) {
         // store in the fifo the value at the top of the stack at the specified index, popping it from the stack
-        lua_rawseti(K_, _fifoIdx, _start + _i);
+        lua_rawseti(K_, _fifoIdx, slotIndex(count + _i));
     }
     count += count_;
+    maxCount = std::max(maxCount, count);
     // all values are, gone, only our fifo remains, we can remove it
     lua_pop(K_, 1);                                                                                // K_:
     return true;
@@ -269,6 +732,10 @@ bool KeyUD::push(KeeperState const K_, int const count_, bool const enforceLimit
 
 // #################################################################################################
 
+// #################################################################################################
+
+// #################################################################################################
+
 void KeyUD::pushFillStatus(KeeperState const K_) const
 {
     if (limit < 0) {
@@ -298,6 +765,72 @@ void KeyUD::PushFillStatus(KeeperState const K_, KeyUD const* const key_)
 
 // #################################################################################################
 
+// in: expects 'this' on top of the stack
+// out: this val
+// pushes the oldest value of the fifo, unpacked if it was serialized, or a nil sentinel if the fifo is empty
+void KeyUD::pushOldest(KeeperState const K_) const
+{
+    LUA_ASSERT(K_, KeyUD::GetPtr(K_, kIdxTop) == this);
+    STACK_GROW(K_, 2);
+    STACK_CHECK_START_REL(K_, 0);
+    if (count == 0) {
+        kNilSentinel.pushKey(K_);                                                                  // K_: this kNilSentinel
+    } else {
+        lua_getiuservalue(K_, kIdxTop, kContentsTableIndex);                                       // K_: this ring
+        lua_rawgeti(K_, -1, slotIndex(0));                                                         // K_: this ring val
+        lua_remove(K_, -2);                                                                        // K_: this val
+        if (kPackedValue.equals(K_, kIdxTop)) {
+            lua_pop(K_, 1);                                                                        // K_: this
+            packedFirst->push(K_, LookupMode::ToKeeper);                                           // K_: this val
+        }
+    }
+    STACK_CHECK(K_, 1);
+}
+
+// #################################################################################################
+
+// in: values popped or peeked from the fifo, starting at first_, up to the top of the stack
+// out: if some are kPackedValue sentinels: kPackedValue <chain: lightuserdata> <detach_: boolean> are pushed after them, for keeper_call() to unpack
+// when detach_ is true, the chain is removed from the KeyUD, and keeper_call() frees it once unpacked
+void KeyUD::pushPackedChain(KeeperState const K_, StackIndex const first_, bool const detach_)
+{
+    int _nbPacked{ 0 };
+    for (StackIndex const _i : std::ranges::iota_view{ first_, StackIndex{ lua_gettop(K_) + 1 } }) {
+        if (kPackedValue.equals(K_, _i)) {
+            ++_nbPacked;
+        }
+    }
+    if (_nbPacked == 0) {
+        return;
+    }
+    PackedValue* const _chain{ packedFirst };
+    if (detach_) {
+        PackedValue* _last{ packedFirst };
+        for ([[maybe_unused]] int const _i : std::ranges::iota_view{ 1, _nbPacked }) {
+            _last = _last->next;
+        }
+        packedFirst = std::exchange(_last->next, nullptr);
+        if (packedFirst == nullptr) {
+            packedLast = nullptr;
+        }
+    }
+    STACK_GROW(K_, 3);
+    kPackedValue.pushKey(K_);                                                                      // K_: ... kPackedValue
+    lua_pushlightuserdata(K_, _chain);                                                             // K_: ... kPackedValue chain
+    lua_pushboolean(K_, detach_ ? 1 : 0);                                                          // K_: ... kPackedValue chain bool
+}
+
+// #################################################################################################
+
+void KeyUD::releasePacked(KeeperState const K_)
+{
+    PackedValue::FreeAll(Universe::Get(K_), std::exchange(packedFirst, nullptr));
+    packedLast = nullptr;
+}
+
+// #################################################################################################
+// #################################################################################################
+
 // in: expects 'this' on top of the stack
 // out: nothing
 // returns true if the channel was full
@@ -308,16 +841,20 @@ bool KeyUD::reset(KeeperState const K_)
     STACK_CHECK_START_REL(K_, 0);
     bool const _wasFull{ (limit > 0) && (count >= limit) };
     // empty the KeyUD: replace uservalue with a virgin table, reset counters, but leave limit and restrict unchanged!
-    // if we have an actual limit, use it to preconfigure the table
-    lua_createtable(K_, (limit <= 0) ? 0 : limit.value(), 0);                                      // K_: KeysDB key val... KeyUD {}
+    // if we have an actual limit, use it to preconfigure the ring buffer
+    capacity = (limit <= 0) ? 0 : limit.value();
+    lua_createtable(K_, capacity, 0);                                                              // K_: KeysDB key val... KeyUD {}
     lua_setiuservalue(K_, StackIndex{ -2 }, kContentsTableIndex);                                  // K_: KeysDB key val... KeyUD
     first = 1;
     count = 0;
+    head = 0;
+    releasePacked(K_);
     STACK_CHECK(K_, 0);
     return _wasFull;
 }
 
 // #################################################################################################
+
 // #################################################################################################
 
 // in: linda_ud expected at stack slot idx
@@ -343,6 +880,264 @@ static void PushKeysDB(KeeperState const K_, StackIndex const idx_)
     STACK_CHECK(K_, 1);
 }
 
+// #################################################################################################
+
+// in: linda key args...
+// out: KeysDB key args... KeyUD|nil val, or kRestrictedChannel if the key is restricted to send/receive
+// val is the value that linda:get() would read (nil sentinel if there is none)
+// returns false if the key is restricted
+[[nodiscard]]
+static bool PushSetGetValue(KeeperState const K_)
+{
+    STACK_GROW(K_, 4);
+    PushKeysDB(K_, StackIndex{ 1 });                                                               // K_: linda key args... KeysDB
+    lua_replace(K_, 1);                                                                            // K_: KeysDB key args...
+    lua_pushvalue(K_, 2);                                                                          // K_: KeysDB key args... key
+    lua_rawget(K_, 1);                                                                             // K_: KeysDB key args... KeyUD|nil
+    KeyUD const* const _key{ KeyUD::GetPtr(K_, kIdxTop) };
+    if (_key == nullptr) {
+        kNilSentinel.pushKey(K_);                                                                  // K_: KeysDB key args... nil kNilSentinel
+    } else if (_key->restrict == LindaRestrict::SendReceive) { // can we use set/get?
+        lua_settop(K_, 0);                                                                         // K_:
+        kRestrictedChannel.pushKey(K_);                                                            // K_: kRestrictedChannel
+        return false;
+    } else {
+        _key->pushOldest(K_);                                                                      // K_: KeysDB key args... KeyUD val
+    }
+    return true;
+}
+
+// #################################################################################################
+
+// in: KeysDB key args... KeyUD|nil val
+// out: KeysDB key args...
+// replaces the contents of the slot by val like linda:set() does, storing a nil sentinel empties the slot instead
+// returns true if the slot was full but it is no longer the case
+[[nodiscard]]
+static bool ReplaceSetGetValue(KeeperState const K_)
+{
+    STACK_GROW(K_, 3);
+    bool const _clear{ kNilSentinel.equals(K_, kIdxTop) };
+    KeyUD* _key{ KeyUD::GetPtr(K_, StackIndex{ -2 }) };
+    if (_key == nullptr) {                                                                         // K_: KeysDB key args... nil val
+        lua_remove(K_, -2);                                                                        // K_: KeysDB key args... val
+        if (_clear) {
+            lua_pop(K_, 1);                                                                        // K_: KeysDB key args...
+            return false;
+        }
+        _key = KeyUD::Create(K_);                                                                  // K_: KeysDB key args... val KeyUD
+        lua_pushvalue(K_, 2);                                                                      // K_: KeysDB key args... val KeyUD key
+        lua_pushvalue(K_, -2);                                                                     // K_: KeysDB key args... val KeyUD key KeyUD
+        lua_rawset(K_, 1);                                                                         // K_: KeysDB key args... val KeyUD
+        lua_insert(K_, -2);                                                                        // K_: KeysDB key args... KeyUD val
+        [[maybe_unused]] bool const _pushed{ _key->push(K_, 1, false) };                           // K_: KeysDB key args...
+        // no need to wake writers, because a writer can't wait on an inexistent key
+        return false;
+    }
+    if (_clear && _key->limit < 0 && _key->restrict == LindaRestrict::None && _key->pins == 0) {   // K_: KeysDB key args... KeyUD val
+        // KeyUD limit value and restrict mode are the default (unlimited/none), and no handle uses it: we can totally remove it
+        lua_pop(K_, 2);                                                                            // K_: KeysDB key args...
+        lua_pushvalue(K_, 2);                                                                      // K_: KeysDB key args... key
+        lua_pushnil(K_);                                                                           // K_: KeysDB key args... key nil
+        lua_rawset(K_, 1);                                                                         // K_: KeysDB key args...
+        return false;
+    }
+    lua_pushvalue(K_, -2);                                                                         // K_: KeysDB key args... KeyUD val KeyUD
+    bool const _wasFull{ _key->reset(K_) };
+    lua_pop(K_, 1);                                                                                // K_: KeysDB key args... KeyUD val
+    if (_clear) {
+        lua_pop(K_, 2);                                                                            // K_: KeysDB key args...
+        return _wasFull;
+    }
+    [[maybe_unused]] bool const _pushed{ _key->push(K_, 1, false) };                               // K_: KeysDB key args...
+    return _wasFull && (1 < _key->limit);
+}
+
+// #################################################################################################
+
+// in: KeysDB at the top of the stack
+// out: KeysDB KeyUD
+// get the fifo associated to the key found at key_, create it if it doesn't exist
+[[nodiscard]]
+static KeyUD* PushOrCreateKeyUD(KeeperState const K_, StackIndex const key_)
+{
+    STACK_GROW(K_, 3);
+    STACK_CHECK_START_REL(K_, 0);
+    lua_pushvalue(K_, key_);                                                                       // K_: ... KeysDB key
+    if (luaW_rawget(K_, StackIndex{ -2 }) == LuaType::NIL) {                                       // K_: ... KeysDB KeyUD|nil
+        lua_pop(K_, 1);                                                                            // K_: ... KeysDB
+        std::ignore = KeyUD::Create(K_);                                                           // K_: ... KeysDB KeyUD
+        // KeysDB[key] = KeyUD
+        lua_pushvalue(K_, key_);                                                                   // K_: ... KeysDB KeyUD key
+        lua_pushvalue(K_, -2);                                                                     // K_: ... KeysDB KeyUD key KeyUD
+        lua_rawset(K_, -4);                                                                        // K_: ... KeysDB KeyUD
+    }
+    STACK_CHECK(K_, 1);
+    return KeyUD::GetPtr(K_, kIdxTop);
+}
+
+// #################################################################################################
+
+// in: linda ref args...
+// out: linda KeyUD args...
+// ref is the reference under which linda:slot() pinned the KeyUD in the registry: no need to look it up in the KeysDB of the linda
+[[nodiscard]]
+static KeyUD* ReplacePinnedKeyUD(KeeperState const K_)
+{
+    STACK_GROW(K_, 1);
+    lua_rawgeti(K_, LUA_REGISTRYINDEX, static_cast<int>(lua_tointeger(K_, 2)));                    // K_: linda ref args... KeyUD
+    lua_replace(K_, 2);                                                                            // K_: linda KeyUD args...
+    return KeyUD::GetPtr(K_, StackIndex{ 2 });
+}
+
+// #################################################################################################
+
+// in: linda key|ref chain
+// out: linda key|ref kPackedValue...
+// returns the chain of values packed by linda:send(), after pushing the kPackedValue sentinels that stand for them in the fifo
+[[nodiscard]]
+static PackedValue* PushPackedSentinels(KeeperState const K_)
+{
+    PackedValue* const _packed{ luaW_tolightuserdata<PackedValue>(K_, StackIndex{ 3 }) };
+    int const _n{ PackedValue::CountAll(_packed) };
+    lua_settop(K_, 2);                                                                             // K_: linda key|ref
+    STACK_GROW(K_, _n);
+    for ([[maybe_unused]] int const _i : std::ranges::iota_view{ 0, _n }) {
+        kPackedValue.pushKey(K_);                                                                  // K_: linda key|ref kPackedValue...
+    }
+    return _packed;
+}
+
+// #################################################################################################
+
+// in: linda KeyUD val...
+// out: true|false|kRestrictedChannel
+// if the values are stored, the KeyUD takes ownership of the chain holding those of them that are packed
+[[nodiscard]]
+static int SendToKeyUD(KeeperState const K_, PackedValue* const packed_, bool const enforceLimit_)
+{
+    int const _n{ lua_gettop(K_) - 2 };
+    KeyUD* const _key{ KeyUD::GetPtr(K_, StackIndex{ 2 }) };
+    if (_key->restrict == LindaRestrict::SetGet) { // can we use send/receive?
+        lua_settop(K_, 0);                                                                         // K_:
+        kRestrictedChannel.pushKey(K_);                                                            // K_: kRestrictedChannel
+    }
+    else if (_key->push(K_, _n, enforceLimit_)) { // not enough room?
+        _key->sends += static_cast<uint64_t>(_n);
+        _key->appendPacked(packed_);
+        lua_settop(K_, 0);                                                                         // K_:
+        lua_pushboolean(K_, 1);                                                                    // K_: true
+    } else {
+        // don't send anything
+        lua_settop(K_, 0);                                                                         // K_:
+        lua_pushboolean(K_, 0);                                                                    // K_: false
+    }
+    return 1;
+}
+
+// #################################################################################################
+
+// in: linda key val...
+// out: true|false|kRestrictedChannel
+// if the values are stored, the KeyUD takes ownership of the chain holding those of them that are packed
+[[nodiscard]]
+static int SendValues(KeeperState const K_, PackedValue* const packed_, bool const enforceLimit_)
+{
+    STACK_CHECK_START_REL(K_, 0);                                                                  // K_: linda key val...
+    PushKeysDB(K_, StackIndex{ 1 });                                                               // K_: linda key val... KeysDB
+    std::ignore = PushOrCreateKeyUD(K_, StackIndex{ 2 });                                          // K_: linda key val... KeysDB KeyUD
+    lua_replace(K_, 2);                                                                            // K_: linda KeyUD val... KeysDB
+    lua_pop(K_, 1);                                                                                // K_: linda KeyUD val...
+    STACK_CHECK(K_, 0);
+    return SendToKeyUD(K_, packed_, enforceLimit_);
+}
+
+// #################################################################################################
+
+// in: KeyUD|nil
+// out: N val... [kPackedValue chain false]|0|kRestrictedChannel
+[[nodiscard]]
+static int GetValues(KeeperState const K_, int const count_)
+{
+    KeyUD* const _key{ KeyUD::GetPtr(K_, kIdxTop) };
+    if (_key != nullptr) {
+        if (_key->restrict == LindaRestrict::SendReceive) { // can we use set/get?
+            lua_settop(K_, 0);                                                                     // K_:
+            kRestrictedChannel.pushKey(K_);                                                        // K_: kRestrictedChannel
+            return 1;
+        } else {
+            _key->peek(K_, count_);                                                                // K_: N val...
+            _key->pushPackedChain(K_, StackIndex{ 2 }, false);                                     // K_: N val... [kPackedValue chain false]
+        }
+    } else {
+        // no fifo was ever registered for this key, or it is empty
+        lua_pop(K_, 1);                                                                            // K_:
+        lua_pushinteger(K_, 0);                                                                    // K_: 0
+    }
+    LUA_ASSERT(K_, lua_isnumber(K_, 1));
+    return lua_gettop(K_);
+}
+
+// #################################################################################################
+
+// the operations linda:batch() can run, and the restriction that forbids each of them
+struct BatchOperation
+{
+    std::string_view name;
+    keeper_api_t func;
+    LindaRestrict forbiddenBy;
+};
+static constexpr std::array<BatchOperation, 5> kBatchOperations{
+    BatchOperation{ "get", KEEPER_API(get), LindaRestrict::SendReceive },
+    BatchOperation{ "limit", KEEPER_API(limit), LindaRestrict::None },
+    BatchOperation{ "receive", KEEPER_API(receive), LindaRestrict::SetGet },
+    BatchOperation{ "send", KEEPER_API(send), LindaRestrict::SetGet },
+    BatchOperation{ "set", KEEPER_API(set), LindaRestrict::SendReceive }
+};
+
+// #################################################################################################
+
+// in: a batch operation at idx_, as validated by linda:batch()
+[[nodiscard]]
+static BatchOperation const& FindBatchOperation(KeeperState const K_, StackIndex const idx_)
+{
+    STACK_CHECK_START_REL(K_, 0);
+    lua_rawgeti(K_, idx_, 1);                                                                      // K_: ... op ... name
+    std::string_view const _name{ luaW_tostring(K_, kIdxTop) };
+    lua_pop(K_, 1);                                                                                // K_: ... op ...
+    STACK_CHECK(K_, 0);
+    auto const _it{ std::ranges::find(kBatchOperations, _name, &BatchOperation::name) };
+    LUA_ASSERT(K_, _it != kBatchOperations.end());
+    return *_it;
+}
+
+// #################################################################################################
+
+// in: results... [kPackedValue chain detach], as pushed by KeyUD::pushPackedChain()
+// out: results..., the kPackedValue sentinels among them replaced by the values they stand for
+// keeper_call() does that in the destination state, we do it when results stay in the keeper
+static void UnpackInKeeper(KeeperState const K_, StackIndex const first_)
+{
+    if ((lua_gettop(K_) - first_ + 1 < 3) || !kPackedValue.equals(K_, StackIndex{ -3 })) {
+        return;
+    }
+    PackedValue* const _chain{ luaW_tolightuserdata<PackedValue>(K_, StackIndex{ -2 }) };
+    bool const _detached{ lua_toboolean(K_, -1) ? true : false };
+    lua_pop(K_, 3);                                                                                // K_: results...
+    STACK_GROW(K_, 1);
+    PackedValue const* _packed{ _chain };
+    for (StackIndex const _i : std::ranges::iota_view{ first_, StackIndex{ lua_gettop(K_) + 1 } }) {
+        if (kPackedValue.equals(K_, _i)) {
+            _packed->push(K_, LookupMode::ToKeeper);                                               // K_: results... val
+            lua_replace(K_, _i);                                                                   // K_: results...
+            _packed = _packed->next;
+        }
+    }
+    if (_detached) {
+        PackedValue::FreeAll(Universe::Get(K_), _chain);
+    }
+}
+
 } // namespace
 
 // #################################################################################################
@@ -351,6 +1146,117 @@ static void PushKeysDB(KeeperState const K_, StackIndex const idx_)
 // #################################################################################################
 // #################################################################################################
 
+// in: linda ops
+// out: results, a table holding the values returned by each operation in a table with a 'n' field
+// or kRestrictedChannel and the index of the first operation forbidden by a restriction, in which case none is run
+// or results of the operations run before the one that raised an error, its index and the error: the operations before it remain applied
+[[nodiscard]]
+int keepercall_batch(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    static constexpr StackIndex kIdxOps{ 2 };
+    int const _nbOps{ static_cast<int>(lua_rawlen(_K, kIdxOps)) };
+    STACK_GROW(_K, 4);
+
+    // first make sure that no operation is forbidden, so that the batch is run entirely or not at all
+    PushKeysDB(_K, StackIndex{ 1 });                                                               // _K: linda ops KeysDB
+    for (int const _i : std::ranges::iota_view{ 1, _nbOps + 1 }) {
+        lua_rawgeti(_K, kIdxOps, _i);                                                              // _K: linda ops KeysDB op
+        LindaRestrict const _forbiddenBy{ FindBatchOperation(_K, kIdxTop).forbiddenBy };
+        lua_rawgeti(_K, -1, 2);                                                                    // _K: linda ops KeysDB op key
+        lua_rawget(_K, -3);                                                                        // _K: linda ops KeysDB op KeyUD|nil
+        KeyUD const* const _key{ KeyUD::GetPtr(_K, kIdxTop) };
+        if (_key != nullptr && _forbiddenBy != LindaRestrict::None && _key->restrict == _forbiddenBy) {
+            lua_settop(_K, 0);                                                                     // _K:
+            kRestrictedChannel.pushKey(_K);                                                        // _K: kRestrictedChannel
+            lua_pushinteger(_K, _i);                                                               // _K: kRestrictedChannel i
+            return 2;
+        }
+        lua_pop(_K, 2);                                                                            // _K: linda ops KeysDB
+    }
+    lua_pop(_K, 1);                                                                                // _K: linda ops
+
+    lua_createtable(_K, _nbOps, 0);                                                                // _K: linda ops results
+    for (int const _i : std::ranges::iota_view{ 1, _nbOps + 1 }) {
+        lua_rawgeti(_K, kIdxOps, _i);                                                              // _K: linda ops results op
+        StackIndex const _op{ lua_gettop(_K) };
+        BatchOperation const& _operation{ FindBatchOperation(_K, _op) };
+        int const _nbArgs{ static_cast<int>(lua_rawlen(_K, _op)) - 1 };
+        STACK_GROW(_K, 2 + _nbArgs);
+        lua_pushcfunction(_K, _operation.func);                                                    // _K: linda ops results op func
+        lua_pushvalue(_K, 1);                                                                      // _K: linda ops results op func linda
+        for (int const _j : std::ranges::iota_view{ 2, _nbArgs + 2 }) {
+            lua_rawgeti(_K, _op, _j);                                                              // _K: linda ops results op func linda key args...
+        }
+        // inside the keeper, unlimited is signified with a -1 limit, see linda:limit()
+        if (_operation.func == KEEPER_API(limit) && _nbArgs == 2 && lua_type(_K, -1) == LUA_TSTRING) {
+            lua_pop(_K, 1);                                                                        // _K: linda ops results op func linda key
+            lua_pushinteger(_K, -1);                                                               // _K: linda ops results op func linda key -1
+        }
+        // the arguments were checked by linda:batch() and the restrictions above, but an operation can still fail to allocate memory
+        if (ToLuaError(lua_pcall(_K, 1 + _nbArgs, LUA_MULTRET, 0)) != LuaError::OK) {              // _K: linda ops results op err
+            lua_replace(_K, 1);                                                                    // _K: err ops results op
+            lua_pop(_K, 1);                                                                        // _K: err ops results
+            lua_replace(_K, 2);                                                                    // _K: err results
+            lua_insert(_K, 1);                                                                     // _K: results err
+            lua_pushinteger(_K, _i);                                                               // _K: results err i
+            lua_insert(_K, 2);                                                                     // _K: results i err
+            return 3;
+        }                                                                                          // _K: linda ops results op ret...
+        StackIndex const _first{ _op + 1 };
+        UnpackInKeeper(_K, _first);
+        // receive() returns the key the value was read from, we know it already
+        if (_operation.func == KEEPER_API(receive) && lua_gettop(_K) > _op) {
+            lua_remove(_K, _first);                                                                // _K: linda ops results op ret...
+        }
+        int const _nbRets{ lua_gettop(_K) - _op };
+        lua_createtable(_K, _nbRets, 1);                                                           // _K: linda ops results op ret... {}
+        for (int const _j : std::ranges::reverse_view{ std::ranges::iota_view{ 1, _nbRets + 1 } }) {
+            lua_insert(_K, -2);                                                                    // _K: linda ops results op ret... {} ret[j]
+            lua_rawseti(_K, -2, _j);                                                               // _K: linda ops results op ret... {}
+        }
+        lua_pushinteger(_K, _nbRets);                                                              // _K: linda ops results op {} n
+        lua_setfield(_K, -2, "n");                                                                 // _K: linda ops results op {}
+        lua_rawseti(_K, -3, _i);                                                                   // _K: linda ops results op
+        lua_pop(_K, 1);                                                                            // _K: linda ops results
+    }
+    lua_replace(_K, 1);                                                                            // _K: results ops
+    lua_settop(_K, 1);                                                                             // _K: results
+    return 1;
+}
+
+// #################################################################################################
+
+// in: linda key expected new
+// out: true if the linda was full but it's no longer the case, else false, then true if the swap happened, else false and the current value
+// or kRestrictedChannel if the key is restricted
+[[nodiscard]]
+int keepercall_cas(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    if (!PushSetGetValue(_K)) {                                                                    // _K: kRestrictedChannel
+        return 1;
+    }                                                                                              // _K: KeysDB key expected new KeyUD|nil val
+    if (!lua_rawequal(_K, 3, kIdxTop)) {
+        lua_pushboolean(_K, 0);                                                                    // _K: KeysDB key expected new KeyUD|nil val false
+        lua_replace(_K, 1);                                                                        // _K: false key expected new KeyUD|nil val
+        lua_replace(_K, 2);                                                                        // _K: false val expected new KeyUD|nil
+        lua_settop(_K, 2);                                                                         // _K: false val
+        lua_pushboolean(_K, 0);                                                                    // _K: false val false
+        lua_insert(_K, 1);                                                                         // _K: false false val
+        return 3;
+    }
+    lua_pop(_K, 1);                                                                                // _K: KeysDB key expected new KeyUD|nil
+    lua_pushvalue(_K, 4);                                                                          // _K: KeysDB key expected new KeyUD|nil new
+    bool const _should_wake_writers{ ReplaceSetGetValue(_K) };                                     // _K: KeysDB key expected new
+    lua_settop(_K, 0);                                                                             // _K:
+    lua_pushboolean(_K, _should_wake_writers ? 1 : 0);                                             // _K: bool
+    lua_pushboolean(_K, 1);                                                                        // _K: bool true
+    return 2;
+}
+
+// #################################################################################################
+
 // in: linda
 // out: nothing
 [[nodiscard]]
@@ -430,10 +1336,20 @@ int keepercall_count(lua_State* const L_)
 [[nodiscard]]
 int keepercall_destruct(lua_State* const L_)
 {
-    STACK_GROW(L_, 3);
+    STACK_GROW(L_, 4);
     STACK_CHECK_START_REL(L_, 0);
-    // LindasDB[linda] = nil
     kLindasRegKey.pushValue(L_);                                                                   // L_: linda LindasDB
+    // don't wait for the KeyUDs to be collected to free the packed values they hold
+    lua_pushvalue(L_, 1);                                                                          // L_: linda LindasDB linda
+    if (luaW_rawget(L_, StackIndex{ -2 }) == LuaType::TABLE) {                                     // L_: linda LindasDB KeysDB
+        lua_pushnil(L_);                                                                           // L_: linda LindasDB KeysDB nil
+        while (lua_next(L_, -2)) {                                                                 // L_: linda LindasDB KeysDB key KeyUD
+            KeyUD::GetPtr(KeeperState{ L_ }, kIdxTop)->releasePacked(KeeperState{ L_ });
+            lua_pop(L_, 1);                                                                        // L_: linda LindasDB KeysDB key
+        }                                                                                          // L_: linda LindasDB KeysDB
+    }
+    lua_pop(L_, 1);                                                                                // L_: linda LindasDB
+    // LindasDB[linda] = nil
     lua_pushvalue(L_, 1);                                                                          // L_: linda LindasDB linda
     lua_pushnil(L_);                                                                               // L_: linda LindasDB linda nil
     lua_rawset(L_, -3);                                                                            // L_: linda LindasDB
@@ -455,26 +1371,55 @@ int keepercall_get(lua_State* const L_)
         _count = static_cast<int>(lua_tointeger(_K, 3)); // linda:get() made sure _count >= 1
         lua_pop(_K, 1);                                                                            // _K: linda key
     }
-    PushKeysDB(_K, StackIndex{ 1 });                                                               // _K: linda key KeysDB
-    lua_replace(_K, 1);                                                                            // _K: KeysDB key
-    lua_rawget(_K, 1);                                                                             // _K: KeysDB KeyUD
-    lua_remove(_K, 1);                                                                             // _K: KeyUD
-    KeyUD const* const _key{ KeyUD::GetPtr(_K, kIdxTop) };
-    if (_key != nullptr) {
-        if (_key->restrict == LindaRestrict::SendReceive) { // can we use set/get?
-            lua_settop(_K, 0);                                                                     // _K:
-            kRestrictedChannel.pushKey(_K);                                                        // _K: kRestrictedChannel
-            return 1;
-        } else {
-            _key->peek(_K, _count);                                                                // _K: N val...
-        }
-    } else {
-        // no fifo was ever registered for this key, or it is empty
-        lua_pop(_K, 1);                                                                            // _K:
-        lua_pushinteger(_K, 0);                                                                    // _K: 0
+    PushKeysDB(_K, StackIndex{ 1 });                                                               // _K: linda key KeysDB
+    lua_replace(_K, 1);                                                                            // _K: KeysDB key
+    lua_rawget(_K, 1);                                                                             // _K: KeysDB KeyUD|nil
+    lua_remove(_K, 1);                                                                             // _K: KeyUD|nil
+    return GetValues(_K, _count);
+}
+
+// #################################################################################################
+
+// in: linda key [delta]
+// out: true if the linda was full but it's no longer the case, else false, then the new value
+// or the current value alone if it is not a number, or kRestrictedChannel if the key is restricted
+[[nodiscard]]
+int keepercall_incr(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    if (lua_gettop(_K) == 2) {                                                                     // _K: linda key
+        lua_pushinteger(_K, 1);                                                                    // _K: linda key delta
+    }
+    if (!PushSetGetValue(_K)) {                                                                    // _K: kRestrictedChannel
+        return 1;
+    }                                                                                              // _K: KeysDB key delta KeyUD|nil val
+    if (kNilSentinel.equals(_K, kIdxTop)) {
+        // an empty slot counts as 0
+        lua_pop(_K, 1);                                                                            // _K: KeysDB key delta KeyUD|nil
+        lua_pushinteger(_K, 0);                                                                    // _K: KeysDB key delta KeyUD|nil 0
+    } else if (luaW_type(_K, kIdxTop) != LuaType::NUMBER) {
+        lua_replace(_K, 1);                                                                        // _K: val key delta KeyUD|nil
+        lua_settop(_K, 1);                                                                         // _K: val
+        return 1;
     }
-    LUA_ASSERT(_K, lua_isnumber(_K, 1));
-    return lua_gettop(_K);
+#if defined LUA_LNUM || LUA_VERSION_NUM >= 503
+    if (lua_isinteger(_K, kIdxTop) && lua_isinteger(_K, 3)) {
+        // wrap around on overflow, like Lua integer arithmetic does
+        using Unsigned = std::make_unsigned_t<lua_Integer>;
+        lua_pushinteger(_K, static_cast<lua_Integer>(static_cast<Unsigned>(lua_tointeger(_K, kIdxTop)) + static_cast<Unsigned>(lua_tointeger(_K, 3))));
+    } else
+#endif // defined LUA_LNUM || LUA_VERSION_NUM >= 503
+    {
+        lua_pushnumber(_K, lua_tonumber(_K, kIdxTop) + lua_tonumber(_K, 3));                       // _K: KeysDB key delta KeyUD|nil val sum
+    }
+    lua_remove(_K, -2);                                                                            // _K: KeysDB key delta KeyUD|nil sum
+    lua_pushvalue(_K, kIdxTop);                                                                    // _K: KeysDB key delta KeyUD|nil sum sum
+    lua_replace(_K, 3);                                                                            // _K: KeysDB key sum KeyUD|nil sum
+    bool const _should_wake_writers{ ReplaceSetGetValue(_K) };                                     // _K: KeysDB key sum
+    lua_pushboolean(_K, _should_wake_writers ? 1 : 0);                                             // _K: KeysDB key sum bool
+    lua_replace(_K, 1);                                                                            // _K: bool key sum
+    lua_remove(_K, 2);                                                                             // _K: bool sum
+    return 2;
 }
 
 // #################################################################################################
@@ -523,6 +1468,19 @@ int keepercall_limit(lua_State* const L_)
 
 // #################################################################################################
 
+// in: linda key chain
+// out: true|false|kRestrictedChannel
+// the values of the chain, packed by linda:post(), are stored as kPackedValue sentinels in the fifo, like keepercall_send_packed
+[[nodiscard]]
+int keepercall_post(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    PackedValue* const _packed{ PushPackedSentinels(_K) };                                         // _K: linda key kPackedValue...
+    return SendValues(_K, _packed, true);
+}
+
+// #################################################################################################
+
 // in: linda, key [, key]?
 // out: (key, val) or nothing
 [[nodiscard]]
@@ -558,7 +1516,8 @@ int keepercall_receive(lua_State* const L_)
                     lua_settop(_K, 2);                                                             // _K: val key[i]
                 }
                 lua_insert(_K, 1);                                                                 // _K: key val
-                return 2;
+                _key->pushPackedChain(_K, StackIndex{ 2 }, true);                                  // _K: key val [kPackedValue chain true]
+                return lua_gettop(_K);
             }
         }
         lua_settop(_K, _top);                                                                      // _K: data keys...
@@ -596,6 +1555,7 @@ int keepercall_receive_batched(lua_State* const L_)
     if (_key->pop(_K, _min_count, _max_count) == 0) {                                              // _K: [key val...]|crap
         return 0; // Lua will adjust the stack for us when we return
     }
+    _key->pushPackedChain(_K, StackIndex{ 2 }, true);                                              // _K: key val... [kPackedValue chain true]
     // return whatever remains on the stack at that point: the key and the values we pulled from the fifo
     return lua_gettop(_K);
 }
@@ -667,42 +1627,25 @@ int keepercall_restrict(lua_State* const L_)
 
 // #################################################################################################
 
-// in: linda, key, ...
+// in: linda key val...
 // out: true|false|kRestrictedChannel
 [[nodiscard]]
 int keepercall_send(lua_State* const L_)
+{
+    return SendValues(KeeperState{ L_ }, nullptr, true);
+}
+
+// #################################################################################################
+
+// in: linda key chain
+// out: true|false|kRestrictedChannel
+// the values of the chain, packed by linda:send(), are stored as kPackedValue sentinels in the fifo
+[[nodiscard]]
+int keepercall_send_packed(lua_State* const L_)
 {
     KeeperState const _K{ L_ };
-    int const _n{ lua_gettop(_K) - 2 };
-    STACK_CHECK_START_REL(_K, 0);                                                                  // _K: linda key val...
-    PushKeysDB(_K, StackIndex{ 1 });                                                               // _K: linda key val... KeysDB
-    // get the fifo associated to this key in this linda, create it if it doesn't exist
-    lua_pushvalue(_K, 2);                                                                          // _K: linda key val... KeysDB key
-    if (luaW_rawget(_K, StackIndex{ -2 }) == LuaType::NIL) {                                       // _K: linda key val... KeysDB KeyUD|nil
-        lua_pop(_K, 1);                                                                            // _K: linda key val... KeysDB
-        std::ignore = KeyUD::Create(KeeperState{ _K });                                            // _K: linda key val... KeysDB KeyUD
-        // KeysDB[key] = KeyUD
-        lua_pushvalue(_K, 2);                                                                      // _K: linda key val... KeysDB KeyUD key
-        lua_pushvalue(_K, -2);                                                                     // _K: linda key val... KeysDB KeyUD key KeyUD
-        lua_rawset(_K, -4);                                                                        // _K: linda key val... KeysDB KeyUD
-    }
-    lua_replace(_K, 2);                                                                            // _K: linda KeyUD val... KeysDB
-    lua_pop(_K, 1);                                                                                // _K: linda KeyUD val...
-    STACK_CHECK(_K, 0);
-    KeyUD* const _key{ KeyUD::GetPtr(_K, StackIndex{ 2 }) };
-    if (_key->restrict == LindaRestrict::SetGet) { // can we use send/receive?
-        lua_settop(_K, 0);                                                                         // _K:
-        kRestrictedChannel.pushKey(_K);                                                            // _K: kRestrictedChannel
-    }
-    else if (_key->push(_K, _n, true)) { // not enough room?
-        lua_settop(_K, 0);                                                                         // _K:
-        lua_pushboolean(_K, 1);                                                                    // _K: true
-    } else {
-        // don't send anything
-        lua_settop(_K, 0);                                                                         // _K:
-        lua_pushboolean(_K, 0);                                                                    // _K: false
-    }
-    return 1;
+    PackedValue* const _packed{ PushPackedSentinels(_K) };                                         // _K: linda key kPackedValue...
+    return SendValues(_K, _packed, true);
 }
 
 // #################################################################################################
@@ -731,7 +1674,7 @@ int keepercall_set(lua_State* const L_)
     if (lua_gettop(_K) == 3) { // no value to set                                                  // _K: KeysDB key KeyUD|nil
         // empty the KeyUD for the specified key: replace uservalue with a virgin table, reset counters, but leave limit unchanged!
         if (_key != nullptr) { // might be nullptr if we set a nonexistent key to nil              // _K: KeysDB key KeyUD
-            if (_key->limit < 0 && _key->restrict == LindaRestrict::None) { // KeyUD limit value and restrict mode are the default (unlimited/none): we can totally remove it
+            if (_key->limit < 0 && _key->restrict == LindaRestrict::None && _key->pins == 0) { // KeyUD limit value and restrict mode are the default (unlimited/none), and no handle uses it: we can totally remove it
                 lua_pop(_K, 1);                                                                    // _K: KeysDB key
                 lua_pushnil(_K);                                                                   // _K: KeysDB key nil
                 lua_rawset(_K, -3);                                                                // _K: KeysDB
@@ -770,6 +1713,155 @@ int keepercall_set(lua_State* const L_)
 
 // #################################################################################################
 
+// in: linda ref [count]
+// out: N val... [kPackedValue chain false]|0|kRestrictedChannel, like keepercall_get
+[[nodiscard]]
+int keepercall_slot_get(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    int _count{ 1 };
+    if (lua_gettop(_K) == 3) {                                                                     // _K: linda ref count
+        _count = static_cast<int>(lua_tointeger(_K, 3)); // slot:get() made sure _count >= 1
+        lua_pop(_K, 1);                                                                            // _K: linda ref
+    }
+    std::ignore = ReplacePinnedKeyUD(_K);                                                          // _K: linda KeyUD
+    lua_remove(_K, 1);                                                                             // _K: KeyUD
+    return GetValues(_K, _count);
+}
+
+// #################################################################################################
+
+// in: linda key
+// out: ref
+// the KeyUD of the key is created if necessary, and anchored in the registry until keepercall_slot_unpin releases the reference
+[[nodiscard]]
+int keepercall_slot_pin(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    PushKeysDB(_K, StackIndex{ 1 });                                                               // _K: linda key KeysDB
+    KeyUD* const _key{ PushOrCreateKeyUD(_K, StackIndex{ 2 }) };                                   // _K: linda key KeysDB KeyUD
+    ++_key->pins;
+    int const _ref{ luaL_ref(_K, LUA_REGISTRYINDEX) };                                             // _K: linda key KeysDB
+    lua_settop(_K, 0);                                                                             // _K:
+    lua_pushinteger(_K, _ref);                                                                     // _K: ref
+    return 1;
+}
+
+// #################################################################################################
+
+// in: linda ref
+// out: val [kPackedValue chain true]|nothing|kRestrictedChannel
+[[nodiscard]]
+int keepercall_slot_receive(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    KeyUD* const _key{ ReplacePinnedKeyUD(_K) };                                                   // _K: linda KeyUD
+    lua_remove(_K, 1);                                                                             // _K: KeyUD
+    if (_key->restrict == LindaRestrict::SetGet) { // can we use send/receive?
+        lua_settop(_K, 0);                                                                         // _K:
+        kRestrictedChannel.pushKey(_K);                                                            // _K: kRestrictedChannel
+        return 1;
+    }
+    if (_key->pop(_K, 1, 1) == 0) {                                                                // _K: val|
+        return 0;
+    }
+    _key->pushPackedChain(_K, StackIndex{ 1 }, true);                                              // _K: val [kPackedValue chain true]
+    return lua_gettop(_K);
+}
+
+// #################################################################################################
+
+// in: linda ref val...
+// out: true|false|kRestrictedChannel
+[[nodiscard]]
+int keepercall_slot_send(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    std::ignore = ReplacePinnedKeyUD(_K);                                                          // _K: linda KeyUD val...
+    return SendToKeyUD(_K, nullptr, true);
+}
+
+// #################################################################################################
+
+// in: linda ref chain
+// out: true|false|kRestrictedChannel
+[[nodiscard]]
+int keepercall_slot_send_packed(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    PackedValue* const _packed{ PushPackedSentinels(_K) };                                         // _K: linda ref kPackedValue...
+    std::ignore = ReplacePinnedKeyUD(_K);                                                          // _K: linda KeyUD kPackedValue...
+    return SendToKeyUD(_K, _packed, true);
+}
+
+// #################################################################################################
+
+// in: linda ref [val...]
+// out: true if the linda was full but it's no longer the case, else false, then the fill status, like keepercall_set
+// or kRestrictedChannel if the key is restricted
+[[nodiscard]]
+int keepercall_slot_set(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    STACK_GROW(_K, 2);
+    KeyUD* const _key{ ReplacePinnedKeyUD(_K) };                                                   // _K: linda KeyUD val...
+    lua_remove(_K, 1);                                                                             // _K: KeyUD val...
+    if (_key->restrict == LindaRestrict::SendReceive) { // can we use set/get?
+        lua_settop(_K, 0);                                                                         // _K:
+        kRestrictedChannel.pushKey(_K);                                                            // _K: kRestrictedChannel
+        return 1;
+    }
+    int const _count{ lua_gettop(_K) - 1 }; // number of items we want to store
+    // a pinned KeyUD is never removed from the KeysDB, so setting nothing just empties it
+    lua_pushvalue(_K, 1);                                                                          // _K: KeyUD val... KeyUD
+    // we create room if the KeyUD was full but we didn't refill it to the brim with new data
+    bool const _should_wake_writers{ _key->reset(_K) && (_count < _key->limit) };
+    lua_pop(_K, 1);                                                                                // _K: KeyUD val...
+    [[maybe_unused]] bool const _pushed{ _key->push(_K, _count, false) };                          // _K:
+    lua_pushboolean(_K, _should_wake_writers ? 1 : 0);                                             // _K: bool
+    _key->pushFillStatus(_K);                                                                      // _K: bool <fill status>
+    return 2;
+}
+
+// #################################################################################################
+
+// in: linda ref
+// out: nothing
+// releases the reference obtained with keepercall_slot_pin
+[[nodiscard]]
+int keepercall_slot_unpin(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    int const _ref{ static_cast<int>(lua_tointeger(_K, 2)) };
+    --ReplacePinnedKeyUD(_K)->pins;                                                                // _K: linda KeyUD
+    luaL_unref(_K, LUA_REGISTRYINDEX, _ref);
+    lua_settop(_K, 0);                                                                             // _K:
+    return 0;
+}
+
+// #################################################################################################
+
+// in: linda key val
+// out: true if the linda was full but it's no longer the case, else false, then the previous value
+// or kRestrictedChannel if the key is restricted
+[[nodiscard]]
+int keepercall_swap(lua_State* const L_)
+{
+    KeeperState const _K{ L_ };
+    if (!PushSetGetValue(_K)) {                                                                    // _K: kRestrictedChannel
+        return 1;
+    }                                                                                              // _K: KeysDB key val KeyUD|nil old
+    lua_replace(_K, 1);                                                                            // _K: old key val KeyUD|nil
+    lua_pushvalue(_K, 3);                                                                          // _K: old key val KeyUD|nil val
+    bool const _should_wake_writers{ ReplaceSetGetValue(_K) };                                     // _K: old key val
+    lua_settop(_K, 1);                                                                             // _K: old
+    lua_pushboolean(_K, _should_wake_writers ? 1 : 0);                                             // _K: old bool
+    lua_insert(_K, 1);                                                                             // _K: bool old
+    return 2;
+}
+
+// #################################################################################################
+
 /*
  * Call a function ('func_name') in the keeper state, and pass on the returned
  * values to 'L'.
@@ -780,9 +1872,12 @@ int keepercall_set(lua_State* const L_)
  * Returns: number of return values (pushed to 'L'), unset in case of error
  */
 [[nodiscard]]
-KeeperCallResult keeper_call(KeeperState const K_, keeper_api_t const func_, lua_State* const L_, Linda* const linda_, StackIndex const starting_index_)
+KeeperCallResult keeper_call(Keeper& keeper_, keeper_api_t const func_, lua_State* const L_, Linda* const linda_, StackIndex const starting_index_)
 {
+    KeeperState const K_{ keeper_.K };
     KeeperCallResult _result;
+    PackedValue* _packed{ nullptr };
+    bool _detached{ false };
     StackIndex const _args{ starting_index_ ? (lua_gettop(L_) - starting_index_ + 1) : 0 };        // L: ... args...                                  K_:
     StackIndex const _top_K{ lua_gettop(K_) };
     // if we didn't do anything wrong, the keeper stack should be clean
@@ -796,7 +1891,14 @@ KeeperCallResult keeper_call(KeeperState const K_, keeper_api_t const func_, lua
         (InterCopyContext{ linda_->U, DestState{ K_.value() }, SourceState{ L_ }, {}, {}, {}, LookupMode::ToKeeper, {} }.interCopy(_args) == InterCopyResult::Success)
     ) {                                                                                            // L: ... args...                                  K_: func_ linda args...
         lua_call(K_, 1 + _args, LUA_MULTRET);                                                      // L: ... args...                                  K_: result...
-        int const _retvals{ lua_gettop(K_) - _top_K };
+        int _retvals{ lua_gettop(K_) - _top_K };
+        // if some results are packed values, the chain holding them follows, see KeyUD::pushPackedChain()
+        if ((_retvals >= 3) && kPackedValue.equals(K_, StackIndex{ -3 })) {                        // L: ... args...                                  K_: result... kPackedValue chain bool
+            _packed = luaW_tolightuserdata<PackedValue>(K_, StackIndex{ -2 });
+            _detached = lua_toboolean(K_, -1) ? true : false;
+            lua_pop(K_, 3);                                                                        // L: ... args...                                  K_: result...
+            _retvals -= 3;
+        }
         // note that this can raise a lua error while the keeper state (and its mutex) is acquired
         // this may interrupt a lane, causing the destruction of the underlying OS thread
         // after this, another lane making use of this keeper can get an error code from the mutex-locking function
@@ -805,28 +1907,22 @@ KeeperCallResult keeper_call(KeeperState const K_, keeper_api_t const func_, lua
             (_retvals == 0) ||
             (InterCopyContext{ linda_->U, DestState{ L_ }, SourceState{ K_.value() }, {}, {}, {}, LookupMode::FromKeeper, {} }.interMove(_retvals) == InterCopyResult::Success)
         ) {                                                                                        // L: ... args... result...                        K_: result...
+            if (_packed != nullptr) {
+                UnpackResults(L_, _retvals, _packed);
+            }
             _result.emplace(_retvals);
         }
     }
+    if (_detached) {
+        PackedValue::FreeAll(linda_->U, _packed);
+    }
     // whatever happens, restore the stack to where it was at the origin
     lua_settop(K_, _top_K);                                                                        // L: ... args... result...                        K_:
 
     // don't do this for this particular function, as it is only called during Linda destruction, and we don't want to raise an error, ever
     if (func_ != KEEPER_API(destruct)) [[unlikely]] {
         // since keeper state GC is stopped, let's run a step once in a while if required
-        int const _gc_threshold{ linda_->U->keepers.gc_threshold };
-        if (_gc_threshold == 0) [[unlikely]] {
-            lua_gc(K_, LUA_GCSTEP, 0);
-        } else if (_gc_threshold > 0) [[likely]] {
-            int const _gc_usage{ lua_gc(K_, LUA_GCCOUNT, 0) };
-            if (_gc_usage >= _gc_threshold) {
-                lua_gc(K_, LUA_GCCOLLECT, 0);
-                int const _gc_usage_after{ lua_gc(K_, LUA_GCCOUNT, 0) };
-                if (_gc_usage_after > _gc_threshold) [[unlikely]] {
-                    raise_luaL_error(L_, "Keeper GC threshold is too low, need at least %d", _gc_usage_after);
-                }
-            }
-        }
+        keeper_.stepGarbageCollector(L_, linda_->U->keepers.gc_threshold);
     }
 
     return _result;
@@ -838,21 +1934,206 @@ KeeperCallResult keeper_call(KeeperState const K_, keeper_api_t const func_, lua
 // #################################################################################################
 // #################################################################################################
 
+// in: the mutex is acquired
+// apply the sends posted by linda:post() that are still pending, in the order they were posted
+void Keeper::applyPosted()
+{
+    takePosted();
+    if (K == nullptr) { // keepers are closing
+        return;
+    }
+    StackIndex const _top{ lua_gettop(K) };
+    STACK_GROW(K, 3);
+    // unlink each post before applying it, in case discardPosted() is called in the meantime because a linda is collected
+    while (PostedSend* const _post{ postedFifo }) {
+        postedFifo = _post->next;
+        Linda* const _linda{ _post->linda };
+        PackedValue* const _slot{ _post->values };
+        PackedValue* const _values{ std::exchange(_slot->next, nullptr) };
+        int const _nbValues{ PackedValue::CountAll(_values) };
+        size_t const _packedBytes{ PackedValue::SizeAll(_values) };
+        lua_pushcfunction(K, KEEPER_API(post));                                                    // K: post
+        lua_pushlightuserdata(K, _linda);                                                          // K: post linda
+        _slot->push(K, LookupMode::ToKeeper);                                                      // K: post linda slot
+        LindaSlotId const _slotId{ Linda::SlotId(K, kIdxTop) };
+        lua_pushlightuserdata(K, _values);                                                         // K: post linda slot chain
+        _linda->enterKeeperOperation(PK);
+        // nobody is left to report an error to: values that a full or restricted slot doesn't accept are dropped, and counted as such
+        if (ToLuaError(lua_pcall(K, 3, 1, 0)) == LuaError::OK && luaW_type(K, kIdxTop) == LuaType::BOOLEAN && lua_toboolean(K, kIdxTop)) { // K: true|false|kRestrictedChannel|err
+            _linda->stats.sends.fetch_add(static_cast<uint64_t>(_nbValues), std::memory_order_relaxed);
+            _linda->stats.bytes.fetch_add(_packedBytes, std::memory_order_relaxed);
+            _linda->wakeWaiters(Linda::Waiter::Kind::Reader, _slotId, (_nbValues == 1) ? Linda::WakeMode::One : Linda::WakeMode::All);
+        } else {
+            _linda->stats.droppedPosts.fetch_add(static_cast<uint64_t>(_nbValues), std::memory_order_relaxed);
+            PackedValue::FreeAll(_linda->U, _values);
+        }
+        _linda->leaveKeeperOperation(PK);
+        lua_settop(K, _top);                                                                       // K:
+        PackedValue::FreeAll(_linda->U, _slot);
+        _post->~PostedSend();
+        _linda->U->internalAllocator.free(_post, sizeof(PostedSend));
+        nbPosted.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+// #################################################################################################
+
+// in: the mutex is acquired
+// forget the sends posted to a linda that is being destroyed, or to all lindas if linda_ is nullptr
+void Keeper::discardPosted(Linda const* const linda_)
+{
+    takePosted();
+    PostedSend** _link{ &postedFifo };
+    while (PostedSend* const _post{ *_link }) {
+        if (linda_ != nullptr && _post->linda != linda_) {
+            _link = &_post->next;
+            continue;
+        }
+        *_link = _post->next;
+        Universe* const _U{ _post->linda->U };
+        PackedValue::FreeAll(_U, _post->values);
+        _post->~PostedSend();
+        _U->internalAllocator.free(_post, sizeof(PostedSend));
+        nbPosted.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+// #################################################################################################
+
+void Keeper::lock()
+{
+    std::chrono::time_point<std::chrono::steady_clock> const _start{ std::chrono::steady_clock::now() };
+    mutex.lock();
+    heldSince = std::chrono::steady_clock::now();
+    ++stats.acquisitions;
+    stats.waitTime += heldSince - _start;
+    holderApplies.store(true, std::memory_order_relaxed);
+}
+
+// #################################################################################################
+
+// can be called without the mutex
+// if the mutex is free, the queue is applied right away. otherwise its holder does it when it releases the mutex, see unlock()
+// the poster waits for the mutex and applies the queue itself when too many sends are already left to the holder, or when the holder releases it without applying the queue
+void Keeper::post(PostedSend* const post_)
+{
+    // the holder of the mutex applies the sends left to it when it releases the mutex: don't make an unrelated operation pay for too many of them
+    bool const _leaveToHolder{ nbPosted.fetch_add(1, std::memory_order_relaxed) < kMaxPostsLeftToHolder };
+    if (!_leaveToHolder) {
+        lock();
+    }
+    PostedSend* _head{ posted.load(std::memory_order_relaxed) };
+    do {
+        post_->next = _head;
+    } while (!posted.compare_exchange_weak(_head, post_, std::memory_order_seq_cst, std::memory_order_relaxed));
+    if (!_leaveToHolder) {
+        unlock();
+        return;
+    }
+    // pairs with the fence in unlock(): either we see the mutex released, or the holder sees our post once it released it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tryLock()) {
+        unlock();
+        return;
+    }
+    // the holder stops applying posts before it takes the queue for the last time: if it still does, it will see ours
+    // otherwise, wait for the mutex to apply it ourselves: the holder is already releasing it, or won't go through unlock() to do so
+    if (!holderApplies.load(std::memory_order_seq_cst)) {
+        lock();
+        unlock();
+    }
+}
+
+// #################################################################################################
+
+// in: the mutex is acquired
+// the holder is about to release the mutex by sleeping on a condition variable, without looking at what is posted in the meantime
+// tell posters not to count on it, then apply what was posted until now
+void Keeper::prepareSleep()
+{
+    holderApplies.store(false, std::memory_order_seq_cst);
+    applyPosted();
+}
+
+// #################################################################################################
+
+// only used by linda:stats()
+// only lists the slots held by the specified keeper (all of them, unless the linda is sharded)
+// table is populated as follows:
+// {
+//     [<key>] = { sends = <n>, receives = <n>, count = <n>, max_count = <n>, bytes = <n> },
+//     ...
+// }
+[[nodiscard]]
+int Keeper::PushLindaStats(Linda& linda_, KeeperIndex const keeper_, DestState const L_)
+{
+    Keeper* const _keeper{ linda_.U->keepers.getKeeper(keeper_) };
+    KeeperState const _K{ _keeper ? _keeper->K : KeeperState{ static_cast<lua_State*>(nullptr) } };
+    if (_K == nullptr) {
+        return 0;
+    }
+    STACK_GROW(_K, 4);
+    STACK_CHECK_START_REL(_K, 0);
+    kLindasRegKey.pushValue(_K);                                                                   // _K: LindasDB                                       L_:
+    lua_pushlightuserdata(_K, &linda_);                                                            // _K: LindasDB linda                                 L_:
+    LuaType const _type{ luaW_rawget(_K, StackIndex{ -2 }) };                                      // _K: LindasDB KeysDB                                L_:
+    lua_remove(_K, -2);                                                                            // _K: KeysDB                                         L_:
+    if (_type != LuaType::TABLE) { // possible if we didn't send anything through that linda
+        lua_pop(_K, 1);                                                                            // _K:                                                L_:
+        STACK_CHECK(_K, 0);
+        return 0;
+    }
+    STACK_GROW(L_, 4);
+    STACK_CHECK_START_REL(L_, 0);
+    lua_newtable(L_);                                                                              // _K: KeysDB                                         L_: out
+    InterCopyContext _c{ linda_.U, L_, SourceState{ _K.value() }, {}, {}, {}, LookupMode::FromKeeper, {} };
+    lua_pushnil(_K);                                                                               // _K: KeysDB nil                                     L_: out
+    while (lua_next(_K, -2)) {                                                                     // _K: KeysDB key KeyUD                               L_: out
+        KeyUD const* const _key{ KeyUD::GetPtr(_K, kIdxTop) };
+        lua_pop(_K, 1);                                                                            // _K: KeysDB key                                     L_: out
+        lua_pushvalue(_K, -1);                                                                     // _K: KeysDB key key                                 L_: out
+        if (_c.interMove(1) != InterCopyResult::Success) {                                         // _K: KeysDB key                                     L_: out key
+            raise_luaL_error(L_, "Internal error reading Keeper contents");
+        }
+        lua_createtable(L_, 0, 5);                                                                 // _K: KeysDB key                                     L_: out key keyout
+        lua_pushinteger(L_, static_cast<lua_Integer>(_key->sends));                                // _K: KeysDB key                                     L_: out key keyout sends
+        lua_setfield(L_, -2, "sends");                                                             // _K: KeysDB key                                     L_: out key keyout
+        lua_pushinteger(L_, static_cast<lua_Integer>(_key->receives));                             // _K: KeysDB key                                     L_: out key keyout receives
+        lua_setfield(L_, -2, "receives");                                                          // _K: KeysDB key                                     L_: out key keyout
+        lua_pushinteger(L_, _key->count);                                                          // _K: KeysDB key                                     L_: out key keyout count
+        lua_setfield(L_, -2, "count");                                                             // _K: KeysDB key                                     L_: out key keyout
+        lua_pushinteger(L_, _key->maxCount);                                                       // _K: KeysDB key                                     L_: out key keyout max_count
+        lua_setfield(L_, -2, "max_count");                                                         // _K: KeysDB key                                     L_: out key keyout
+        lua_pushinteger(L_, static_cast<lua_Integer>(_key->bytes));                                // _K: KeysDB key                                     L_: out key keyout bytes
+        lua_setfield(L_, -2, "bytes");                                                             // _K: KeysDB key                                     L_: out key keyout
+        // out[key] = keyout
+        lua_rawset(L_, -3);                                                                        // _K: KeysDB key                                     L_: out
+        STACK_CHECK(L_, 1);
+    }                                                                                              // _K: KeysDB                                         L_: out
+    lua_pop(_K, 1);                                                                                // _K:                                                L_: out
+    STACK_CHECK(_K, 0);
+    return 1;
+}
+
+// #################################################################################################
+
 // only used by linda:dump() and linda:__towatch() for debugging purposes
+// only lists the slots held by the specified keeper (all of them, unless the linda is sharded)
 // table is populated as follows:
 // {
 //     [<key>] = {
 //         first = <n>,
 //         count = <n>,
 //         limit = <n> | 'unlimited',
-//         fifo = { <array of values> }
+//         restrict = 'none' | 'set/get' | 'send/receive',
+//         fifo = { [first] = <value>, ... [first + count - 1] = <value> }
 //     }
 //     ...
 // }
 [[nodiscard]]
-int Keeper::PushLindaStorage(Linda& linda_, DestState const L_)
+int Keeper::PushLindaStorage(Linda& linda_, KeeperIndex const keeper_, DestState const L_)
 {
-    Keeper* const _keeper{ linda_.whichKeeper() };
+    Keeper* const _keeper{ linda_.U->keepers.getKeeper(keeper_) };
     KeeperState const _K{ _keeper ? _keeper->K : KeeperState{ static_cast<lua_State*>(nullptr) } };
     if (_K == nullptr) {
         return 0;
@@ -876,7 +2157,7 @@ int Keeper::PushLindaStorage(Linda& linda_, DestState const L_)
     lua_pushnil(_K);                                                                               // _K: KeysDB nil                                     L_: out
     while (lua_next(_K, -2)) {                                                                     // _K: KeysDB key KeyUD                               L_: out
         KeyUD* const _key{ KeyUD::GetPtr(_K, kIdxTop) };
-        _key->prepareAccess(_K, kIdxTop);                                                          // _K: KeysDB key fifo                                L_: out
+        _key->prepareDump(_K, kIdxTop);                                                            // _K: KeysDB key fifo                                L_: out
         lua_pushvalue(_K, -2);                                                                     // _K: KeysDB key fifo key                            L_: out
         if (_c.interMove(1) != InterCopyResult::Success) {                                         // _K: KeysDB key fifo                                L_: out key
             raise_luaL_error(L_, "Internal error reading Keeper contents");
@@ -928,6 +2209,115 @@ int Keeper::PushLindaStorage(Linda& linda_, DestState const L_)
     return 1;
 }
 
+// in: the mutex is acquired
+// out: { acquisitions = <n>, wait = <seconds>, hold = <seconds>, gc_steps = <n>, gc = <seconds> }
+void Keeper::pushStats(lua_State* const L_) const
+{
+    STACK_GROW(L_, 2);
+    STACK_CHECK_START_REL(L_, 0);
+    lua_createtable(L_, 0, 5);                                                                     // L_: {}
+    lua_pushinteger(L_, static_cast<lua_Integer>(stats.acquisitions));                             // L_: {} acquisitions
+    lua_setfield(L_, -2, "acquisitions");                                                          // L_: {}
+    lua_pushnumber(L_, std::chrono::duration_cast<lua_Duration>(stats.waitTime).count());          // L_: {} wait
+    lua_setfield(L_, -2, "wait");                                                                  // L_: {}
+    // the current hold is not over yet
+    lua_pushnumber(L_, std::chrono::duration_cast<lua_Duration>(stats.holdTime + (std::chrono::steady_clock::now() - heldSince)).count()); // L_: {} hold
+    lua_setfield(L_, -2, "hold");                                                                  // L_: {}
+    lua_pushinteger(L_, static_cast<lua_Integer>(stats.gcSteps));                                  // L_: {} gc_steps
+    lua_setfield(L_, -2, "gc_steps");                                                              // L_: {}
+    lua_pushnumber(L_, std::chrono::duration_cast<lua_Duration>(stats.gcTime).count());            // L_: {} gc
+    lua_setfield(L_, -2, "gc");                                                                    // L_: {}
+    STACK_CHECK(L_, 1);
+}
+
+// #################################################################################################
+
+// in: the mutex is acquired
+// when the memory usage is above the threshold, run a single bounded GC step, so that no operation pays for a whole cycle
+// a cycle is thus spread over the operations that follow, until it completes
+void Keeper::stepGarbageCollector(lua_State* const L_, int const threshold_)
+{
+    if (threshold_ < 0) [[unlikely]] { // GC runs automatically
+        return;
+    }
+    if (threshold_ > 0 && lua_gc(K, LUA_GCCOUNT, 0) < threshold_) [[likely]] {
+        return;
+    }
+    std::chrono::time_point<std::chrono::steady_clock> const _start{ std::chrono::steady_clock::now() };
+    bool const _cycleCompleted{ lua_gc(K, LUA_GCSTEP, 0) != 0 };
+    ++stats.gcSteps;
+    stats.gcTime += std::chrono::steady_clock::now() - _start;
+    if (threshold_ == 0 || !_cycleCompleted) {
+        return;
+    }
+    // values created while the cycle was running can survive it: only complain if the usage remains too high after the next one too
+    int const _gcUsageAfter{ lua_gc(K, LUA_GCCOUNT, 0) };
+    gcCyclesOverThreshold = (_gcUsageAfter > threshold_) ? gcCyclesOverThreshold + 1 : 0;
+    if (gcCyclesOverThreshold >= 2) [[unlikely]] {
+        gcCyclesOverThreshold = 0;
+        raise_luaL_error(L_, "Keeper GC threshold is too low, need at least %d", _gcUsageAfter);
+    }
+}
+
+// #################################################################################################
+
+// in: the mutex is acquired
+// move the posted sends to the end of postedFifo, oldest first
+void Keeper::takePosted()
+{
+    if (posted.load(std::memory_order_seq_cst) == nullptr) [[likely]] {
+        return;
+    }
+    PostedSend* _post{ posted.exchange(nullptr, std::memory_order_acquire) };
+    // posted is a stack: reverse it to get the posts in the order they were made
+    PostedSend* _fifo{ nullptr };
+    while (_post != nullptr) {
+        PostedSend* const _next{ _post->next };
+        _post->next = _fifo;
+        _fifo = _post;
+        _post = _next;
+    }
+    PostedSend** _last{ &postedFifo };
+    while (*_last != nullptr) {
+        _last = &(*_last)->next;
+    }
+    *_last = _fifo;
+}
+
+// #################################################################################################
+
+// returns true if the mutex was acquired
+bool Keeper::tryLock()
+{
+    if (!mutex.try_lock()) {
+        return false;
+    }
+    heldSince = std::chrono::steady_clock::now();
+    ++stats.acquisitions;
+    holderApplies.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// #################################################################################################
+
+// at most kMaxPostsLeftToHolder sends can be left to us, so the work done here is bounded, see post()
+void Keeper::unlock()
+{
+    // a second pass handles the sends that were posted while we released the mutex, without waiting for the next operation
+    for (int const _pass : std::ranges::iota_view{ 0, 2 }) {
+        if (_pass == 1 && (posted.load(std::memory_order_relaxed) == nullptr || !tryLock())) {
+            return;
+        }
+        // what was posted while we held the mutex is applied before we release it
+        holderApplies.store(false, std::memory_order_seq_cst);
+        applyPosted();
+        stats.holdTime += std::chrono::steady_clock::now() - heldSince;
+        mutex.unlock();
+        // pairs with the fence in post(): a post that failed to acquire the mutex before we released it is seen here
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
 // #################################################################################################
 // #################################################################################################
 // ########################################## Keepers ##############################################
@@ -956,9 +2346,11 @@ void Keepers::collectGarbage()
     }
 
     auto _gcOneKeeper = [](Keeper& keeper_) {
-        std::lock_guard<std::mutex> _guard(keeper_.mutex);
+        std::lock_guard<Keeper> _guard(keeper_);
         if (keeper_.K) {
+            std::chrono::time_point<std::chrono::steady_clock> const _start{ std::chrono::steady_clock::now() };
             lua_gc(keeper_.K, LUA_GCCOLLECT, 0);
+            keeper_.stats.gcTime += std::chrono::steady_clock::now() - _start;
         }
     };
 
@@ -992,6 +2384,8 @@ bool Keepers::close()
     }
 
     auto _closeOneKeeper = [](Keeper& keeper_) {
+        // posts that no operation applied are lost
+        keeper_.discardPosted(nullptr);
         lua_State* const _K{ std::exchange(keeper_.K, KeeperState{ static_cast<lua_State*>(nullptr) }) };
         if (_K) {
             lua_close(_K);
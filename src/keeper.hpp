@@ -5,6 +5,7 @@
 // forwards
 class Linda;
 class Universe;
+enum class LookupMode;
 
 DECLARE_UNIQUE_TYPE(KeeperState,lua_State*);
 DECLARE_UNIQUE_TYPE(LindaLimit, int);
@@ -21,11 +22,89 @@ enum class [[nodiscard]] LindaRestrict
 
 // #################################################################################################
 
+// a value sent through a linda, serialized in native memory instead of being copied inside the keeper state
+// only nil, booleans, numbers, strings, light userdata, and flat tables of those without a metatable can be packed
+// the slot holding such a value in the keeper only stores a sentinel, the serialized values are chained in arrival order
+class PackedValue final
+{
+    public:
+    PackedValue* next{ nullptr };
+
+    private:
+    size_t const size; // number of bytes of the serialized value, stored right after the header
+
+    explicit PackedValue(size_t const size_)
+    : size{ size_ }
+    {
+    }
+
+    [[nodiscard]]
+    std::byte* bytes() { return reinterpret_cast<std::byte*>(this + 1); }
+    [[nodiscard]]
+    std::byte const* bytes() const { return reinterpret_cast<std::byte const*>(this + 1); }
+
+    public:
+    // non-copyable, non-movable
+    PackedValue(PackedValue const&) = delete;
+    PackedValue(PackedValue const&&) = delete;
+    PackedValue& operator=(PackedValue const&) = delete;
+    PackedValue& operator=(PackedValue const&&) = delete;
+
+    [[nodiscard]]
+    static int CountAll(PackedValue const* first_);
+    static void FreeAll(Universe* U_, PackedValue* first_);
+    [[nodiscard]]
+    static PackedValue* PackAll(Universe* U_, lua_State* L_, StackIndex first_, int count_);
+    void push(lua_State* L_, LookupMode mode_) const;
+    [[nodiscard]]
+    static size_t SizeAll(PackedValue const* first_);
+};
+
+// #################################################################################################
+
+// a send posted by linda:post(), pending until the holder of the keeper mutex applies it as it releases it
+struct PostedSend
+{
+    PostedSend* next{ nullptr };
+    Linda* linda{ nullptr };
+    PackedValue* values{ nullptr }; // the slot, then the values to send to it
+};
+
+// #################################################################################################
+
 struct Keeper
 {
+    // contention counters, only accessed with the mutex acquired
+    struct Stats
+    {
+        uint64_t acquisitions{};
+        std::chrono::steady_clock::duration waitTime{}; // spent waiting to acquire the mutex
+        std::chrono::steady_clock::duration holdTime{}; // spent with the mutex acquired
+        uint64_t gcSteps{};
+        std::chrono::steady_clock::duration gcTime{}; // spent collecting garbage, included in holdTime
+    };
+
     std::mutex mutex;
     KeeperState K{ static_cast<lua_State*>(nullptr) };
+    Stats stats{};
 
+    private:
+    // beyond that many pending sends, a poster applies the queue itself instead of leaving it to the holder of the mutex
+    static constexpr int kMaxPostsLeftToHolder{ 64 };
+    // sends posted without the mutex, most recent first
+    std::atomic<PostedSend*> posted{ nullptr };
+    // sends posted and not applied yet
+    std::atomic<int> nbPosted{ 0 };
+    // sends taken from 'posted' but not applied yet, oldest first, only accessed with the mutex acquired
+    PostedSend* postedFifo{ nullptr };
+    // the holder of the mutex applies the posted sends when it releases it, see post()
+    // false when the mutex is free, or when its holder releases it without going through unlock() (condition variable waits, cancellation requests)
+    std::atomic<bool> holderApplies{ false };
+    std::chrono::time_point<std::chrono::steady_clock> heldSince{};
+    // consecutive GC cycles that completed with a memory usage above the threshold
+    int gcCyclesOverThreshold{ 0 };
+
+    public:
     ~Keeper() = default;
     Keeper() = default;
     // non-copyable, non-movable
@@ -34,8 +113,31 @@ struct Keeper
     Keeper& operator=(Keeper const&) = delete;
     Keeper& operator=(Keeper const&&) = delete;
 
+    void applyPosted();
+    void discardPosted(Linda const* linda_);
+    // BasicLockable, so that the mutex can be acquired with its contention accounted for
+    void lock();
+    // a condition variable wait releases the mutex: the time spent sleeping doesn't count as held
+    void pauseHold() { stats.holdTime += std::chrono::steady_clock::now() - heldSince; }
     [[nodiscard]]
-    static int PushLindaStorage(Linda& linda_, DestState L_);
+    static int PushLindaStats(Linda& linda_, KeeperIndex keeper_, DestState L_);
+    [[nodiscard]]
+    static int PushLindaStorage(Linda& linda_, KeeperIndex keeper_, DestState L_);
+    void post(PostedSend* post_);
+    void prepareSleep();
+    void pushStats(lua_State* L_) const;
+    void resumeHold()
+    {
+        heldSince = std::chrono::steady_clock::now();
+        holderApplies.store(true, std::memory_order_relaxed);
+    }
+    void stepGarbageCollector(lua_State* L_, int threshold_);
+    [[nodiscard]]
+    bool tryLock();
+    void unlock();
+
+    private:
+    void takePosted();
 };
 
 // #################################################################################################
@@ -92,6 +194,10 @@ using keeper_api_t = lua_CFunction;
 
 // lua_Cfunctions to run inside a keeper state
 [[nodiscard]]
+int keepercall_batch(lua_State* L_);
+[[nodiscard]]
+int keepercall_cas(lua_State* L_);
+[[nodiscard]]
 int keepercall_collectgarbage(lua_State* L_);
 [[nodiscard]]
 int keepercall_count(lua_State* L_);
@@ -100,8 +206,12 @@ int keepercall_destruct(lua_State* L_);
 [[nodiscard]]
 int keepercall_get(lua_State* L_);
 [[nodiscard]]
+int keepercall_incr(lua_State* L_);
+[[nodiscard]]
 int keepercall_limit(lua_State* L_);
 [[nodiscard]]
+int keepercall_post(lua_State* L_);
+[[nodiscard]]
 int keepercall_receive(lua_State* L_);
 [[nodiscard]]
 int keepercall_receive_batched(lua_State* L_);
@@ -110,9 +220,27 @@ int keepercall_restrict(lua_State* L_);
 [[nodiscard]]
 int keepercall_send(lua_State* L_);
 [[nodiscard]]
+int keepercall_send_packed(lua_State* L_);
+[[nodiscard]]
 int keepercall_set(lua_State* L_);
+[[nodiscard]]
+int keepercall_slot_get(lua_State* L_);
+[[nodiscard]]
+int keepercall_slot_pin(lua_State* L_);
+[[nodiscard]]
+int keepercall_slot_receive(lua_State* L_);
+[[nodiscard]]
+int keepercall_slot_send(lua_State* L_);
+[[nodiscard]]
+int keepercall_slot_send_packed(lua_State* L_);
+[[nodiscard]]
+int keepercall_slot_set(lua_State* L_);
+[[nodiscard]]
+int keepercall_slot_unpin(lua_State* L_);
+[[nodiscard]]
+int keepercall_swap(lua_State* L_);
 
 [[nodiscard]]
-KeeperCallResult keeper_call(KeeperState K_, keeper_api_t func_, lua_State* L_, Linda* linda_, StackIndex starting_index_);
+KeeperCallResult keeper_call(Keeper& keeper_, keeper_api_t func_, lua_State* L_, Linda* linda_, StackIndex starting_index_);
 
 LUAG_FUNC(collectgarbage);
@@ -154,7 +154,7 @@ LUAG_FUNC(lane_resume)
     lua_State* const _L2{ _lane->L };
 
     // wait until the lane yields or returns
-    std::ignore = _lane->waitForCompletion(std::chrono::time_point<std::chrono::steady_clock>::max(), true);
+    std::ignore = _lane->waitForCompletion(std::chrono::time_point<std::chrono::steady_clock>::max(), true, kLanePointerRegKey.readLightUserDataValue<Lane>(L_));
 
     if (_lane->status.load(std::memory_order_acquire) != Lane::Suspended) {
         raise_luaL_error(L_, "cannot resume non-suspended coroutine Lane");
@@ -295,6 +295,164 @@ static LUAG_FUNC(lane_index)
     }
 }
 
+// #################################################################################################
+
+namespace {
+    namespace local {
+
+        // the implementation of lanes.wait_any() and lanes.wait_all()
+        // the caller registers a single waiter with all the lanes, and sleeps until enough of them signal their completion
+        [[nodiscard]]
+        static int WaitLanes(lua_State* const L_, bool const all_)
+        {
+            // the timeout is optional, the lanes come next, either in an array or as separate arguments
+            StackIndex _first{ 1 };
+            std::chrono::time_point<std::chrono::steady_clock> _until{ std::chrono::time_point<std::chrono::steady_clock>::max() };
+            if (luaW_type(L_, StackIndex{ 1 }) == LuaType::NUMBER) {
+                lua_Duration const _duration{ lua_tonumber(L_, 1) };
+                if (_duration.count() < 0.0) {
+                    raise_luaL_argerror(L_, StackIndex{ 1 }, "duration cannot be < 0");
+                }
+                _until = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(_duration);
+                _first = StackIndex{ 2 };
+            } else if (lua_isnil(L_, 1) && lua_gettop(L_) > 1) {
+                _first = StackIndex{ 2 };
+            }
+            if (lua_gettop(L_) == _first && lua_istable(L_, _first)) {
+                int const _nbLanes{ static_cast<int>(lua_rawlen(L_, _first)) };
+                luaL_checkstack(L_, _nbLanes + 1, "too many lanes");
+                for (int const _i : std::ranges::iota_view{ 1, _nbLanes + 1 }) {
+                    lua_rawgeti(L_, _first, _i);                                                   // L_: [timeout] {} lane...
+                }
+                lua_remove(L_, _first);                                                            // L_: [timeout] lane...
+            }
+            int const _nbLanes{ lua_gettop(L_) - _first + 1 };
+            luaL_argcheck(L_, _nbLanes > 0, _first, "no lanes to wait for");
+            for (int const _i : std::ranges::iota_view{ 0, _nbLanes }) {
+                std::ignore = ToLane(L_, StackIndex{ _first + _i });
+            }
+
+            // from now on, no error can be raised until all links are removed
+            Lane* const _lane{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
+            std::condition_variable _condVar; // only used when we are not running inside a lane
+            std::mutex _mutex; // ditto
+            Lane::CompletionWaiter _waiter{ (_lane != nullptr) ? _lane->lindaCondVar : _condVar, (_lane != nullptr) ? _lane->lindaMutex : _mutex };
+            int const _expected{ all_ ? _nbLanes : 1 };
+            Lane::CompletionLink* const _links{ static_cast<Lane::CompletionLink*>(lua_newuserdatauv(L_, _nbLanes * sizeof(Lane::CompletionLink), UserValueCount{ 0 })) }; // L_: [timeout] lane... links
+            // register with the lanes, until we know we won't have to wait
+            int _nbLinks{ 0 };
+            int _completed{ 0 };
+            for (; _nbLinks < _nbLanes && _completed < _expected; ++_nbLinks) {
+                Lane::CompletionLink& _link{ *new (&_links[_nbLinks]) Lane::CompletionLink{ &_waiter, nullptr } };
+                if (!ToLane(L_, StackIndex{ _first + _nbLinks })->addCompletionLink(_link)) {
+                    _link.waiter = nullptr;
+                    ++_completed;
+                }
+            }
+
+            bool _done{ false };
+            CancelRequest _cancel{ CancelRequest::None };
+            {
+                std::unique_lock<std::mutex> _guard{ _waiter.mutex };
+                _waiter.completed += _completed;
+                Lane::Status _prev_status{ Lane::Status::Error }; // prevent 'might be used uninitialized' warnings
+                bool _waited{ false };
+                for (;;) {
+                    _done = (_waiter.completed >= _expected);
+                    _cancel = (_lane != nullptr) ? _lane->cancelRequest.load(std::memory_order_relaxed) : CancelRequest::None;
+                    if (_done || _cancel != CancelRequest::None || std::chrono::steady_clock::now() >= _until) {
+                        break;
+                    }
+                    if (_lane != nullptr && !_waited) {
+                        // change status of lane to "waiting"
+                        _prev_status = _lane->status.load(std::memory_order_acquire); // Running, most likely
+                        LUA_ASSERT(L_, _prev_status == Lane::Status::Running); // but check, just in case
+                        _lane->status.store(Lane::Status::Waiting, std::memory_order_release);
+                    }
+                    _waited = true;
+                    // a lane cancelled since its last check doesn't sleep: it tries again, and sees the request
+                    if (_lane == nullptr || _lane->startWaiting(_waiter.condVar, _waiter.mutex)) {
+                        std::ignore = _waiter.condVar.wait_until(_guard, _until);
+                    }
+                    if (_lane != nullptr) {
+                        _lane->stopWaiting();
+                    }
+                }
+                if (_lane != nullptr && _waited) {
+                    _lane->status.store(_prev_status, std::memory_order_release);
+                }
+            }
+
+            for (int const _i : std::ranges::iota_view{ 0, _nbLinks }) {
+                if (_links[_i].waiter != nullptr) {
+                    ToLane(L_, StackIndex{ _first + _i })->removeCompletionLink(_links[_i]);
+                }
+            }
+            lua_pop(L_, 1);                                                                        // L_: [timeout] lane...
+
+            if (_done) {
+                if (all_) {
+                    lua_pushboolean(L_, 1);                                                        // L_: [timeout] lane... true
+                    return 1;
+                }
+                // report the first completed lane in argument order
+                for (int const _i : std::ranges::iota_view{ 0, _nbLanes }) {
+                    if (ToLane(L_, StackIndex{ _first + _i })->isDone()) {
+                        lua_pushinteger(L_, _i + 1);                                               // L_: [timeout] lane... i
+                        lua_pushvalue(L_, _first + _i);                                            // L_: [timeout] lane... i lane
+                        return 2;
+                    }
+                }
+            }
+            switch (_cancel) {
+            case CancelRequest::None:
+                lua_pushnil(L_);
+                luaW_pushstring(L_, "timeout");
+                return 2;
+
+            case CancelRequest::Soft:
+                // if user wants to soft-cancel, the call returns nil, kCancelError
+                lua_pushnil(L_);
+                kCancelError.pushKey(L_);
+                return 2;
+
+            case CancelRequest::Hard:
+                // raise an error interrupting execution only in case of hard cancel
+                raise_cancel_error(L_); // raises an error and doesn't return
+
+            default:
+                raise_luaL_error(L_, "internal error: unknown cancel request");
+            }
+            return 0;
+        }
+
+    } // namespace local
+} // namespace
+
+// #################################################################################################
+
+/*
+ * true|(nil,"timeout")|(nil,lanes.cancel_error) = lanes.wait_all([timeout,] {lane_h, ...}|lane_h, ...)
+ *
+ * Wait until all the lanes are done, in error, or cancelled
+ */
+LUAG_FUNC(wait_all)
+{
+    return local::WaitLanes(L_, true);
+}
+
+// #################################################################################################
+
+/*
+ * (index, lane_h)|(nil,"timeout")|(nil,lanes.cancel_error) = lanes.wait_any([timeout,] {lane_h, ...}|lane_h, ...)
+ *
+ * Wait until one of the lanes is done, in error, or cancelled. Returns the first such lane in argument order, and its position.
+ */
+LUAG_FUNC(wait_any)
+{
+    return local::WaitLanes(L_, false);
+}
+
 // #################################################################################################
 // ######################################## Utilities ##############################################
 // #################################################################################################
@@ -641,7 +799,9 @@ static void PrepareLaneHelpers(Lane* const lane_)
 
 // #################################################################################################
 
-static void lane_main(Lane* const lane_)
+// returns false if the universe was collected while the lane was running, in which case the caller shouldn't touch it either
+[[nodiscard]]
+static bool lane_main(Lane* const lane_)
 {
     // wait until the launching thread has finished preparing L
 #ifndef __PROSPERO__
@@ -684,7 +844,8 @@ static void lane_main(Lane* const lane_)
                         lane_->doneCondVar.notify_one();
                         // wait until the user wants us to resume
                         // update waiting_on, so that the lane can be woken by cancellation requests here
-                        lane_->waiting_on = &lane_->doneCondVar;
+                        // if one was issued in the meantime, the predicate sees it and we won't sleep
+                        std::ignore = lane_->startWaiting(lane_->doneCondVar, lane_->doneMutex);
                         lane_->doneCondVar.wait(_guard,
                             [lane_,&_shouldClose]()
                             {
@@ -695,7 +856,7 @@ static void lane_main(Lane* const lane_)
                             }
                         );
                         // here lane_->doneMutex is locked again
-                        lane_->waiting_on = nullptr;
+                        lane_->stopWaiting();
                         lane_->status.store(Lane::Running, std::memory_order_release); // Resuming -> Running
                     }
                 } else {
@@ -738,7 +899,7 @@ static void lane_main(Lane* const lane_)
         if (lane_->flaggedAfterUniverseGC.load(std::memory_order_relaxed)) {
             // let's try not to crash if the lane didn't terminate gracefully and the Universe met its end
             // there will be leaks, but what else can we do?
-            return;
+            return false;
         }
 
         if (_errorHandlerCount) {
@@ -771,9 +932,14 @@ static void lane_main(Lane* const lane_)
 
             // we destroy ourselves, therefore our thread member too, from inside the thread body
             // detach so that we don't try to join, as this doesn't seem a good idea
-            lane_->thread.detach();
+            if (lane_->onWorker) {
+                // nobody else knows about the lane anymore, and we don't want ~Lane() to wait for ourselves
+                lane_->workerReleased = true;
+            } else {
+                lane_->thread.detach();
+            }
             delete lane_;
-            return;
+            return true;
         }
     } else {
         // some error occurred in lane_new and we don't have anything to do
@@ -784,9 +950,17 @@ static void lane_main(Lane* const lane_)
     // leave results (1..top) or error message + stack trace (1..2) on the stack - master will copy them
     Lane::Status const _st{ (_rc == LuaError::OK) ? Lane::Done : kCancelError.equals(_L, StackIndex{ 1 }) ? Lane::Cancelled : Lane::Error };
     // 'doneMutex' protects the -> Done|Error|Cancelled state change, and the Running|Suspended|Resuming state change too
-    std::lock_guard _guard{ lane_->doneMutex };
-    lane_->status.store(_st, std::memory_order_release);
-    lane_->doneCondVar.notify_one(); // wake up master (while 'lane_->doneMutex' is on)
+    {
+        std::lock_guard _guard{ lane_->doneMutex };
+        lane_->status.store(_st, std::memory_order_release);
+        lane_->doneCondVar.notify_one(); // wake up master (while 'lane_->doneMutex' is on)
+        lane_->signalCompletion(); // and whoever waits for us in lanes.wait_any() or lanes.wait_all()
+    }
+    // the lane can be deleted as soon as the worker lets go of it, so this is the last time we touch it
+    if (lane_->onWorker) {
+        lane_->U->workerPool.release(*lane_);
+    }
+    return true;
 }
 
 // #################################################################################################
@@ -851,7 +1025,7 @@ static LUAG_FUNC(lane_gc)
     } else if (_lane->L) {
         // no longer accessing the Lua VM: we can close right now
         _lane->securizeDebugName(L_);
-        _lane->closeState();
+        _lane->recycleState();
     }
 
     // Clean up after a (finished) thread
@@ -900,6 +1074,8 @@ Lane::~Lane()
     // not necessary when using a jthread
     if (thread.joinable()) {
         thread.join();
+    } else if (onWorker) {
+        U->workerPool.waitForRelease(*this);
     }
     // no longer tracked
     std::ignore = U->tracker.tracking_remove(this);
@@ -907,6 +1083,20 @@ Lane::~Lane()
 
 // #################################################################################################
 
+bool Lane::addCompletionLink(CompletionLink& link_)
+{
+    std::lock_guard _guard{ doneMutex };
+    // the status becomes Done/Error/Cancelled with doneMutex locked: either we see it, or the lane will signal us
+    if (isDone()) {
+        return false;
+    }
+    link_.next = completionLinks;
+    completionLinks = &link_;
+    return true;
+}
+
+// #################################################################################################
+
 void Lane::applyDebugName() const
 {
     if constexpr (HAVE_DECODA_SUPPORT()) {
@@ -959,20 +1149,24 @@ CancelResult Lane::cancel(CancelOp const op_, std::chrono::time_point<std::chron
 [[nodiscard]]
 CancelResult Lane::internalCancel(CancelRequest const rq_, std::chrono::time_point<std::chrono::steady_clock> const until_, WakeLane const wakeLane_)
 {
-    cancelRequest.store(rq_, std::memory_order_relaxed); // it's now signaled to stop
+    // it's now signaled to stop
+    // sequentially consistent with the publication of waitingMutex in startWaiting(): either we see the mutex, or the thread sees the request before it sleeps
+    cancelRequest.store(rq_, std::memory_order_seq_cst);
     if (rq_ == CancelRequest::Hard) {
         // lane_->thread.get_stop_source().request_stop();
     }
     if (wakeLane_ == WakeLane::Yes) { // wake the thread so that execution returns from any pending linda operation if desired
-        auto const _status{ status.load(std::memory_order_acquire) };
-        if (_status == Lane::Waiting || _status == Lane::Suspended) { // waiting_on is updated under control of status acquire/release semantics
-            if (std::condition_variable* const _waiting_on{ waiting_on }) {
-                _waiting_on->notify_all();
+        if (std::mutex* const _mutex{ waitingMutex.load(std::memory_order_seq_cst) }) {
+            // once we hold the mutex, the thread is either asleep, or not yet decided to wait and will see the request
+            std::lock_guard<std::mutex> _guard{ *_mutex };
+            // the thread may have stopped waiting on this mutex while we were acquiring it
+            if (waitingMutex.load(std::memory_order_relaxed) == _mutex) {
+                waiting_on->notify_all();
             }
         }
     }
     // wait until the lane stops working with its state (either Suspended or Done+)
-    CancelResult const result{ waitForCompletion(until_, false) ? CancelResult::Cancelled : CancelResult::Timeout };
+    CancelResult const result{ waitForCompletion(until_, false, nullptr) ? CancelResult::Cancelled : CancelResult::Timeout };
     return result;
 }
 
@@ -1191,6 +1385,47 @@ std::string_view Lane::pushErrorTraceLevel(lua_State* L_) const
 
 // #################################################################################################
 
+// same as closeState(), except that the state of a lane that ended on its own is handed to the state pool if it wants it
+// must be called while the universe is still alive (not from a free-running lane)
+void Lane::recycleState()
+{
+    Status const _status{ status.load(std::memory_order_acquire) };
+    bool const _endedOnItsOwn{ (_status == Lane::Done || _status == Lane::Error) && cancelRequest.load(std::memory_order_relaxed) == CancelRequest::None };
+    if (!_endedOnItsOwn || isCoroutine() || !U->statePool.isEnabled()) {
+        closeState();
+        return;
+    }
+    L = nullptr;
+    nresults = 0;
+    lua_State* const _S{ std::exchange(S, nullptr) };
+    lua_settop(_S, 0);                                                                             // _S:
+    lua_sethook(_S, nullptr, 0, 0);
+    // forget everything that ties the state to this lane
+    kFinalizerRegKey.setValue(_S, [](lua_State* L_) { lua_pushnil(L_); });
+    kStackTraceRegKey.setValue(_S, [](lua_State* L_) { lua_pushnil(L_); });
+    kLaneNameRegKey.setValue(_S, [](lua_State* L_) { lua_pushnil(L_); });
+    kLanePointerRegKey.setValue(_S, [](lua_State* L_) { lua_pushnil(L_); });
+    if (!U->statePool.release(_S)) {
+        lua_close(_S);
+    }
+}
+
+// #################################################################################################
+
+void Lane::removeCompletionLink(CompletionLink& link_)
+{
+    std::lock_guard _guard{ doneMutex };
+    for (CompletionLink** _link{ &completionLinks }; *_link != nullptr; _link = &(*_link)->next) {
+        if (*_link == &link_) {
+            *_link = link_.next;
+            break;
+        }
+    }
+    link_.next = nullptr;
+}
+
+// #################################################################################################
+
 // replace the current uservalue (a table holding the returned values of the lane body)
 // by a new empty one, but transfer the gc_cb that is stored in there so that it is not lost
 void Lane::resetResultsStorage(lua_State* const L_, StackIndex const self_idx_)
@@ -1219,6 +1454,14 @@ void Lane::resetResultsStorage(lua_State* const L_, StackIndex const self_idx_)
 
 // #################################################################################################
 
+// the body of a worker of the pool for one lane
+bool Lane::RunOnWorker(Lane* const lane_)
+{
+    return lane_main(lane_);
+}
+
+// #################################################################################################
+
 // intern the debug name in the caller lua state so that the pointer remains valid after the lane's state is closed
 void Lane::securizeDebugName(lua_State* const L_)
 {
@@ -1239,6 +1482,18 @@ void Lane::securizeDebugName(lua_State* const L_)
 }
 
 // #################################################################################################
+
+void Lane::signalCompletion()
+{
+    for (CompletionLink* _link{ completionLinks }; _link != nullptr; _link = _link->next) {
+        std::lock_guard _guard{ _link->waiter->mutex };
+        ++_link->waiter->completed;
+        _link->waiter->condVar.notify_one();
+    }
+}
+
+// #################################################################################################
+
 void Lane::signalReady(bool const canRun_)
 {
     if (!canRun_) {
@@ -1251,13 +1506,22 @@ void Lane::signalReady(bool const canRun_)
 #else // __PROSPERO__
     ready.test_and_set();
 #endif // __PROSPERO__
+    if (onWorker) {
+        U->workerPool.submit(*this);
+    }
 }
 
 // #################################################################################################
 
 void Lane::startThread(lua_State* const L_, int const priority_, NativePrioFlag native_)
 {
-    thread = std::thread([this]() { lane_main(this); });
+    // a lane that wants a specific priority gets a thread of its own, because it can't be applied to a shared worker
+    if (U->workerPool.isEnabled() && priority_ == kThreadPrioDefault) {
+        // the lane is queued by signalReady(), since a worker could otherwise block until the state is ready
+        onWorker = true;
+        return;
+    }
+    thread = std::thread([this]() { std::ignore = lane_main(this); });
     if (priority_ != kThreadPrioDefault) {
         THREAD_SET_PRIORITY(L_, thread, priority_, native_, U->sudo);
     }
@@ -1265,6 +1529,30 @@ void Lane::startThread(lua_State* const L_, int const priority_, NativePrioFlag
 
 // #################################################################################################
 
+bool Lane::startWaiting(std::condition_variable& condVar_, std::mutex& mutex_)
+{
+    waiting_on = &condVar_;
+    waitingMutex.store(&mutex_, std::memory_order_seq_cst);
+    // let a queued lane run on another worker while we are blocked
+    if (onWorker) {
+        U->workerPool.laneBlocks();
+    }
+    return cancelRequest.load(std::memory_order_seq_cst) == CancelRequest::None;
+}
+
+// #################################################################################################
+
+void Lane::stopWaiting()
+{
+    waitingMutex.store(nullptr, std::memory_order_relaxed);
+    waiting_on = nullptr;
+    if (onWorker) {
+        U->workerPool.laneResumes();
+    }
+}
+
+// #################################################################################################
+
 void Lane::storeDebugName(std::string_view const& name_)
 {
     STACK_CHECK_START_REL(L, 0);
@@ -1373,7 +1661,7 @@ int Lane::storeResults(lua_State* const L_)
         // debugName is a pointer to string possibly interned in the lane's state, that no longer exists when the state is closed
         // so store it in the userdata uservalue at a key that can't possibly collide
         securizeDebugName(L_);
-        closeState();
+        recycleState();
     }
 
     return _stored;
@@ -1423,17 +1711,26 @@ std::string_view Lane::threadStatusString() const
 
 // #################################################################################################
 
-bool Lane::waitForCompletion(std::chrono::time_point<std::chrono::steady_clock> until_, bool const _acceptSuspended)
+bool Lane::waitForCompletion(std::chrono::time_point<std::chrono::steady_clock> until_, bool const _acceptSuspended, Lane* const waiter_)
 {
     std::unique_lock _guard{ doneMutex };
     // std::stop_token token{ thread.get_stop_token() };
     // return doneCondVar.wait_until(lock, token, secs_, [this](){ return status >= Lane::Done; });
 
     // wait until the lane exits lane_main (which is the only place where status can become one of the 3 tested values)
-    return doneCondVar.wait_until(_guard, until_, [this, suspended = _acceptSuspended ? Lane::Suspended : Lane::Done]() {
+    auto const _isCompleted{ [this, suspended = _acceptSuspended ? Lane::Suspended : Lane::Done]() {
         auto const _status{ status.load(std::memory_order_acquire) };
         return _status == Lane::Done || _status == Lane::Error || _status == Lane::Cancelled || _status == suspended;
-    });
+    } };
+    if (waiter_ == nullptr || !waiter_->onWorker || _isCompleted()) {
+        return doneCondVar.wait_until(_guard, until_, _isCompleted);
+    }
+    // a waiting lane running on a pool worker gives its turn to a queued lane, which can be the one it waits for
+    // not through startWaiting(): doneMutex belongs to the lane we wait for, so a cancellation request must not lock it, and it couldn't interrupt this wait anyway
+    U->workerPool.laneBlocks();
+    bool const _completed{ doneCondVar.wait_until(_guard, until_, _isCompleted) };
+    U->workerPool.laneResumes();
+    return _completed;
 }
 
 // #################################################################################################
@@ -1441,9 +1738,10 @@ bool Lane::waitForCompletion(std::chrono::time_point<std::chrono::steady_clock>
 [[nodiscard]]
 bool Lane::waitForJoin(lua_State* const L_, std::chrono::time_point<std::chrono::steady_clock> until_)
 {
+    Lane* const _waiter{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
     // wait until suspended or done
     {
-        bool const _done{ !thread.joinable() || waitForCompletion(until_, true) };
+        bool const _done{ !isStarted() || waitForCompletion(until_, true, _waiter) };
 
         if (!_done) {
             lua_pushnil(L_);                                                                       // L_: lane nil
@@ -1459,7 +1757,7 @@ bool Lane::waitForJoin(lua_State* const L_, std::chrono::time_point<std::chrono:
         doneCondVar.notify_all();
         // wait until done
         {
-            bool const _done{ !thread.joinable() || waitForCompletion(until_, true) };
+            bool const _done{ !isStarted() || waitForCompletion(until_, true, _waiter) };
 
             if (!_done) {
                 lua_pushnil(L_);                                                                   // L_: lane nil
@@ -83,8 +83,29 @@ class Lane final
     };
     using enum ErrorTraceLevel;
 
+    // a thread blocked in lanes.wait_any() or lanes.wait_all(), signalled each time one of the lanes it waits on completes
+    struct CompletionWaiter
+    {
+        std::condition_variable& condVar;
+        // owned by the waiting lane if any, so that it outlives any cancellation request that might lock it
+        std::mutex& mutex;
+        int completed{}; // protected by mutex
+    };
+
+    // registers a CompletionWaiter with one of the lanes it waits on
+    struct CompletionLink
+    {
+        CompletionWaiter* waiter{ nullptr };
+        CompletionLink* next{ nullptr };
+    };
+
     // the thread
     std::thread thread; // use jthread if we ever need a stop_source
+    // true when the lane runs on a worker of the universe's WorkerPool instead of 'thread'
+    bool onWorker{ false };
+    // protected by the WorkerPool mutex
+    Lane* nextQueued{ nullptr };
+    bool workerReleased{ false }; // the worker is done with the lane, which can be deleted
 #ifndef __PROSPERO__
     // a latch to wait for the lua_State to be ready
     std::latch ready{ 1 };
@@ -119,9 +140,17 @@ class Lane final
     // M: sets to Pending (before launching)
     // S: updates -> Running/Waiting/Suspended -> Done/Error/Cancelled
 
-    // accessed under control of status acquire/release semantics
-    // When status is Waiting, points on the linda's signal the thread waits on, else nullptr
+    // When the thread is blocked (status Waiting or Suspended), points on the signal it waits on, else nullptr
+    // only modified with *waitingMutex locked, so that a cancel request can't signal it between the moment the thread checks for cancellation and the moment it actually sleeps
     std::condition_variable* waiting_on{ nullptr };
+    // the mutex the thread holds while it decides to wait on waiting_on: a keeper's or one owned by the lane, so it outlives any cancellation request that might lock it
+    std::atomic<std::mutex*> waitingMutex{ nullptr };
+
+    // the signal the lane waits on when blocked inside a linda operation (see Linda::Waiter)
+    // owned by the lane so that it outlives any cancellation request that might signal it
+    std::condition_variable lindaCondVar;
+    // the mutex of lindaCondVar when the lane doesn't sleep on a keeper mutex (see lanes.select() and the synchronization primitives)
+    std::mutex lindaMutex;
 
     std::atomic<CancelRequest> cancelRequest{ CancelRequest::None };
     static_assert(std::atomic<CancelRequest>::is_always_lock_free);
@@ -139,6 +168,12 @@ class Lane final
     // access is protected by LaneTracker::trackingMutex
     Lane* tracking_next{ nullptr };
 
+    // access is protected by doneMutex
+    CompletionLink* completionLinks{ nullptr };
+    //
+    // M: links and unlinks the waiters of lanes.wait_any() and lanes.wait_all()
+    // S: signals them when the status becomes Done/Error/Cancelled
+
     ErrorTraceLevel const errorTraceLevel{ Basic };
 
     // when Universe is collected, and an uncooperative Lane refuses to terminate, this flag becomes true
@@ -168,6 +203,9 @@ class Lane final
 
     public:
 
+    // returns false if the lane already completed, in which case link_ is not registered
+    [[nodiscard]]
+    bool addCompletionLink(CompletionLink& link_);
     void applyDebugName() const;
     [[nodiscard]]
     CancelResult cancel(CancelOp op_, std::chrono::time_point<std::chrono::steady_clock> until_, WakeLane wakeLane_, int hookCount_);
@@ -188,6 +226,14 @@ class Lane final
     [[nodiscard]]
     bool isCoroutine() const noexcept { return S != L; }
     [[nodiscard]]
+    bool isStarted() const noexcept { return onWorker || thread.joinable(); }
+    [[nodiscard]]
+    bool isDone() const
+    {
+        Status const _status{ status.load(std::memory_order_acquire) };
+        return _status == Lane::Done || _status == Lane::Error || _status == Lane::Cancelled;
+    }
+    [[nodiscard]]
     std::string_view getDebugName() const
     {
         std::lock_guard<std::mutex> _guard{ debugNameMutex };
@@ -200,24 +246,37 @@ class Lane final
     std::string_view pushErrorTraceLevel(lua_State* L_) const;
     static void PushMetatable(lua_State* L_);
     void pushStatusString(lua_State* L_) const;
+    void removeCompletionLink(CompletionLink& link_);
     void pushIndexedResult(lua_State* L_, int key_) const;
     [[nodiscard]]
     int pushStoredResults(lua_State* L_) const;
+    void recycleState();
     void resetResultsStorage(lua_State* L_, StackIndex self_idx_);
+    [[nodiscard]]
+    static bool RunOnWorker(Lane* lane_);
     void selfdestructAdd();
     [[nodiscard]]
     bool selfdestructRemove();
     void securizeDebugName(lua_State* L_);
+    // in: doneMutex is locked
+    void signalCompletion();
     void signalReady(bool const canRun_);
     void startThread(lua_State* L_, int priority_, NativePrioFlag native_);
     void storeDebugName( std::string_view const& name_);
     [[nodiscard]]
     int storeResults(lua_State* L_);
+    // in: mutex_ is locked
+    // publish the signal the thread is about to wait on, so that cancel requests can wake it
+    // returns false if the lane was cancelled in the meantime, in which case the thread should not wait at all
+    [[nodiscard]]
+    bool startWaiting(std::condition_variable& condVar_, std::mutex& mutex_);
+    // in: the mutex provided to startWaiting() is locked
+    void stopWaiting();
     [[nodiscard]]
     std::string_view threadStatusString() const;
-    // wait until the lane stops working with its state (either Suspended or Done+)
+    // wait until the lane stops working with its state (either Suspended or Done+), waiter_ is the lane that waits, if any
     [[nodiscard]]
-    bool waitForCompletion(std::chrono::time_point<std::chrono::steady_clock> until_, bool const _acceptSuspended);
+    bool waitForCompletion(std::chrono::time_point<std::chrono::steady_clock> until_, bool const _acceptSuspended, Lane* waiter_);
     [[nodiscard]]
     bool waitForJoin(lua_State* _L, std::chrono::time_point<std::chrono::steady_clock> until_);
 };
@@ -257,6 +257,17 @@ LUAG_FUNC(thread_priority_range)
 
 // #################################################################################################
 
+// nb = hardware_concurrency()
+// used by lanes.parallel_for() and lanes.map() to pick a default number of worker lanes
+LUAG_FUNC(hardware_concurrency)
+{
+    // hardware_concurrency() can be 0 when it can't tell
+    lua_pushinteger(L_, static_cast<lua_Integer>(std::max(std::thread::hardware_concurrency(), 1u)));
+    return 1;
+}
+
+// #################################################################################################
+
 namespace {
     namespace local {
         struct LanePriority
@@ -302,6 +313,46 @@ namespace {
             LUA_ASSERT(L_, _ret == InterCopyResult::Success); // either all went well, or we should not even get here
         }
 
+        // Push the string that identifies the initialization steps of a lane state in the state pool: the libraries, then the required modules
+        // Returns false (and pushes nothing) if the required list isn't something the key can describe, in which case the state is not pooled
+        [[nodiscard]]
+        static bool PushStatePoolKey(lua_State* const L_, StackIndex const libsIdx_, StackIndex const requiredIdx_)
+        {
+            STACK_GROW(L_, 3);
+            STACK_CHECK_START_REL(L_, 0);
+            if (lua_isnil(L_, libsIdx_)) {
+                luaW_pushstring(L_, "");                                                           // L_: [fixed] args... ""
+            } else {
+                luaW_pushstring(L_, "=");                                                          // L_: [fixed] args... "="
+                lua_pushvalue(L_, libsIdx_);                                                       // L_: [fixed] args... "=" libs
+                lua_concat(L_, 2);                                                                 // L_: [fixed] args... "=libs"
+            }
+            if (!lua_isnoneornil(L_, requiredIdx_)) {
+                if (!lua_istable(L_, requiredIdx_)) {
+                    lua_pop(L_, 1);                                                                // L_: [fixed] args...
+                    STACK_CHECK(L_, 0);
+                    return false;
+                }
+                for (int _i{ 1 };; ++_i) {
+                    lua_rawgeti(L_, requiredIdx_, _i);                                             // L_: [fixed] args... "key" "modname"|nil
+                    if (lua_isnil(L_, -1)) {
+                        lua_pop(L_, 1);                                                            // L_: [fixed] args... "key"
+                        break;
+                    }
+                    if (luaW_type(L_, kIdxTop) != LuaType::STRING) {
+                        lua_pop(L_, 2);                                                            // L_: [fixed] args...
+                        STACK_CHECK(L_, 0);
+                        return false;
+                    }
+                    luaW_pushstring(L_, "\n");                                                    // L_: [fixed] args... "key" "modname" "\n"
+                    lua_insert(L_, -2);                                                            // L_: [fixed] args... "key" "\n" "modname"
+                    lua_concat(L_, 3);                                                             // L_: [fixed] args... "key"
+                }
+            }
+            STACK_CHECK(L_, 1);
+            return true;
+        }
+
         // require() each module listed in requiredIdx_ inside the lane state, then register its
         // exported functions in the lookup table. No-op when requiredIdx_ is nil/none.
         static void RequireModulesInLane(Universe* const U_, lua_State* const L_, lua_State* const L2_, StackIndex const requiredIdx_)
@@ -528,13 +579,26 @@ LUAG_FUNC(lane_new)
         // Get priority early, because it can fail by raising an error
         auto const [_priority, _native]{ local::ResolveLanePriority(L_, kPrinIdx, kPrioIdx) };
 
-        std::optional<std::string_view> _libs_str{ lua_isnil(L_, kLibsIdx) ? std::nullopt : std::make_optional(luaW_tostring(L_, kLibsIdx)) };
-        lua_State* const _S{ state::NewLaneState(_U, SourceState{ L_ }, _libs_str) };                  // L_: [fixed] ...                                L2:
-        STACK_CHECK_START_REL(_S, 0);
-
         Lane::ErrorTraceLevel const _errorTraceLevel{ static_cast<Lane::ErrorTraceLevel>(lua_tointeger(L_, kErTlIdx)) };
         bool const _asCoroutine{ lua_toboolean(L_, kCoroIdx) ? true : false };
 
+        // a coroutine lane doesn't give its state back to the pool, so don't bother preparing it for reuse
+        bool const _poolable{ !_asCoroutine && _U->statePool.isEnabled() && local::PushStatePoolKey(L_, kLibsIdx, kRequIdx) }; // L_: [fixed] ... "key"?
+        // a state acquired from the pool already went through the library opening and the requires
+        lua_State* _S{ _poolable ? _U->statePool.acquire(luaW_tostring(L_, kIdxTop)) : nullptr };
+        bool const _reused{ _S != nullptr };
+        if (!_reused) {
+            std::optional<std::string_view> _libs_str{ lua_isnil(L_, kLibsIdx) ? std::nullopt : std::make_optional(luaW_tostring(L_, kLibsIdx)) };
+            _S = state::NewLaneState(_U, SourceState{ L_ }, _libs_str);                            // L_: [fixed] ... "key"?                         L2:
+            if (_poolable) {
+                StatePool::Prepare(_S, luaW_tostring(L_, kIdxTop));
+            }
+        }
+        if (_poolable) {
+            lua_pop(L_, 1);                                                                        // L_: [fixed] ...
+        }
+        STACK_CHECK_START_REL(_S, 0);
+
         // 'lane' is allocated from heap, not Lua, since its life span may surpass the handle's (if free running thread)
         Lane* const _lane{ new (_U) Lane{ _U, _S, _errorTraceLevel, _asCoroutine } };
         if (_lane == nullptr) {
@@ -569,7 +633,12 @@ LUAG_FUNC(lane_new)
         STACK_CHECK(_L2, 0);
 
         // modules to require in the target lane *before* the function is transfered!
-        local::RequireModulesInLane(_U, L_, _L2, kRequIdx);
+        if (!_reused) {
+            local::RequireModulesInLane(_U, L_, _L2, kRequIdx);
+            if (_poolable) {
+                StatePool::SnapshotGlobals(_L2);
+            }
+        }
         STACK_CHECK(L_, 0);
         STACK_CHECK(_L2, 0);                                                                       // L_: [fixed] args...                            L2:
 
@@ -711,23 +780,40 @@ LUAG_FUNC(wakeup_conv)
 // ######################################## Module linkage #########################################
 // #################################################################################################
 
+extern LUAG_FUNC(barrier);
+extern LUAG_FUNC(blob);
+extern LUAG_FUNC(latch);
 extern LUAG_FUNC(linda);
+extern LUAG_FUNC(mutex);
+extern LUAG_FUNC(select);
+extern LUAG_FUNC(semaphore);
+extern LUAG_FUNC(wait_all);
+extern LUAG_FUNC(wait_any);
 
 namespace {
     namespace local {
         static struct luaL_Reg const sLanesFunctions[] = {
+            { "barrier", LG_barrier },
+            { "blob", LG_blob },
             { "collectgarbage", LG_collectgarbage }, 
             { Universe::kFinally, Universe::InitializeFinalizer },
+            { "hardware_concurrency", LG_hardware_concurrency },
+            { "latch", LG_latch },
             { "linda", LG_linda },
+            { "mutex", LG_mutex },
             { "nameof", LG_nameof },
             { "thread_priority_range", LG_thread_priority_range },
             { "now_secs", LG_now_secs },
             { "register", lanes_register },
+            { "select", LG_select },
+            { "semaphore", LG_semaphore },
             { "set_singlethreaded", LG_set_singlethreaded },
             { "set_thread_priority", LG_set_thread_priority },
             { "set_thread_affinity", LG_set_thread_affinity },
             { "sleep", LG_sleep },
             { "supported_libs", state::LG_supported_libs },
+            { "wait_all", LG_wait_all },
+            { "wait_any", LG_wait_any },
             { "wakeup_conv", LG_wakeup_conv },
             { nullptr, nullptr }
         };
@@ -100,10 +100,14 @@ local default_params =
     -- it looks also like LuaJIT allocator may not appreciate direct use of its allocator for other purposes than the VM operation
     internal_allocator = isLuaJIT and "libc" or "allocator",
     keepers_gc_threshold = -1,
+    linda_spin = 0,
     linda_wake_period = 'never',
+    max_running = 0,
     nb_user_keepers = 0,
     on_state_create = nil,
     shutdown_timeout = 0.25,
+    state_pool = 0,
+    state_pool_scrub = "globals",
     strip_functions = true,
     track_lanes = false,
     verbose_errors = false,
@@ -163,6 +167,16 @@ local param_checkers =
         end
         return true
     end,
+    linda_spin = function(val_)
+        -- linda_spin should be a number >= 0
+        if type(val_) ~= "number" then
+            return nil, "not a number"
+        end
+        if val_ < 0 then
+            return nil, "value out of range"
+        end
+        return true
+    end,
     linda_wake_period = function(val_)
         -- linda_wake_period should be a number > 0, or the string 'never'
         if val_ == 'never' then
@@ -176,6 +190,19 @@ local param_checkers =
         end
         return true
     end,
+    max_running = function(val_)
+        -- max_running should be "auto" or an integer in [0,1000] (0 means a thread per lane)
+        if val_ == "auto" then
+            return true
+        end
+        if type(val_) ~= "number" or val_ % 1 ~= 0 then
+            return nil, "not an integer"
+        end
+        if val_ < 0 or val_ > 1000 then
+            return nil, "value out of range"
+        end
+        return true
+    end,
     nb_user_keepers = function(val_)
         -- nb_user_keepers should be a number in [0,100] (so that nobody tries to run OOM by specifying a huge amount)
         if type(val_) ~= "number" then
@@ -203,6 +230,23 @@ local param_checkers =
         end
         return true
     end,
+    state_pool = function(val_)
+        -- state_pool should be an integer in [0,1000] (so that nobody tries to run OOM by specifying a huge amount)
+        if type(val_) ~= "number" or val_ % 1 ~= 0 then
+            return nil, "not an integer"
+        end
+        if val_ < 0 or val_ > 1000 then
+            return nil, "value out of range"
+        end
+        return true
+    end,
+    state_pool_scrub = function(val_)
+        -- can be "globals" or "none"
+        if val_ ~= "globals" and val_ ~= "none" then
+            return nil, "unknown value"
+        end
+        return true
+    end,
     strip_functions = boolean_param_checker,
     track_lanes = boolean_param_checker,
     verbose_errors = boolean_param_checker,
@@ -827,35 +871,221 @@ end -- genlock
 -- number in 'key'.
 --
 local genatomic = function(linda_, key_, initial_val_)
-    -- clears existing data (also queue). the slot may contain the stored value, and an additional boolean value
-    local _status, _err = linda_:limit(key_, 2)
-    if _err == cancel_error then
-        return cancel_error
-    end
+    -- clears existing data (also queue)
     local _status, _err = linda_:set(key_, initial_val_ or 0.0)
     if _err == cancel_error then
         return cancel_error
     end
 
     return function(diff_)
-        -- 'nil' allows 'key_' to be numeric
-        -- suspends until our 'true' is in
-        local _res, _err = linda_:send(nil, key_, true)
+        -- a single keeper operation, no lock token needed
+        local _val, _err = linda_:incr(key_, diff_ or 1.0)
         if _err == cancel_error then
             return cancel_error
         end
-        local _, val = linda_:get(key_)
-        if val ~= cancel_error then
-            val = val + (diff_ or 1.0)
-            -- set() releases the lock by emptying queue
-            local _res, _err = linda_:set(key_, val)
-            if _err == cancel_error then
-                val = cancel_error
+        return _val
+    end
+end -- genatomic
+
+-- #################################################################################################
+-- ############################### lanes.parallel_for(), lanes.map() ###############################
+-- #################################################################################################
+
+-- initialized in configure()
+local core_linda, hardware_concurrency
+
+-- the worker lanes receive the body as an argument: it is transferred once per worker, not once per item
+-- their functions must not have upvalues, else these would be transferred too
+
+-- hands out chunks of indices with a shared counter, so that faster workers process more chunks
+local parallel_for_worker = function(linda_, n_, chunk_, body_)
+    local _out = {}
+    repeat
+        local _last, _err = linda_:incr("next", chunk_)
+        if _last == nil then
+            return nil, _err
+        end
+        -- the counter overshoots n_ once all chunks are claimed
+        for _i = _last - chunk_ + 1, (_last < n_) and _last or n_ do
+            _out[_i] = body_(_i)
+        end
+    until _last >= n_
+    return _out
+end -- parallel_for_worker
+
+-- the chunks were all queued before the workers started, so an empty queue means the job is done
+local map_worker = function(linda_, fn_)
+    local _out = {}
+    repeat
+        local _k, _chunk = linda_:receive(0, "chunks")
+        if _k == nil then
+            if _chunk == "timeout" then
+                return _out
+            end
+            return nil, _chunk
+        end
+        -- _chunk = {first index, count, values...}
+        local _first = _chunk[1]
+        for _j = 1, _chunk[2] do
+            local _i = _first + _j - 1
+            _out[_i] = fn_(_chunk[_j + 2], _i)
+        end
+    until false
+end -- map_worker
+
+-- #################################################################################################
+
+-- split the options between the job ones and the lane generator ones
+local parallel_options = function(n_, opts_)
+    local _workers, _chunk, _libs = hardware_concurrency, nil, "*"
+    local _gen_opts = {}
+    if opts_ ~= nil then
+        if type(opts_) ~= "table" then
+            error("Bad argument #3: options table expected, got " .. type(opts_), 3)
+        end
+        for k, v in pairs(opts_) do
+            if k == "workers" then
+                if type(v) ~= "number" or v < 1 or v % 1 ~= 0 then
+                    error("Bad 'workers' option: positive integer expected", 3)
+                end
+                _workers = v
+            elseif k == "chunk" then
+                if type(v) ~= "number" or v < 1 or v % 1 ~= 0 then
+                    error("Bad 'chunk' option: positive integer expected", 3)
+                end
+                _chunk = v
+            elseif k == "libs" then
+                _libs = v
+            else
+                _gen_opts[k] = v
             end
         end
-        return val
     end
-end -- genatomic
+    if not _chunk then
+        -- several chunks per worker so that the load balances, but not so many that the keeper becomes the bottleneck
+        _chunk = n_ / (_workers * 4)
+        _chunk = _chunk - _chunk % 1
+        if _chunk < 1 then
+            _chunk = 1
+        end
+    end
+    -- no need for more workers than chunks
+    local _nb_chunks = (n_ + _chunk - 1) / _chunk
+    _nb_chunks = _nb_chunks - _nb_chunks % 1
+    if _workers > _nb_chunks then
+        _workers = _nb_chunks
+    end
+    return _workers, _chunk, _libs, _gen_opts
+end -- parallel_options
+
+-- #################################################################################################
+
+-- join all workers, merging their results. abort_ makes the remaining workers stop early when one fails
+local parallel_gather = function(handles_, n_, abort_)
+    local _results = {}
+    local _err
+    for _w = 1, #handles_ do
+        -- true, out | true, nil, cancel_error | nil, err, stack_tbl
+        local _ok, _out, _e = handles_[_w]:join()
+        if _ok == nil then
+            -- the worker raised an error: _out is the error
+            if _err == nil then
+                _err = _out
+                abort_()
+            end
+        elseif _out == nil then
+            -- the worker stopped because its linda operation was cancelled
+            if _err == nil then
+                _err = _e
+                abort_()
+            end
+        elseif _err == nil and type(_out) == "table" then
+            for _i, _v in pairs(_out) do
+                _results[_i] = _v
+            end
+        end
+    end
+    if _err == cancel_error then
+        return nil, cancel_error
+    elseif _err ~= nil then
+        error(_err, 0)
+    end
+    return _results, n_
+end -- parallel_gather
+
+-- #################################################################################################
+
+-- results_tbl, n|(nil,cancel_error) = lanes.parallel_for(n, body_func [, opt_tbl])
+--
+-- Calls body_func(i) for i in [1,n] on a fixed set of worker lanes, and returns results_tbl[i] = body_func(i)
+--
+-- 'opt': .workers: number of worker lanes (default: number of hardware threads)
+--        .chunk:   number of consecutive indices a worker claims at once (default: about 4 chunks per worker)
+--        .libs:    libraries to open in the workers (default: "*")
+--        ... any other lanes.gen() option ...
+--
+local parallel_for = function(n_, body_, opts_)
+    if type(n_) ~= "number" or n_ < 0 or n_ % 1 ~= 0 then
+        error("Bad argument #1: non-negative integer expected", 2)
+    end
+    if type(body_) ~= "function" then
+        error("Bad argument #2: function expected, got " .. type(body_), 2)
+    end
+    local _workers, _chunk, _libs, _gen_opts = parallel_options(n_, opts_)
+    if n_ == 0 then
+        return {}, 0
+    end
+    local _linda = core_linda{name = "parallel_for"}
+    local _worker_gen = gen(_libs, _gen_opts, parallel_for_worker)
+    local _handles = {}
+    for _w = 1, _workers do
+        _handles[_w] = _worker_gen(_linda, n_, _chunk, body_)
+    end
+    return parallel_gather(_handles, n_, function()
+        -- exhaust the counter so that the remaining workers stop after their current chunk
+        _linda:set("next", n_)
+    end)
+end -- parallel_for
+
+-- #################################################################################################
+
+-- results_tbl, n|(nil,cancel_error) = lanes.map(array_tbl, func [, opt_tbl])
+--
+-- Calls func(array_tbl[i], i) for i in [1,#array_tbl] on a fixed set of worker lanes, and returns results_tbl[i] = func(array_tbl[i], i)
+-- The options are the same as those of lanes.parallel_for()
+--
+local map = function(array_, fn_, opts_)
+    if type(array_) ~= "table" then
+        error("Bad argument #1: table expected, got " .. type(array_), 2)
+    end
+    if type(fn_) ~= "function" then
+        error("Bad argument #2: function expected, got " .. type(fn_), 2)
+    end
+    local _n = #array_
+    local _workers, _chunk, _libs, _gen_opts = parallel_options(_n, opts_)
+    if _n == 0 then
+        return {}, 0
+    end
+    -- each item is copied once into the linda, then once into the worker that picks its chunk
+    local _linda = core_linda{name = "map"}
+    for _first = 1, _n, _chunk do
+        local _count = (_first + _chunk - 1 > _n) and (_n - _first + 1) or _chunk
+        local _c = { _first, _count }
+        for _j = 1, _count do
+            _c[_j + 2] = array_[_first + _j - 1]
+        end
+        _linda:send("chunks", _c)
+    end
+    local _worker_gen = gen(_libs, _gen_opts, map_worker)
+    local _handles = {}
+    for _w = 1, _workers do
+        _handles[_w] = _worker_gen(_linda, fn_)
+    end
+    return parallel_gather(_handles, _n, function()
+        -- drop the chunks nobody picked yet
+        _linda:set("chunks")
+    end)
+end -- map
 
 -- #################################################################################################
 -- ################################## lanes.configure() ############################################
@@ -890,6 +1120,8 @@ local configure = function(settings_)
     cancel_error = assert(core.cancel_error)
     supported_libs = assert(core.supported_libs())
     timerLinda = assert(core.timerLinda)
+    core_linda = assert(core.linda)
+    hardware_concurrency = assert(core.hardware_concurrency())
     min_prio, max_prio = core.thread_priority_range("mapped")
 
     if settings.with_timers then
@@ -897,26 +1129,36 @@ local configure = function(settings_)
     end
 
     -- activate full interface
+    lanes.barrier = core.barrier
+    lanes.blob = core.blob
     lanes.cancel_error = core.cancel_error
     lanes.collectgarbage = core.collectgarbage
     lanes.finally = core.finally
+    lanes.latch = core.latch
     lanes.linda = core.linda
+    lanes.mutex = core.mutex
     lanes.nameof = core.nameof
     lanes.now_secs = core.now_secs
     lanes.null = core.null
     lanes.register = core.register
     lanes.require = core.require
+    lanes.select = core.select
+    lanes.semaphore = core.semaphore
     lanes.set_singlethreaded = core.set_singlethreaded
     lanes.set_thread_affinity = core.set_thread_affinity
     lanes.set_thread_priority = core.set_thread_priority
     lanes.sleep = core.sleep
     lanes.thread_priority_range = core.thread_priority_range
     lanes.threads = core.threads or function() error "lane tracking is not available" end -- core.threads isn't registered if settings.track_lanes is false
+    lanes.wait_all = core.wait_all
+    lanes.wait_any = core.wait_any
 
     lanes.gen = gen
     lanes.coro = coro
     lanes.genatomic = genatomic
     lanes.genlock = genlock
+    lanes.map = map
+    lanes.parallel_for = parallel_for
     lanes.timer = timer
     lanes.timer_lane = timer_lane
     lanes.timers = timers
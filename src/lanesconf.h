@@ -51,3 +51,10 @@
 
 #define USE_DEBUG_SPEW() 0
 #define HAVE_DECODA_SUPPORT() 0
+// copy lists of nil, booleans, numbers, strings and light userdata without the cache table, see InterCopyContext::interCopy()
+// LANES_NO_SCALAR_COPY_PATH can be provided externally to measure what it saves with tests/scalar_ops.lua ('make scalar_ops-compare')
+#ifdef LANES_NO_SCALAR_COPY_PATH
+#define USE_SCALAR_COPY_PATH() 0
+#else // LANES_NO_SCALAR_COPY_PATH
+#define USE_SCALAR_COPY_PATH() 1
+#endif // LANES_NO_SCALAR_COPY_PATH
@@ -37,6 +37,14 @@ THE SOFTWARE.
 #include "lindafactory.hpp"
 #include "tools.hpp"
 
+#ifdef PLATFORM_LINUX
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif // PLATFORM_LINUX
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
 // #################################################################################################
 // #################################################################################################
 namespace {
@@ -125,43 +133,150 @@ namespace {
 
     // #############################################################################################
 
+    // the index of the first slot of linda:send() and linda:receive(), that can be preceded by a timeout
+    [[nodiscard]]
+    static StackIndex FirstSlotIndex(lua_State* const L_)
+    {
+        // we don't want to use lua_isnumber() because of autocoercion
+        // nil is an alternate explicit "infinite timeout" before the slot
+        LuaType const _type{ luaW_type(L_, StackIndex{ 2 }) };
+        return StackIndex{ (_type == LuaType::NUMBER || _type == LuaType::NIL) ? 3 : 2 };
+    }
+
+    // #############################################################################################
+
     // a helper to process the timeout argument of linda:send() and linda:receive()
     [[nodiscard]]
     static auto ProcessTimeoutArg(lua_State* const L_)
     {
-        StackIndex _key_i{ 2 }; // index of first slot, if timeout not there
+        StackIndex const _key_i{ FirstSlotIndex(L_) };
 
         std::chrono::time_point<std::chrono::steady_clock> _until{ std::chrono::time_point<std::chrono::steady_clock>::max() };
-        if (luaW_type(L_, StackIndex{ 2 }) == LuaType::NUMBER) { // we don't want to use lua_isnumber() because of autocoercion
+        if (luaW_type(L_, StackIndex{ 2 }) == LuaType::NUMBER) {
             lua_Duration const _duration{ lua_tonumber(L_, 2) };
             if (_duration.count() >= 0.0) {
                 _until = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(_duration);
             } else {
                 raise_luaL_argerror(L_, StackIndex{ 2 }, "duration cannot be < 0");
             }
-            ++_key_i;
-        } else if (lua_isnil(L_, 2)) { // alternate explicit "infinite timeout" by passing nil before the slot
-            ++_key_i;
         }
         return std::make_pair(_key_i, _until);
     }
 
     // #############################################################################################
-    static bool WaitInternal([[maybe_unused]] lua_State* const L_, Lane* const lane_, Linda* const linda_, Keeper* const keeper_, std::condition_variable& waitingOn_, std::chrono::time_point<std::chrono::steady_clock> until_)
+
+    // move the contents of the table at the top of the stack into the one below it, then pop it
+    static void MergeTables(lua_State* const L_)
+    {
+        STACK_GROW(L_, 3);
+        STACK_CHECK_START_REL(L_, 0);                                                              // L_: out t
+        lua_pushnil(L_);                                                                           // L_: out t nil
+        while (lua_next(L_, -2)) {                                                                 // L_: out t k v
+            lua_pushvalue(L_, -2);                                                                 // L_: out t k v k
+            lua_insert(L_, -2);                                                                    // L_: out t k k v
+            lua_rawset(L_, -5);                                                                    // L_: out t k
+        }                                                                                          // L_: out t
+        lua_pop(L_, 1);                                                                            // L_: out
+        STACK_CHECK(L_, -1);
+    }
+
+    // #############################################################################################
+
+    // a file descriptor for Linda::Notifier, created readable so that data written before it existed is not missed
+    // returns -1 if the platform has no support for it
+    [[nodiscard]]
+    static int CreateNotifierFd()
+    {
+#ifdef PLATFORM_LINUX
+        return eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+#else // PLATFORM_LINUX
+        return -1;
+#endif // PLATFORM_LINUX
+    }
+
+    // #############################################################################################
+
+    static void CloseNotifierFd([[maybe_unused]] int const fd_)
     {
-        Lane::Status _prev_status{ Lane::Error }; // prevent 'might be used uninitialized' warnings
+#ifdef PLATFORM_LINUX
+        close(fd_);
+#endif // PLATFORM_LINUX
+    }
+
+    // #############################################################################################
+
+    // make the file descriptor readable, until it is read by the application
+    static void SignalNotifierFd([[maybe_unused]] int const fd_)
+    {
+#ifdef PLATFORM_LINUX
+        // can only fail if the counter is about to overflow, in which case the descriptor is readable anyway
+        [[maybe_unused]] int const _ret{ eventfd_write(fd_, 1) };
+#endif // PLATFORM_LINUX
+    }
+
+    // #############################################################################################
+
+    // tell the CPU we are busy-waiting, so that it can save power and give resources to its sibling hyperthread
+    static inline void CpuRelax()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+        __yield();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    // #############################################################################################
+
+    // the contents of a slot were replaced like linda:set() does: tell readers that they should wake, and writers too if it was full
+    // to be done from within the 'K' locking area
+    static void WakeAfterReplace(Linda* const linda_, LindaSlotId const slot_, bool const wasFull_)
+    {
+        linda_->wakeWaiters(Linda::Waiter::Kind::Reader, slot_, Linda::WakeMode::All);
+        if (wasFull_) {
+            linda_->wakeWaiters(Linda::Waiter::Kind::Writer, slot_, Linda::WakeMode::All);
+        }
+    }
+
+    // #############################################################################################
+
+    // register the slots found in [first_, last_] on the waiter, or none (meaning 'any slot') if there are too many of them
+    static void SetWaiterSlots(lua_State* const L_, Linda::Waiter& waiter_, StackIndex const first_, StackIndex const last_)
+    {
+        int const _count{ last_ - first_ + 1 };
+        if (_count < 1 || _count > static_cast<int>(Linda::Waiter::kMaxSlots)) {
+            waiter_.nbSlots = 0;
+            return;
+        }
+        for (int const _i : std::ranges::iota_view{ 0, _count }) {
+            waiter_.slots[_i] = Linda::SlotId(L_, StackIndex{ first_ + _i });
+        }
+        waiter_.nbSlots = static_cast<size_t>(_count);
+    }
+
+    // #############################################################################################
+
+    // flag the lane as waiting while wait_ sleeps, at most until the next time we must check for cancel requests
+    // wait_ publishes what it sleeps on with Lane::startWaiting(), so that cancel requests wake it: the wake period is only a safety net the user can opt into
+    // wait_ returns true if the operation should be tried again
+    template <typename WAIT>
+    static bool WaitWithLane([[maybe_unused]] lua_State* const L_, Lane* const lane_, lua_Duration const wakePeriod_, std::chrono::time_point<std::chrono::steady_clock> until_, WAIT&& wait_)
+    {
+        Lane::Status _prev_status{ Lane::Status::Error }; // prevent 'might be used uninitialized' warnings
         if (lane_ != nullptr) {
             // change status of lane to "waiting"
             _prev_status = lane_->status.load(std::memory_order_acquire); // Running, most likely
-            LUA_ASSERT(L_, _prev_status == Lane::Running); // but check, just in case
+            LUA_ASSERT(L_, _prev_status == Lane::Status::Running); // but check, just in case
             LUA_ASSERT(L_, lane_->waiting_on == nullptr);
-            lane_->waiting_on = &waitingOn_;
-            lane_->status.store(Lane::Waiting, std::memory_order_release);
+            lane_->status.store(Lane::Status::Waiting, std::memory_order_release);
         }
 
-        // wait until the final target date by small increments, interrupting regularly so that we can check for cancel requests,
-        // in case some timing issue caused a cancel request to be issued, and the condvar signalled, before we actually wait for it
-        auto const [_forceTryAgain, _until_check_cancel] = std::invoke([until_, wakePeriod = linda_->getWakePeriod()] {
+        // wait until the final target date, or by small increments if the linda has a wake period
+        auto const [_forceTryAgain, _until_check_cancel] = std::invoke([until_, wakePeriod = wakePeriod_] {
             auto _until_check_cancel{ std::chrono::time_point<std::chrono::steady_clock>::max() };
             if (wakePeriod.count() > 0.0f) {
                 _until_check_cancel = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(wakePeriod);
@@ -170,13 +285,8 @@ namespace {
             return std::make_tuple(_forceTryAgain, _forceTryAgain ? _until_check_cancel : until_);
         });
 
-        // operation can't complete: wake when it is signalled to be possible, or when timeout is reached
-        std::unique_lock<std::mutex> _guard{ keeper_->mutex, std::adopt_lock };
-        std::cv_status const _status{ waitingOn_.wait_until(_guard, _until_check_cancel) };
-        _guard.release(); // we don't want to unlock the mutex on exit!
-        bool const _try_again{ _forceTryAgain || (_status == std::cv_status::no_timeout) }; // detect spurious wakeups
+        bool const _try_again{ wait_(_until_check_cancel) || _forceTryAgain };
         if (lane_ != nullptr) {
-            lane_->waiting_on = nullptr;
             lane_->status.store(_prev_status, std::memory_order_release);
         }
         return _try_again;
@@ -184,6 +294,395 @@ namespace {
 
     // #############################################################################################
 
+    // in: the keeper mutex is acquired
+    // out: the keeper mutex is acquired, the waiter is no longer registered in the linda
+    static bool WaitInternal(lua_State* const L_, Lane* const lane_, Linda* const linda_, KeeperIndex const keeper_, Linda::Waiter& waiter_, std::chrono::time_point<std::chrono::steady_clock> until_)
+    {
+        std::chrono::time_point<std::chrono::steady_clock> const _start{ std::chrono::steady_clock::now() };
+        bool const _try_again{ WaitWithLane(L_, lane_, linda_->getWakePeriod(), until_, [lane_, linda_, keeper_, &waiter_](std::chrono::time_point<std::chrono::steady_clock> const until_check_cancel_) {
+            // if the operation becomes possible soon enough, busy-waiting for it spares us the context switches of a blocking wait
+            if (!waiter_.spun && linda_->getSpinDuration().count() > 0) {
+                waiter_.spun = true;
+                if (linda_->spinUntilEvent(keeper_, until_check_cancel_)) {
+                    return true;
+                }
+            }
+            // operation can't complete: wake when it is signalled to be possible, or when timeout is reached
+            // registration is only active while we wait: no Lua error can be raised in between, so the waiter never dangles
+            waiter_.signalled = false;
+            linda_->addWaiter(waiter_, keeper_);
+            Keeper* const _keeper{ linda_->U->keepers.getKeeper(keeper_) };
+            // the condition variable releases the mutex without applying what is posted: do it now, it can be what we are waiting for
+            _keeper->prepareSleep();
+            if (waiter_.signalled) {
+                linda_->removeWaiter(waiter_);
+                return true;
+            }
+            // a lane cancelled since its last check doesn't sleep: it tries again, and sees the request
+            if (lane_ != nullptr && !lane_->startWaiting(waiter_.condVar, _keeper->mutex)) {
+                lane_->stopWaiting();
+                linda_->removeWaiter(waiter_);
+                return true;
+            }
+            _keeper->pauseHold();
+            std::unique_lock<std::mutex> _guard{ _keeper->mutex, std::adopt_lock };
+            std::cv_status const _status{ waiter_.condVar.wait_until(_guard, until_check_cancel_) };
+            _guard.release(); // we don't want to unlock the mutex on exit!
+            _keeper->resumeHold();
+            if (lane_ != nullptr) {
+                lane_->stopWaiting();
+            }
+            linda_->removeWaiter(waiter_);
+            // a waiter can be signalled after its wait timed out, but before it reacquired the mutex: it must try again in that case too
+            return (_status == std::cv_status::no_timeout) || waiter_.signalled; // detect spurious wakeups
+        }) };
+        linda_->addWaitTime(waiter_.kind, std::chrono::steady_clock::now() - _start);
+        return _try_again;
+    }
+
+    // #############################################################################################
+
+    // receive a value from the slots of a linda held by a single keeper, for ReceiveAcrossKeepers()
+    // runs inside Linda::protectedCall(), with that keeper acquired
+    // returns the slot and the value, or the write counter of the keeper if none of the slots contains anything
+    static int PollKeeper(lua_State* const L_)
+    {
+        Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };                                // L_: linda keeper slots...
+        KeeperIndex const _keeperIndex{ static_cast<KeeperIndex::type>(lua_tointeger(L_, 2)) };
+        lua_remove(L_, 2);                                                                         // L_: linda slots...
+        Keeper* const _keeper{ _linda->U->keepers.getKeeper(_keeperIndex) };
+        KeeperCallResult const _pushed{ keeper_call(*_keeper, KEEPER_API(receive), L_, _linda, StackIndex{ 2 }) };
+        if (!_pushed.has_value()) {
+            raise_luaL_error(L_, "tried to copy unsupported types");
+        }
+        if (_pushed.value() == 0) {
+            lua_pushinteger(L_, static_cast<lua_Integer>(_linda->writesIn(_keeperIndex)));         // L_: linda slots... writes
+            return 1;
+        }
+        LUA_ASSERT(L_, _pushed.value() == 2);                                                      // L_: linda slots... slot value
+        if (kRestrictedChannel.equals(L_, StackIndex{ kIdxTop })) {
+            raise_luaL_error(L_, "Key is restricted");
+        }
+        _linda->stats.receives.fetch_add(1, std::memory_order_relaxed);
+        // room was made in the slot we read from, wake the writers waiting on it
+        _linda->wakeWaiters(Linda::Waiter::Kind::Writer, Linda::SlotId(L_, StackIndex{ -2 }), Linda::WakeMode::All);
+        return 2;
+    }
+
+    // #############################################################################################
+
+    // the slots a thread receives from when they are held by several keepers, possibly belonging to several lindas
+    // slots are grouped by (linda, keeper), each group having its own waiter, all of them signalling the same condition variable
+    class ReceiveSources
+    {
+        public:
+        static constexpr int kMaxSlots{ 4 * static_cast<int>(Linda::Waiter::kMaxSlots) };
+
+        // the slots of a linda held by a single keeper, polled and waited on together
+        struct Group
+        {
+            Linda* linda{ nullptr };
+            StackIndex lindaIdx{ 0 };
+            KeeperIndex keeper{ 0 };
+            int nbSlots{ 0 };
+            uint64_t writes{}; // the write counter of the keeper, as of its last poll
+            std::optional<Linda::Waiter> waiter{};
+        };
+
+        private:
+        // where a slot is found on the stack, and the group it belongs to
+        struct Slot
+        {
+            StackIndex idx{ 0 };
+            int group{ 0 };
+        };
+
+        std::condition_variable& condVar;
+        std::mutex& guard; // we don't sleep on a keeper mutex, the waiters are signalled under this one instead
+        lua_Duration wakePeriod{}; // the smallest wake period of all the lindas, if any
+        int nbGroups{ 0 };
+        int nbSlots{ 0 };
+        std::array<Group, kMaxSlots> groups{};
+        std::array<Slot, kMaxSlots> slots{};
+
+        public:
+        int received{ -1 }; // the group that provided the received value
+
+        ReceiveSources(std::condition_variable& condVar_, std::mutex& guard_)
+        : condVar{ condVar_ }
+        , guard{ guard_ }
+        {
+        }
+
+        // register the slot at slotIdx_, that belongs to the linda at lindaIdx_
+        void add(lua_State* const L_, Linda* const linda_, StackIndex const lindaIdx_, StackIndex const slotIdx_)
+        {
+            if (nbSlots == kMaxSlots) {
+                raise_luaL_error(L_, "can't receive from more than %d slots at once", kMaxSlots);
+            }
+            LindaSlotId const _slot{ Linda::SlotId(L_, slotIdx_) };
+            KeeperIndex const _keeperIndex{ linda_->keeperIndexOf(_slot) };
+            int _g{ 0 };
+            while (_g < nbGroups && (groups[_g].linda != linda_ || groups[_g].keeper != _keeperIndex)) {
+                ++_g;
+            }
+            // a slot of a linda can only be listed once, even across several sources of the same linda
+            for (Slot const& _other : std::span{ slots.data(), static_cast<size_t>(nbSlots) }) {
+                if (_other.group == _g && lua_rawequal(L_, _other.idx, slotIdx_)) {
+                    raise_luaL_error(L_, "the same slot of a linda is listed twice");
+                }
+            }
+            Group& _group{ groups[_g] };
+            if (_g == nbGroups) {
+                _group.linda = linda_;
+                _group.lindaIdx = lindaIdx_;
+                _group.keeper = _keeperIndex;
+                _group.waiter.emplace(condVar, Linda::Waiter::Kind::Reader, false);
+                _group.waiter->guard = &guard;
+                lua_Duration const _wakePeriod{ linda_->getWakePeriod() };
+                if (_wakePeriod.count() > 0.0f && (wakePeriod.count() <= 0.0f || _wakePeriod < wakePeriod)) {
+                    wakePeriod = _wakePeriod;
+                }
+                ++nbGroups;
+            }
+            Linda::Waiter& _waiter{ *_group.waiter };
+            if (_group.nbSlots < static_cast<int>(Linda::Waiter::kMaxSlots)) {
+                _waiter.slots[_group.nbSlots] = _slot;
+                _waiter.nbSlots = static_cast<size_t>(_group.nbSlots + 1);
+            } else {
+                _waiter.nbSlots = 0; // too many slots, the waiter is woken by a write in any of them
+            }
+            ++_group.nbSlots;
+            slots[nbSlots++] = Slot{ slotIdx_, _g };
+        }
+
+        // call f_ once for each of the lindas the slots belong to
+        template <typename F>
+        void forEachLinda(F&& f_) const
+        {
+            for (int const _g : std::ranges::iota_view{ 0, nbGroups }) {
+                Linda* const _linda{ groups[_g].linda };
+                if (std::ranges::none_of(std::span{ groups.data(), static_cast<size_t>(_g) }, [_linda](Group const& group_) { return group_.linda == _linda; })) {
+                    f_(*_linda);
+                }
+            }
+        }
+
+        [[nodiscard]]
+        Group const& getGroup(int const group_) const { return groups[group_]; }
+
+        // the first cancel request found in the lane or the lindas
+        [[nodiscard]]
+        CancelRequest getCancel(Lane* const lane_) const
+        {
+            CancelRequest const _cancel{ (lane_ != nullptr) ? lane_->cancelRequest.load(std::memory_order_relaxed) : CancelRequest::None };
+            if (_cancel != CancelRequest::None) {
+                return _cancel;
+            }
+            bool const _cancelled{ std::ranges::any_of(std::span{ groups.data(), static_cast<size_t>(nbGroups) }, [](Group const& group_) { return group_.linda->cancelStatus == Linda::Cancelled; }) };
+            return _cancelled ? CancelRequest::Soft : CancelRequest::None;
+        }
+
+        // poll the keepers in turn: returns 2 if a slot and a value were pushed, else 0 (and false if a keeper is gone)
+        [[nodiscard]]
+        std::pair<bool, int> poll(lua_State* const L_)
+        {
+            STACK_GROW(L_, 2 + nbSlots);
+            STACK_CHECK_START_REL(L_, 0);
+            for (int const _g : std::ranges::iota_view{ 0, nbGroups }) {
+                Group& _group{ groups[_g] };
+                lua_pushvalue(L_, _group.lindaIdx);                                                // L_: linda
+                lua_pushinteger(L_, _group.keeper);                                                // L_: linda keeper
+                int _nargs{ 2 };
+                for (Slot const& _slot : std::span{ slots.data(), static_cast<size_t>(nbSlots) }) {
+                    if (_slot.group == _g) {
+                        lua_pushvalue(L_, _slot.idx);                                              // L_: linda keeper slots...
+                        ++_nargs;
+                    }
+                }
+                switch (_group.linda->protectedCall(L_, PollKeeper, _group.keeper, _nargs)) {
+                case 0: // the keeper is gone
+                    STACK_CHECK(L_, 0);
+                    return std::make_pair(false, 0);
+
+                case 1:                                                                            // L_: writes
+                    _group.writes = static_cast<uint64_t>(lua_tointeger(L_, kIdxTop));
+                    lua_pop(L_, 1);                                                                // L_:
+                    break;
+
+                default:                                                                           // L_: slot value
+                    STACK_CHECK(L_, 2);
+                    received = _g;
+                    return std::make_pair(true, 2);
+                }
+            }
+            STACK_CHECK(L_, 0);
+            return std::make_pair(true, 0);
+        }
+
+        // register with all the keepers, then sleep until one of them signals a write, the lane is cancelled, or until_check_cancel_
+        // registration is only active while we wait: no Lua error can be raised in between, so the waiters never dangle
+        [[nodiscard]]
+        bool wait(Lane* const lane_, std::chrono::time_point<std::chrono::steady_clock> const until_check_cancel_)
+        {
+            auto const _groups{ std::span{ groups.data(), static_cast<size_t>(nbGroups) } };
+            for (Group& _group : _groups) {
+                Keeper* const _keeper{ _group.linda->acquireKeeper(_group.keeper) };
+                _group.linda->addWaiter(*_group.waiter, _group.keeper);
+                // a write that happened since the last poll of the keeper
+                _group.waiter->signalled = (_group.linda->writesIn(_group.keeper) != _group.writes);
+                _group.linda->releaseKeeper(_keeper);
+            }
+            std::cv_status _status{ std::cv_status::no_timeout };
+            {
+                std::unique_lock<std::mutex> _lock{ guard };
+                // a lane cancelled since its last check doesn't sleep: it tries again, and sees the request
+                bool const _cancelled{ lane_ != nullptr && !lane_->startWaiting(condVar, guard) };
+                if (!_cancelled && std::ranges::none_of(_groups, [](Group const& group_) { return group_.waiter->signalled; })) {
+                    _status = condVar.wait_until(_lock, until_check_cancel_);
+                }
+                if (lane_ != nullptr) {
+                    lane_->stopWaiting();
+                }
+            }
+            bool _signalled{ false };
+            for (Group& _group : _groups) {
+                Keeper* const _keeper{ _group.linda->acquireKeeper(_group.keeper) };
+                _group.linda->removeWaiter(*_group.waiter);
+                _signalled = _signalled || _group.waiter->signalled;
+                _group.linda->releaseKeeper(_keeper);
+            }
+            return (_status == std::cv_status::no_timeout) || _signalled;
+        }
+
+        [[nodiscard]]
+        lua_Duration getWakePeriod() const { return wakePeriod; }
+    };
+
+    // #############################################################################################
+
+    // receive a value from slots held by several keepers, none of which is acquired by the caller
+    // the keepers are polled in turn, in the order of the first slot each one holds in the argument list
+    // if they have nothing, the thread registers with each of them, and sleeps until one signals a write in one of the slots
+    // a write that happened between the poll of a keeper and the registration is detected with the write counter of the keeper
+    static std::pair<CancelRequest, int> ReceiveAcrossKeepers(lua_State* const L_, Lane* const lane_, ReceiveSources& sources_, std::chrono::time_point<std::chrono::steady_clock> const until_)
+    {
+        for (bool _try_again{ true };;) {
+            CancelRequest const _cancel{ sources_.getCancel(lane_) };
+            // if user wants to cancel, or looped because of a timeout, the call returns without receiving anything
+            if (!_try_again || _cancel != CancelRequest::None) {
+                return std::make_pair(_cancel, 0);
+            }
+
+            auto const [_alive, _pushed] = sources_.poll(L_);
+            if (!_alive || _pushed > 0) {
+                return std::make_pair(CancelRequest::None, _pushed);
+            }
+
+            if (std::chrono::steady_clock::now() >= until_) {
+                return std::make_pair(CancelRequest::None, 0); // instant timeout
+            }
+
+            // nothing received, wait until timeout or signalled that we should try again
+            std::chrono::time_point<std::chrono::steady_clock> const _start{ std::chrono::steady_clock::now() };
+            _try_again = WaitWithLane(L_, lane_, sources_.getWakePeriod(), until_, [lane_, &sources_](std::chrono::time_point<std::chrono::steady_clock> const until_check_cancel_) {
+                return sources_.wait(lane_, until_check_cancel_);
+            });
+            std::chrono::steady_clock::duration const _waited{ std::chrono::steady_clock::now() - _start };
+            sources_.forEachLinda([_waited](Linda& linda_) { linda_.addWaitTime(Linda::Waiter::Kind::Reader, _waited); });
+        }
+    }
+
+    // #############################################################################################
+
+    // push nil and the reason why a receive operation didn't return anything, or raise an error in case of hard cancel
+    [[nodiscard]]
+    static int PushReceiveFailure(lua_State* const L_, CancelRequest const cancel_)
+    {
+        switch (cancel_) {
+        case CancelRequest::None:
+            // not enough data in the linda slot to fulfill the request, return nil, "timeout"
+            lua_pushnil(L_);
+            luaW_pushstring(L_, "timeout");
+            return 2;
+
+        case CancelRequest::Soft:
+            // if user wants to soft-cancel, the call returns nil, kCancelError
+            lua_pushnil(L_);
+            kCancelError.pushKey(L_);
+            return 2;
+
+        case CancelRequest::Hard:
+            // raise an error interrupting execution only in case of hard cancel
+            raise_cancel_error(L_); // raises an error and doesn't return
+
+        default:
+            raise_luaL_error(L_, "internal error: unknown cancel request");
+        }
+    }
+
+    // #############################################################################################
+
+    // in: the keeper is acquired
+    // call receive_ with the arguments found from key_i_ to the top of the stack, until it provides something, or the operation times out or is cancelled
+    // receive_ provides the values it read, preceded by the slot they come from, unless it is known already, in which case it is slot_
+    [[nodiscard]]
+    static std::pair<CancelRequest, KeeperCallResult> ReceiveFromKeeper(lua_State* const L_, Lane* const lane_, Linda* const linda_, KeeperIndex const keeper_, Linda::Waiter& waiter_, std::chrono::time_point<std::chrono::steady_clock> const until_, keeper_api_t const receive_, StackIndex const key_i_, std::optional<LindaSlotId> const slot_)
+    {
+        Keeper* const _keeper{ linda_->U->keepers.getKeeper(keeper_) };
+        KeeperState const _K{ _keeper->K };
+        CancelRequest _cancel{ CancelRequest::None };
+        KeeperCallResult _pushed{};
+
+        STACK_CHECK_START_REL(_K, 0);
+        for (bool _try_again{ true };;) {
+            if (lane_ != nullptr) {
+                _cancel = lane_->cancelRequest.load(std::memory_order_relaxed);
+            }
+            _cancel = (_cancel != CancelRequest::None)
+                ? _cancel
+                : ((linda_->cancelStatus == Linda::Cancelled) ? CancelRequest::Soft : CancelRequest::None);
+
+            // if user wants to cancel, or looped because of a timeout, the call returns without receiving anything
+            if (!_try_again || _cancel != CancelRequest::None) {
+                if (waiter_.signalled && waiter_.exclusive) {
+                    // we were the only reader woken to consume a value, but we leave without doing it: pass it on to another reader
+                    linda_->wakeWaiters(Linda::Waiter::Kind::Reader, waiter_.slots[0], Linda::WakeMode::One);
+                }
+                _pushed.emplace(0);
+                break;
+            }
+
+            STACK_CHECK(_K, 0);
+            _pushed = keeper_call(*_keeper, receive_, L_, linda_, key_i_);
+            if (!_pushed.has_value()) {
+                break;
+            }
+            if (_pushed.value() > 0) {
+                if (kRestrictedChannel.equals(L_, StackIndex{ kIdxTop })) {
+                    raise_luaL_error(L_, "Key is restricted");
+                }
+                int const _nbValues{ slot_.has_value() ? _pushed.value() : (_pushed.value() - 1) };
+                linda_->stats.receives.fetch_add(static_cast<uint64_t>(_nbValues), std::memory_order_relaxed);
+                // room was made in the slot we read from, wake the writers waiting on it
+                LindaSlotId const _slot{ slot_.has_value() ? slot_.value() : Linda::SlotId(L_, StackIndex{ lua_gettop(L_) - _pushed.value() + 1 }) };
+                linda_->wakeWaiters(Linda::Waiter::Kind::Writer, _slot, Linda::WakeMode::All);
+                break;
+            }
+
+            if (std::chrono::steady_clock::now() >= until_) {
+                break; /* instant timeout */
+            }
+
+            // nothing received, wait until timeout or signalled that we should try again
+            _try_again = WaitInternal(L_, lane_, linda_, keeper_, waiter_, until_);
+        }
+        STACK_CHECK(_K, 0);
+        return std::make_pair(_cancel, _pushed);
+    }
+
+    // #############################################################################################
+
     // the implementation for linda:receive() and linda:receive_batched()
     static int ReceiveInternal(lua_State* const L_, bool const batched_)
     {
@@ -221,14 +720,86 @@ namespace {
         }
 
         Lane* const _lane{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
-        Keeper* const _keeper{ _linda->whichKeeper() };
+        CancelRequest _cancel{ CancelRequest::None };
+        KeeperCallResult _pushed{};
+
+        // the slots of a sharded linda can be held by several keepers, in which case Linda::ProtectedCall() didn't acquire any of them
+        std::optional<KeeperIndex> const _keeperIndex{ _linda->keeperIndexOf(L_, _key_i, batched_ ? _key_i : StackIndex{ lua_gettop(L_) }) };
+        if (!_keeperIndex.has_value()) {
+            std::condition_variable _condVar; // only used when we are not running inside a lane
+            std::mutex _guard; // ditto
+            ReceiveSources _sources{ (_lane != nullptr) ? _lane->lindaCondVar : _condVar, (_lane != nullptr) ? _lane->lindaMutex : _guard };
+            for (StackIndex const _i : std::ranges::iota_view{ _key_i, StackIndex{ lua_gettop(L_) + 1 } }) {
+                _sources.add(L_, _linda, StackIndex{ 1 }, _i);
+            }
+            auto const [_acrossCancel, _acrossPushed] = ReceiveAcrossKeepers(L_, _lane, _sources, _until);
+            _cancel = _acrossCancel;
+            _pushed.emplace(_acrossPushed);
+        } else {
+            Keeper* const _keeper{ _linda->U->keepers.getKeeper(_keeperIndex.value()) };
+            KeeperState const _K{ _keeper ? _keeper->K : KeeperState{ static_cast<lua_State*>(nullptr) } };
+            if (_K == nullptr)
+                return 0;
+
+            // a single value written in the slot is enough to satisfy a non-batched receive() on a single slot
+            std::condition_variable _condVar; // only used when we are not running inside a lane
+            Linda::Waiter _waiter{ (_lane != nullptr) ? _lane->lindaCondVar : _condVar, Linda::Waiter::Kind::Reader, !batched_ && (lua_gettop(L_) == _key_i) };
+            SetWaiterSlots(L_, _waiter, _key_i, batched_ ? _key_i : StackIndex{ lua_gettop(L_) });
+
+            // all arguments of receive() but the first are passed to the keeper's receive function
+            std::tie(_cancel, _pushed) = ReceiveFromKeeper(L_, _lane, _linda, _keeperIndex.value(), _waiter, _until, _selected_keeper_receive, _key_i, std::nullopt);
+            LUA_ASSERT(L_, _pushed.value_or(0) == 0 || (_pushed.value() >= _expected_pushed_min && _pushed.value() <= _expected_pushed_max));
+        }
+        if (!_pushed.has_value()) {
+            raise_luaL_error(L_, "tried to copy unsupported types");
+        }
+
+        if (_cancel == CancelRequest::None) {
+            if (_pushed.value() > 0) {
+                return _pushed.value();
+            }
+            _linda->stats.receiveTimeouts.fetch_add(1, std::memory_order_relaxed);
+        }
+        return PushReceiveFailure(L_, _cancel);
+    }
+
+    // #############################################################################################
+
+    // the implementation of linda:send() and slot:send(), once the slot is known
+    // the values to send follow key_i_, that holds either the slot, or the reference of the KeyUD pinned by linda:slot()
+    // send_ and sendPacked_ are the keeper functions that expect that
+    [[nodiscard]]
+    static int SendInternal(lua_State* const L_, Linda* const linda_, StackIndex const key_i_, std::chrono::time_point<std::chrono::steady_clock> const until_, LindaSlotId const slot_, keeper_api_t const send_, keeper_api_t const sendPacked_)
+    {
+        STACK_GROW(L_, 1);
+
+        // make sure there is something to send
+        if (lua_gettop(L_) == key_i_) {
+            raise_luaL_error(L_, "no data to send");
+        }
+
+        Lane* const _lane{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
+        KeeperIndex const _keeperIndex{ linda_->keeperIndexOf(slot_) };
+        Keeper* const _keeper{ linda_->U->keepers.getKeeper(_keeperIndex) };
         KeeperState const _K{ _keeper ? _keeper->K : KeeperState{ static_cast<lua_State*>(nullptr) } };
         if (_K == nullptr)
             return 0;
 
+        bool _ret{ false };
         CancelRequest _cancel{ CancelRequest::None };
         KeeperCallResult _pushed{};
 
+        int const _nbValues{ lua_gettop(L_) - key_i_ };
+        std::condition_variable _condVar; // only used when we are not running inside a lane
+        Linda::Waiter _waiter{ (_lane != nullptr) ? _lane->lindaCondVar : _condVar, Linda::Waiter::Kind::Writer, false };
+        _waiter.slots[0] = slot_;
+        _waiter.nbSlots = 1;
+
+        // values that can be serialized are stored in native memory, and don't have to be copied in the keeper state
+        // we keep them packed if we have to wait for room in the slot, until we either send them or give up
+        PackedValue* _packed{ PackedValue::PackAll(linda_->U, L_, StackIndex{ key_i_ + 1 }, _nbValues) };
+        size_t const _packedBytes{ PackedValue::SizeAll(_packed) };
+
         STACK_CHECK_START_REL(_K, 0);
         for (bool _try_again{ true };;) {
             if (_lane != nullptr) {
@@ -236,7 +807,7 @@ namespace {
             }
             _cancel = (_cancel != CancelRequest::None)
                 ? _cancel
-                : ((_linda->cancelStatus == Linda::Cancelled) ? CancelRequest::Soft : CancelRequest::None);
+                : ((linda_->cancelStatus == Linda::Cancelled) ? CancelRequest::Soft : CancelRequest::None);
 
             // if user wants to cancel, or looped because of a timeout, the call returns without sending anything
             if (!_try_again || _cancel != CancelRequest::None) {
@@ -244,60 +815,228 @@ namespace {
                 break;
             }
 
-            // all arguments of receive() but the first are passed to the keeper's receive function
             STACK_CHECK(_K, 0);
-            _pushed = keeper_call(_K, _selected_keeper_receive, L_, _linda, _key_i);
+            if (_packed != nullptr) {
+                // only the slot and the packed values chain are passed to the keeper's send function
+                lua_pushvalue(L_, key_i_);                                                         // L_: linda slot val... slot
+                lua_pushlightuserdata(L_, _packed);                                                // L_: linda slot val... slot chain
+                _pushed = keeper_call(*_keeper, sendPacked_, L_, linda_, StackIndex{ lua_gettop(L_) - 1 });
+                lua_remove(L_, -1 - _pushed.value_or(0));                                          // L_: linda slot val... slot [bool]
+                lua_remove(L_, -1 - _pushed.value_or(0));                                          // L_: linda slot val... [bool]
+            } else {
+                // all arguments of send() but the first are passed to the keeper's send function
+                _pushed = keeper_call(*_keeper, send_, L_, linda_, key_i_);
+            }
             if (!_pushed.has_value()) {
                 break;
             }
-            if (_pushed.value() > 0) {
-                LUA_ASSERT(L_, _pushed.value() >= _expected_pushed_min && _pushed.value() <= _expected_pushed_max);
-                if (kRestrictedChannel.equals(L_, StackIndex{ kIdxTop })) {
-                    raise_luaL_error(L_, "Key is restricted");
+            LUA_ASSERT(L_, _pushed.value() == 1);
+
+            if (kRestrictedChannel.equals(L_, StackIndex{ kIdxTop })) {
+                PackedValue::FreeAll(linda_->U, _packed);
+                raise_luaL_error(L_, "Key is restricted");
+            }
+            _ret = lua_toboolean(L_, -1) ? true : false;
+            lua_pop(L_, 1);
+
+            if (_ret) {
+                // the keeper owns the packed values now
+                _packed = nullptr;
+                linda_->stats.sends.fetch_add(static_cast<uint64_t>(_nbValues), std::memory_order_relaxed);
+                linda_->stats.bytes.fetch_add(_packedBytes, std::memory_order_relaxed);
+                // wake the readers of the slot: a single one is enough if it can consume the single value we sent
+                linda_->wakeWaiters(Linda::Waiter::Kind::Reader, slot_, (_nbValues == 1) ? Linda::WakeMode::One : Linda::WakeMode::All);
+                break;
+            }
+
+            // instant timout to bypass the wait syscall
+            if (std::chrono::steady_clock::now() >= until_) {
+                break; /* no wait; instant timeout */
+            }
+
+            // storage limit hit, wait until timeout or signalled that we should try again
+            _try_again = WaitInternal(L_, _lane, linda_, _keeperIndex, _waiter, until_);
+        }
+        STACK_CHECK(_K, 0);
+        PackedValue::FreeAll(linda_->U, _packed);
+
+        if (!_pushed.has_value()) {
+            raise_luaL_error(L_, "tried to copy unsupported types");
+        }
+
+        switch (_cancel) {
+        case CancelRequest::Soft:
+            // if user wants to soft-cancel, the call returns nil, kCancelError
+            lua_pushnil(L_);
+            kCancelError.pushKey(L_);
+            return 2;
+
+        case CancelRequest::Hard:
+            // raise an error interrupting execution only in case of hard cancel
+            raise_cancel_error(L_); // raises an error and doesn't return
+
+        default:
+            if (_ret) {
+                lua_pushboolean(L_, _ret); // true (success)
+                return 1;
+            } else {
+                // not enough room in the Linda slot to fulfill the request, return nil, "timeout"
+                linda_->stats.sendTimeouts.fetch_add(1, std::memory_order_relaxed);
+                lua_pushnil(L_);
+                luaW_pushstring(L_, "timeout");
+                return 2;
+            }
+        }
+    }
+
+    // #############################################################################################
+
+    // the operations linda:batch() can run
+    enum class [[nodiscard]] BatchOp
+    {
+        Get,
+        Limit,
+        Receive,
+        Send,
+        Set
+    };
+    static constexpr std::array<std::string_view, 5> kBatchOpNames{ "get", "limit", "receive", "send", "set" };
+
+    // in: a batch operation at the top of the stack
+    [[nodiscard]]
+    static std::optional<BatchOp> ToBatchOp(lua_State* const L_, StackIndex const op_)
+    {
+        STACK_CHECK_START_REL(L_, 0);
+        lua_rawgeti(L_, op_, 1);                                                                   // L_: ... op ... name
+        std::string_view const _name{ (luaW_type(L_, kIdxTop) == LuaType::STRING) ? luaW_tostring(L_, kIdxTop) : std::string_view{} };
+        lua_pop(L_, 1);                                                                            // L_: ... op ...
+        STACK_CHECK(L_, 0);
+        auto const _it{ std::ranges::find(kBatchOpNames, _name) };
+        if (_name.empty() || _it == kBatchOpNames.end()) {
+            return std::nullopt;
+        }
+        return static_cast<BatchOp>(std::distance(kBatchOpNames.begin(), _it));
+    }
+
+    // #############################################################################################
+
+    // make sure the operations of linda:batch() are valid, and return the keeper holding all their slots
+    [[nodiscard]]
+    static KeeperIndex CheckBatch(lua_State* const L_, Linda const* const linda_, StackIndex const ops_)
+    {
+        int const _nbOps{ static_cast<int>(lua_rawlen(L_, ops_)) };
+        std::optional<KeeperIndex> _keeperIndex{};
+        STACK_GROW(L_, 3);
+        STACK_CHECK_START_REL(L_, 0);
+        for (int const _i : std::ranges::iota_view{ 1, _nbOps + 1 }) {
+            lua_rawgeti(L_, ops_, _i);                                                             // L_: ... op
+            if (luaW_type(L_, kIdxTop) != LuaType::TABLE) {
+                raise_luaL_error(L_, "operation #%d: expected a table", _i);
+            }
+            std::optional<BatchOp> const _batchOp{ ToBatchOp(L_, kIdxTop) };
+            if (!_batchOp.has_value()) {
+                raise_luaL_error(L_, "operation #%d: expected one of get, limit, receive, send, set", _i);
+            }
+            int const _nbArgs{ static_cast<int>(lua_rawlen(L_, -1)) - 1 }; // the slot and what follows it
+            lua_rawgeti(L_, -1, 2);                                                                // L_: ... op slot
+            // make sure the slot is of a valid type (throws an error if not the case)
+            CheckKeyTypes(L_, kIdxTop, kIdxTop);
+            KeeperIndex const _slotKeeper{ linda_->keeperIndexOf(Linda::SlotId(L_, kIdxTop)) };
+            if (_keeperIndex.has_value() && _keeperIndex.value() != _slotKeeper) {
+                raise_luaL_error(L_, "operation #%d: the slots of a batch must be held by a single keeper", _i);
+            }
+            _keeperIndex = _slotKeeper;
+            lua_rawgeti(L_, -2, 3);                                                                // L_: ... op slot arg
+            switch (_batchOp.value()) {
+            case BatchOp::Get:
+                if (_nbArgs > 2 || (_nbArgs == 2 && (luaW_type(L_, kIdxTop) != LuaType::NUMBER || lua_tonumber(L_, -1) < 1))) {
+                    raise_luaL_error(L_, "operation #%d: get expects a slot and an optional count >= 1", _i);
+                }
+                break;
+
+            case BatchOp::Limit:
+                if (_nbArgs > 2 || (_nbArgs == 2 && (luaW_type(L_, kIdxTop) == LuaType::NUMBER ? lua_tonumber(L_, -1) < 0 : luaW_tostring(L_, kIdxTop) != "unlimited"))) {
+                    raise_luaL_error(L_, "operation #%d: limit expects a slot and an optional limit >= 0 or \"unlimited\"", _i);
+                }
+                break;
+
+            case BatchOp::Receive:
+                if (_nbArgs != 1) {
+                    raise_luaL_error(L_, "operation #%d: receive expects a single slot", _i);
+                }
+                break;
+
+            case BatchOp::Send:
+                if (_nbArgs < 2) {
+                    raise_luaL_error(L_, "operation #%d: no data to send", _i);
                 }
-                _linda->readHappened.notify_all();
                 break;
-            }
 
-            if (std::chrono::steady_clock::now() >= _until) {
-                break; /* instant timeout */
+            case BatchOp::Set:
+                break;
             }
-
-            // nothing received, wait until timeout or signalled that we should try again
-            _try_again = WaitInternal(L_, _lane, _linda, _keeper, _linda->writeHappened, _until);
+            lua_pop(L_, 3);                                                                        // L_: ...
         }
-        STACK_CHECK(_K, 0);
+        STACK_CHECK(L_, 0);
+        // an empty batch doesn't need any particular keeper
+        return _keeperIndex.value_or(linda_->getShardKeeper(0));
+    }
 
-        if (!_pushed.has_value()) {
-            raise_luaL_error(L_, "tried to copy unsupported types");
-        }
+    // #############################################################################################
 
-        switch (_cancel) {
-        case CancelRequest::None:
-            {
-                int const _nbPushed{ _pushed.value() };
-                if (_nbPushed == 0) {
-                    // not enough data in the linda slot to fulfill the request, return nil, "timeout"
-                    lua_pushnil(L_);
-                    luaW_pushstring(L_, "timeout");
-                    return 2;
+    // in: the keeper holding the slots of the batch is acquired
+    // wake the lanes blocked on the slots changed by the operations of a batch, depending on what they returned
+    // only the operations that have a result ran: those after one that raised an error don't
+    static void WakeAfterBatch(lua_State* const L_, Linda* const linda_, StackIndex const ops_, StackIndex const results_)
+    {
+        int const _nbOps{ static_cast<int>(lua_rawlen(L_, results_)) };
+        STACK_GROW(L_, 4);
+        STACK_CHECK_START_REL(L_, 0);
+        for (int const _i : std::ranges::iota_view{ 1, _nbOps + 1 }) {
+            lua_rawgeti(L_, ops_, _i);                                                             // L_: ... op
+            BatchOp const _batchOp{ ToBatchOp(L_, kIdxTop).value() };
+            int const _nbArgs{ static_cast<int>(lua_rawlen(L_, -1)) - 1 };
+            lua_rawgeti(L_, -1, 2);                                                                // L_: ... op slot
+            LindaSlotId const _slot{ Linda::SlotId(L_, kIdxTop) };
+            lua_rawgeti(L_, results_, _i);                                                         // L_: ... op slot result
+            lua_rawgeti(L_, -1, 1);                                                                // L_: ... op slot result ret1
+            bool const _ret1{ lua_toboolean(L_, -1) ? true : false };
+            switch (_batchOp) {
+            case BatchOp::Get:
+                break;
+
+            case BatchOp::Limit:
+                if (_nbArgs == 2 && _ret1) {
+                    linda_->wakeWaiters(Linda::Waiter::Kind::Writer, _slot, Linda::WakeMode::All);
                 }
-                return _nbPushed;
-            }
+                break;
 
-        case CancelRequest::Soft:
-            // if user wants to soft-cancel, the call returns nil, kCancelError
-            lua_pushnil(L_);
-            kCancelError.pushKey(L_);
-            return 2;
+            case BatchOp::Receive:
+                if (lua_rawlen(L_, -2) > 0) {
+                    linda_->stats.receives.fetch_add(1, std::memory_order_relaxed);
+                    linda_->wakeWaiters(Linda::Waiter::Kind::Writer, _slot, Linda::WakeMode::All);
+                }
+                break;
 
-        case CancelRequest::Hard:
-            // raise an error interrupting execution only in case of hard cancel
-            raise_cancel_error(L_); // raises an error and doesn't return
+            case BatchOp::Send:
+                if (_ret1) {
+                    linda_->stats.sends.fetch_add(static_cast<uint64_t>(_nbArgs - 1), std::memory_order_relaxed);
+                    linda_->wakeWaiters(Linda::Waiter::Kind::Reader, _slot, (_nbArgs == 2) ? Linda::WakeMode::One : Linda::WakeMode::All);
+                }
+                break;
 
-        default:
-            raise_luaL_error(L_, "internal error: unknown cancel request");
+            case BatchOp::Set:
+                if (_nbArgs > 1) {
+                    linda_->wakeWaiters(Linda::Waiter::Kind::Reader, _slot, Linda::WakeMode::All);
+                }
+                if (_ret1) {
+                    linda_->wakeWaiters(Linda::Waiter::Kind::Writer, _slot, Linda::WakeMode::All);
+                }
+                break;
+            }
+            lua_pop(L_, 4);                                                                        // L_: ...
         }
+        STACK_CHECK(L_, 0);
     }
 
     // #############################################################################################
@@ -314,13 +1053,23 @@ LUAG_FUNC(linda);
 // #################################################################################################
 // #################################################################################################
 
-Linda::Linda(Universe* const U_, std::string_view const& name_, lua_Duration const wake_period_, LindaGroup const group_)
+Linda::Linda(Universe* const U_, std::string_view const& name_, lua_Duration const wake_period_, lua_Duration const spin_duration_, LindaGroup const group_, bool const sharded_)
 : DeepPrelude{ LindaFactory::Instance }
 , U{ U_ }
 , wakePeriod{ wake_period_ }
-, keeperIndex{ group_ % U_->keepers.getNbKeepers() }
+, spinDuration{ std::chrono::duration_cast<std::chrono::steady_clock::duration>(spin_duration_) }
+, keeperIndex{ sharded_ ? -1 : group_ % U_->keepers.getNbKeepers() }
+, sharded{ sharded_ }
 {
     setName(name_);
+    if (sharded) {
+        // slots can be held by any keeper, each one has its own waiters
+        size_t const _nbKeepers{ static_cast<size_t>(U_->keepers.getNbKeepers()) };
+        waiterLists = std::span<WaiterList>{ static_cast<WaiterList*>(U_->internalAllocator.alloc(_nbKeepers * sizeof(WaiterList))), _nbKeepers };
+        std::uninitialized_value_construct(waiterLists.begin(), waiterLists.end());
+    } else {
+        waiterLists = std::span<WaiterList>{ &ownWaiters, 1 };
+    }
 }
 
 // #################################################################################################
@@ -328,16 +1077,29 @@ Linda::Linda(Universe* const U_, std::string_view const& name_, lua_Duration con
 Linda::~Linda()
 {
     freeAllocatedName();
+    for (WaiterList& _list : waiterLists) {
+        while (Notifier* const _notifier{ _list.notifiers }) {
+            _list.notifiers = _notifier->next;
+            CloseNotifierFd(_notifier->fd);
+            U->internalAllocator.free(_notifier, sizeof(Notifier));
+        }
+    }
+    if (int const _fd{ anyNotifier.load(std::memory_order_relaxed) }; _fd >= 0) {
+        CloseNotifierFd(_fd);
+    }
+    if (sharded) {
+        U->internalAllocator.free(waiterLists.data(), waiterLists.size_bytes());
+    }
 }
 
 // #################################################################################################
 
-Keeper* Linda::acquireKeeper() const
+Keeper* Linda::acquireKeeper(KeeperIndex const keeper_) const
 {
     // can be nullptr if this happens during main state shutdown (lanes is being GC'ed -> no keepers)
-    Keeper* const _keeper{ whichKeeper() };
+    Keeper* const _keeper{ U->keepers.getKeeper(keeper_) };
     if (_keeper) {
-        _keeper->mutex.lock();
+        _keeper->lock();
         keeperOperationCount.fetch_add(1, std::memory_order_seq_cst);
     }
     return _keeper;
@@ -345,6 +1107,23 @@ Keeper* Linda::acquireKeeper() const
 
 // #################################################################################################
 
+// in: the mutex of the keeper is acquired
+void Linda::addWaiter(Waiter& waiter_, KeeperIndex const keeper_)
+{
+    WaiterList& _list{ waitersOf(keeper_) };
+    waiter_.list = &_list;
+    waiter_.prev = _list.last;
+    waiter_.next = nullptr;
+    if (_list.last != nullptr) {
+        _list.last->next = &waiter_;
+    } else {
+        _list.first = &waiter_;
+    }
+    _list.last = &waiter_;
+}
+
+// #################################################################################################
+
 Linda* Linda::CreateTimerLinda(lua_State* const L_)
 {
     STACK_CHECK_START_REL(L_, 0);                                                                  // L_:
@@ -407,16 +1186,53 @@ std::string_view Linda::getName() const
 
 // #################################################################################################
 
+// the keeper holding all the slots found in [first_, last_], if there is one
+std::optional<KeeperIndex> Linda::keeperIndexOf(lua_State* const L_, StackIndex const first_, StackIndex const last_) const
+{
+    if (!sharded) {
+        return keeperIndex;
+    }
+    if (last_ < first_) { // no slot means all of them
+        return std::nullopt;
+    }
+    KeeperIndex const _keeperIndex{ keeperIndexOf(SlotId(L_, first_)) };
+    for (StackIndex const _i : std::ranges::iota_view{ StackIndex{ first_ + 1 }, StackIndex{ last_ + 1 } }) {
+        if (keeperIndexOf(SlotId(L_, _i)) != _keeperIndex) {
+            return std::nullopt;
+        }
+    }
+    return _keeperIndex;
+}
+
+// #################################################################################################
+
 // used to perform all linda operations that access keepers
-int Linda::ProtectedCall(lua_State* const L_, lua_CFunction const f_)
+// f_ is called with the slots found in [firstSlot_, lastSlot_] and the keeper holding them acquired
+// if they are held by several keepers of a sharded linda, f_ is called without acquiring any of them, and must visit them by itself
+int Linda::ProtectedCall(lua_State* const L_, lua_CFunction const f_, StackIndex const firstSlot_, StackIndex const lastSlot_)
 {
     Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    std::optional<KeeperIndex> const _keeperIndex{ _linda->keeperIndexOf(L_, firstSlot_, lastSlot_) };
+    if (!_keeperIndex.has_value()) {
+        return f_(L_);
+    }
+    return _linda->protectedCall(L_, f_, _keeperIndex.value(), lua_gettop(L_));
+}
+
+// #################################################################################################
 
+// call f_ with the nargs_ values at the top of the stack as arguments, with the keeper acquired
+// returns the number of values f_ returned, or raises the error it raised once the keeper is released
+int Linda::protectedCall(lua_State* const L_, lua_CFunction const f_, KeeperIndex const keeper_, int const nargs_)
+{
     // acquire the keeper
-    Keeper* const _keeper{ _linda->acquireKeeper() };
+    Keeper* const _keeper{ acquireKeeper(keeper_) };
     KeeperState const _K{ _keeper ? _keeper->K : KeeperState{ static_cast<lua_State*>(nullptr) } };
-    if (_K == nullptr)
+    if (_K == nullptr) {
+        releaseKeeper(_keeper);
+        lua_pop(L_, nargs_);
         return 0;
+    }
 
     // no GC allowed during the call, because we don't want to trigger collection of another linda
     // bound to the same keeper, as that would cause a deadlock when trying to acquire it while
@@ -427,10 +1243,11 @@ int Linda::ProtectedCall(lua_State* const L_, lua_CFunction const f_)
     LUA_ASSERT(L_, lua_gettop(_K) == 0);
 
     // push the function to be called and move it before the arguments
+    int const _base{ lua_gettop(L_) - nargs_ };
     lua_pushcfunction(L_, f_);
-    lua_insert(L_, 1);
+    lua_insert(L_, _base + 1);
     // do a protected call
-    LuaError const _rc{ ToLuaError(lua_pcall(L_, lua_gettop(L_) - 1, LUA_MULTRET, 0)) };
+    LuaError const _rc{ ToLuaError(lua_pcall(L_, nargs_, LUA_MULTRET, 0)) };
     // whatever happens, the keeper state stack must be empty when we are done
     lua_settop(_K, 0);
 
@@ -438,14 +1255,14 @@ int Linda::ProtectedCall(lua_State* const L_, lua_CFunction const f_)
     lua_gc(L_, LUA_GCRESTART, 0);
 
     // release the keeper
-    _linda->releaseKeeper(_keeper);
+    releaseKeeper(_keeper);
 
     // if there was an error, forward it
     if (_rc != LuaError::OK) {
         raise_lua_error(L_);
     }
     // return whatever the actual operation provided
-    return lua_gettop(L_);
+    return lua_gettop(L_) - _base;
 }
 
 // #################################################################################################
@@ -460,14 +1277,25 @@ void Linda::pushCancelString(lua_State* L_) const
 void Linda::releaseKeeper(Keeper* const keeper_) const
 {
     if (keeper_) { // can be nullptr if we tried to acquire during shutdown
-        assert(keeper_ == whichKeeper());
         keeperOperationCount.fetch_sub(1, std::memory_order_seq_cst);
-        keeper_->mutex.unlock();
+        keeper_->unlock();
     }
 }
 
 // #################################################################################################
 
+// in: the mutex of the keeper the waiter was registered with is acquired
+void Linda::removeWaiter(Waiter& waiter_)
+{
+    WaiterList& _list{ *waiter_.list };
+    (waiter_.prev != nullptr ? waiter_.prev->next : _list.first) = waiter_.next;
+    (waiter_.next != nullptr ? waiter_.next->prev : _list.last) = waiter_.prev;
+    waiter_.prev = waiter_.next = nullptr;
+    waiter_.list = nullptr;
+}
+
+// #################################################################################################
+
 void Linda::setName(std::string_view const& name_)
 {
     // keep default
@@ -491,12 +1319,220 @@ void Linda::setName(std::string_view const& name_)
     }
 }
 
+// #################################################################################################
+
+// the slot must be of a type accepted by CheckKeyTypes()
+// the type of the slot is stored in the 3 high bits of the id, so that slots of different types never share it (false and 0 would)
+// booleans, integers, short strings and pointers are stored as-is in the remaining bits, so that their id identifies them
+// other slots store a hash, with kSlotIdHashed set: slots of the same type share an id if their hashes collide, see wakeWaiters()
+LindaSlotId Linda::SlotId(lua_State* const L_, StackIndex const idx_)
+{
+    static_assert(LUA_TUSERDATA < (1 << (64 - kSlotIdTypeShift)));
+    static constexpr uint64_t kValueMask{ kSlotIdHashed - 1 };
+    LuaType const _type{ luaW_type(L_, idx_) };
+    auto const _exact{ [_type](uint64_t const value_) {
+        return LindaSlotId{ (static_cast<uint64_t>(_type) << kSlotIdTypeShift) | (value_ & kValueMask) };
+    } };
+    auto const _hashed{ [_type](uint64_t const hash_) {
+        return LindaSlotId{ (static_cast<uint64_t>(_type) << kSlotIdTypeShift) | kSlotIdHashed | (hash_ & kValueMask) };
+    } };
+    auto const _pointer{ [&_exact, &_hashed](void const* const p_) {
+        uint64_t const _p{ static_cast<uint64_t>(std::bit_cast<uintptr_t>(p_)) };
+        return (_p <= kValueMask) ? _exact(_p) : _hashed(_p);
+    } };
+    switch (_type) {
+    case LuaType::BOOLEAN:
+        return _exact(static_cast<uint64_t>(lua_toboolean(L_, idx_)));
+
+    case LuaType::NUMBER:
+        {
+            // integer and float keys that compare equal are the same slot, so read them as floats
+            static constexpr lua_Number kExactBound{ static_cast<lua_Number>(int64_t{ 1 } << 59) };
+            lua_Number const _n{ lua_tonumber(L_, idx_) };
+            if (_n > -kExactBound && _n < kExactBound) {
+                if (int64_t const _i{ static_cast<int64_t>(_n) }; static_cast<lua_Number>(_i) == _n) {
+                    return _exact(static_cast<uint64_t>(_i));
+                }
+            }
+            // the lowest bits of the mantissa are dropped
+            return _hashed(std::bit_cast<uint64_t>(static_cast<double>(_n)) >> 4);
+        }
+
+    case LuaType::STRING:
+        {
+            std::string_view const _str{ luaW_tostring(L_, idx_) };
+            // up to 7 bytes, prefixed with the length so that trailing zeroes are told apart
+            if (_str.size() < 8) {
+                uint64_t _value{ _str.size() };
+                for (char const _c : _str) {
+                    _value = (_value << 8) | static_cast<unsigned char>(_c);
+                }
+                return _exact(_value);
+            }
+            return _hashed(static_cast<uint64_t>(std::hash<std::string_view>{}(_str)));
+        }
+
+    case LuaType::LIGHTUSERDATA:
+        return _pointer(lua_touserdata(L_, idx_));
+
+    case LuaType::USERDATA: // all proxies of a deep userdata are the same slot
+        return _pointer(*luaW_tofulluserdata<DeepPrelude*>(L_, idx_));
+
+    default:
+        return LindaSlotId{ uint64_t{ 0 } };
+    }
+}
+
+// #################################################################################################
+
+// in: the mutex of the keeper is acquired
+// out: the mutex of the keeper is acquired
+// release the keeper and busy-wait, with an exponential backoff, until waiters are woken in it or the spin duration elapses
+// returns true if they were, in which case the operation should be tried again before blocking
+bool Linda::spinUntilEvent(KeeperIndex const keeper_, std::chrono::time_point<std::chrono::steady_clock> const until_)
+{
+    // past that many pause instructions in a row, yield the CPU instead
+    static constexpr int kMaxPauses{ 64 };
+
+    std::atomic<uint64_t> const& _events{ waitersOf(keeper_).events };
+    uint64_t const _seen{ _events.load(std::memory_order_relaxed) };
+    Keeper* const _keeper{ U->keepers.getKeeper(keeper_) };
+    auto const _until{ std::min(until_, std::chrono::steady_clock::now() + spinDuration) };
+    bool _event{ false };
+    _keeper->unlock();
+    for (int _pauses{ 1 };; _pauses = std::min(2 * _pauses, kMaxPauses)) {
+        if (_events.load(std::memory_order_acquire) != _seen) {
+            _event = true;
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= _until) {
+            break;
+        }
+        if (_pauses < kMaxPauses) {
+            for ([[maybe_unused]] int const _i : std::ranges::iota_view{ 0, _pauses }) {
+                CpuRelax();
+            }
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    _keeper->lock();
+    // something may have happened between our last check and the moment we got the mutex back
+    return _event || (_events.load(std::memory_order_relaxed) != _seen);
+}
+
+// #################################################################################################
+
+// wake all waiters of the specified kind, whatever the slots they wait on
+// the keepers the waiters are registered with are acquired in turn, so this can't be called during a keeper operation
+void Linda::wakeAllWaiters(Waiter::Kind const kind_)
+{
+    for (int const _shard : std::ranges::iota_view{ 0, getNbShards() }) {
+        Keeper* const _keeper{ acquireKeeper(getShardKeeper(_shard)) };
+        waiterLists[_shard].events.fetch_add(1, std::memory_order_release);
+        for (Waiter* _waiter{ waiterLists[_shard].first }; _waiter != nullptr; _waiter = _waiter->next) {
+            if (_waiter->kind == kind_) {
+                _waiter->signal();
+            }
+        }
+        releaseKeeper(_keeper);
+    }
+}
+
+// #################################################################################################
+
+// in: the mutex of the keeper holding the slot is acquired
+// wake the waiters of the specified kind that wait on the slot, in arrival order
+// in WakeMode::One, stop at the first waiter that will consume what was made available
+// unless the slot id is a hash: that waiter could be blocked on another slot with the same id, so all of them are woken
+void Linda::wakeWaiters(Waiter::Kind const kind_, LindaSlotId const slot_, WakeMode const mode_)
+{
+    WaiterList& _list{ waitersOf(keeperIndexOf(slot_)) };
+    _list.events.fetch_add(1, std::memory_order_release);
+    if (kind_ == Waiter::Kind::Reader) {
+        ++_list.writes;
+        for (Notifier const* _notifier{ _list.notifiers }; _notifier != nullptr; _notifier = _notifier->next) {
+            if (_notifier->slot == slot_) {
+                SignalNotifierFd(_notifier->fd);
+            }
+        }
+        if (int const _fd{ anyNotifier.load(std::memory_order_relaxed) }; _fd >= 0) {
+            SignalNotifierFd(_fd);
+        }
+    }
+    for (Waiter* _waiter{ _list.first }; _waiter != nullptr; _waiter = _waiter->next) {
+        // a waiter that was already signalled will try again anyway
+        if (_waiter->kind != kind_ || _waiter->signalled || !_waiter->waitsOn(slot_)) {
+            continue;
+        }
+        _waiter->signal();
+        if (mode_ == WakeMode::One && _waiter->exclusive && (slot_ & kSlotIdHashed) == 0) {
+            break;
+        }
+    }
+}
+
 // #################################################################################################
 // #################################################################################################
 // ########################################## Lua API ##############################################
 // #################################################################################################
 // #################################################################################################
 
+/*
+ * results|(nil,cancel_error) = linda:batch({ {"get"|"limit"|"receive"|"send"|"set", key_num|str|bool|lightuserdata [, ...]}, ... })
+ *
+ * Run several operations on slots held by the same keeper, atomically, with a single acquisition of the keeper.
+ * The operations are checked before any of them runs. If one still raises an error (out of memory), those before it remain applied.
+ * None of them blocks: a send() to a full slot returns false, and a receive() from an empty slot returns nothing.
+ * Returns a table holding, for each operation, a table of the values it returned, with a field 'n' holding their count.
+ */
+LUAG_FUNC(linda_batch)
+{
+    static constexpr lua_CFunction _batch{
+        +[](lua_State* const L_) {
+            static constexpr StackIndex kIdxOps{ 2 };
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+            KeeperIndex const _keeperIndex{ static_cast<KeeperIndex::type>(lua_tointeger(L_, 3)) };
+            lua_settop(L_, 2);                                                                     // L_: linda ops
+
+            KeeperCallResult _pushed;
+            if (_linda->cancelStatus == Linda::Active) {
+                // the whole batch is copied in the keeper at once
+                _pushed = keeper_call(*_linda->U->keepers.getKeeper(_keeperIndex), KEEPER_API(batch), L_, _linda, kIdxOps);
+                if (_pushed.has_value()) { // no error?
+                    if (_pushed.value() == 2) {                                                    // L_: linda ops kRestrictedChannel i
+                        LUA_ASSERT(L_, kRestrictedChannel.equals(L_, StackIndex{ -2 }));
+                        raise_luaL_error(L_, "operation #%d: Key is restricted", static_cast<int>(lua_tointeger(L_, -1)));
+                    }
+                    if (_pushed.value() == 3) {                                                    // L_: linda ops results i err
+                        // the operations before the failing one are applied all the same: the lanes waiting on their slots must know
+                        WakeAfterBatch(L_, _linda, kIdxOps, StackIndex{ 3 });
+                        raise_luaL_error(L_, "operation #%d: %s", static_cast<int>(lua_tointeger(L_, 4)), luaW_tostring(L_, StackIndex{ 5 }).data());
+                    }
+                    LUA_ASSERT(L_, _pushed.value() == 1 && luaW_type(L_, kIdxTop) == LuaType::TABLE); // L_: linda ops results
+                    WakeAfterBatch(L_, _linda, kIdxOps, StackIndex{ 3 });
+                }
+            } else { // linda is cancelled
+                // do nothing and return nil,lanes.cancel_error
+                lua_pushnil(L_);
+                kCancelError.pushKey(L_);
+                _pushed.emplace(2);
+            }
+            // must trigger any error after keeper state has been released
+            return OptionalValue(_pushed, L_, "tried to copy unsupported types");
+        }
+    };
+    Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    luaL_checktype(L_, 2, LUA_TTABLE);
+    luaL_argcheck(L_, lua_gettop(L_) == 2, 3, "too many arguments");
+    // validate the batch before acquiring the keeper that holds its slots
+    KeeperIndex const _keeperIndex{ CheckBatch(L_, _linda, StackIndex{ 2 }) };
+    lua_pushinteger(L_, _keeperIndex);                                                             // L_: linda ops keeperIndex
+    return _linda->protectedCall(L_, _batch, _keeperIndex, 3);
+}
+
+// #################################################################################################
+
 /*
  * (void) = linda_cancel( linda_ud, "read"|"write"|"both"|"none")
  *
@@ -509,26 +1545,74 @@ LUAG_FUNC(linda_cancel)
     // make sure we got 2 arguments: the linda and the cancellation mode
     luaL_argcheck(L_, lua_gettop(L_) <= 2, 2, "wrong number of arguments");
 
+    if (_who != "both" && _who != "none" && _who != "read" && _who != "write") {
+        raise_luaL_error(L_, "unknown wake hint '%s'", _who.data());
+    }
+
     if (_who == "both") { // tell everyone to wake up
-        _linda->cancelStatus = Linda::Status::Cancelled;
-        _linda->writeHappened.notify_all();
-        _linda->readHappened.notify_all();
+        _linda->cancelStatus.store(Linda::Status::Cancelled, std::memory_order_release);
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Reader);
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Writer);
     } else if (_who == "none") { // reset flag
-        _linda->cancelStatus = Linda::Status::Active;
+        _linda->cancelStatus.store(Linda::Status::Active, std::memory_order_release);
     } else if (_who == "read") { // tell blocked readers to wake up
-        _linda->cancelStatus = Linda::Status::Cancelled;
-        _linda->writeHappened.notify_all();
+        _linda->cancelStatus.store(Linda::Status::Cancelled, std::memory_order_release);
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Reader);
     } else if (_who == "write") { // tell blocked writers to wake up
-        _linda->cancelStatus = Linda::Status::Cancelled;
-        _linda->readHappened.notify_all();
-    } else {
-        raise_luaL_error(L_, "unknown wake hint '%s'", _who.data());
+        _linda->cancelStatus.store(Linda::Status::Cancelled, std::memory_order_release);
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Writer);
     }
     return 0;
 }
 
 // #################################################################################################
 
+/*
+ * true|(false,value)|(nil,cancel_error) = linda:cas(key_num|str|bool|lightuserdata, expected, new)
+ *
+ * Atomically replace the value of a slot by 'new' if it is 'expected', with a single keeper operation.
+ * The value of a slot is what linda:get() reads, nil if the slot is empty. Storing nil empties the slot.
+ */
+LUAG_FUNC(linda_cas)
+{
+    static constexpr lua_CFunction _cas{
+        +[](lua_State* const L_) {
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+            luaL_argcheck(L_, lua_gettop(L_) <= 4, 5, "too many arguments");
+            // make sure the slot is of a valid type (throws an error if not the case)
+            CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ 2 });
+            lua_settop(L_, 4);                                                                     // L_: linda slot expected new
+
+            KeeperCallResult _pushed;
+            if (_linda->cancelStatus == Linda::Active) {
+                Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+                _pushed = keeper_call(*_keeper, KEEPER_API(cas), L_, _linda, StackIndex{ 2 });
+                if (_pushed.has_value()) { // no error?
+                    if (kRestrictedChannel.equals(L_, kIdxTop)) {
+                        raise_luaL_error(L_, "Key is restricted");
+                    }
+                    StackIndex const _wasFull_i{ lua_gettop(L_) - _pushed.value() + 1 };           // L_: linda slot expected new wasFull true|(false val)
+                    if (lua_toboolean(L_, _wasFull_i + 1)) {
+                        WakeAfterReplace(_linda, Linda::SlotId(L_, StackIndex{ 2 }), lua_toboolean(L_, _wasFull_i) ? true : false);
+                    }
+                    lua_remove(L_, _wasFull_i);                                                    // L_: linda slot expected new true|(false val)
+                    _pushed.emplace(_pushed.value() - 1);
+                }
+            } else { // linda is cancelled
+                // do nothing and return nil,lanes.cancel_error
+                lua_pushnil(L_);
+                kCancelError.pushKey(L_);
+                _pushed.emplace(2);
+            }
+            // must trigger any error after keeper state has been released
+            return OptionalValue(_pushed, L_, "tried to copy unsupported types");
+        }
+    };
+    return Linda::ProtectedCall(L_, _cas);
+}
+
+// #################################################################################################
+
 #if LUA_VERSION_NUM >= 504
 // linda:__close(err|nil)
 static LUAG_FUNC(linda_close)
@@ -633,22 +1717,29 @@ static LUAG_FUNC(linda_index)
 /*
  * (void) = linda_collectgarbage( linda_ud)
  *
- * Force a GC cycle in the keeper assigned to the Linda
+ * Force a GC cycle in the keeper assigned to the Linda (all keepers if it is sharded)
  */
 LUAG_FUNC(linda_collectgarbage)
 {
     static constexpr lua_CFunction _collectgarbage{
         +[](lua_State* const L_) {
-            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
-            if (lua_gettop(L_) > 1) {
-                raise_luaL_argerror(L_, StackIndex{ 2 }, "Unexpected extra argument");
-            }
-            Keeper* const _keeper{ _linda->whichKeeper() };
-            KeeperCallResult const _pushed{ keeper_call(_keeper->K, KEEPER_API(collectgarbage), L_, _linda, StackIndex{ 0 }) };
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };                            // L_: linda keeper
+            Keeper* const _keeper{ _linda->U->keepers.getKeeper(KeeperIndex{ static_cast<KeeperIndex::type>(lua_tointeger(L_, 2)) }) };
+            KeeperCallResult const _pushed{ keeper_call(*_keeper, KEEPER_API(collectgarbage), L_, _linda, StackIndex{ 0 }) };
             return OptionalValue(_pushed, L_, "Unexpected error");
         }
     };
-    return Linda::ProtectedCall(L_, _collectgarbage);
+    Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    if (lua_gettop(L_) > 1) {
+        raise_luaL_argerror(L_, StackIndex{ 2 }, "Unexpected extra argument");
+    }
+    for (int const _shard : std::ranges::iota_view{ 0, _linda->getNbShards() }) {
+        KeeperIndex const _keeperIndex{ _linda->getShardKeeper(_shard) };
+        lua_pushvalue(L_, 1);                                                                      // L_: linda linda
+        lua_pushinteger(L_, _keeperIndex);                                                         // L_: linda linda keeper
+        lua_pop(L_, _linda->protectedCall(L_, _collectgarbage, _keeperIndex, 2));                  // L_: linda
+    }
+    return 0;
 }
 
 // #################################################################################################
@@ -666,12 +1757,60 @@ LUAG_FUNC(linda_count)
             // make sure the keys are of a valid type
             CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ lua_gettop(L_) });
 
-            Keeper* const _keeper{ _linda->whichKeeper() };
-            KeeperCallResult const _pushed{ keeper_call(_keeper->K, KEEPER_API(count), L_, _linda, StackIndex{ 2 }) };
+            Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+            KeeperCallResult const _pushed{ keeper_call(*_keeper, KEEPER_API(count), L_, _linda, StackIndex{ 2 }) };
             return OptionalValue(_pushed, L_, "Tried to count an invalid slot");
         }
     };
-    return Linda::ProtectedCall(L_, _count);
+    // the slots of a sharded linda held by a single keeper
+    static constexpr lua_CFunction _countShard{
+        +[](lua_State* const L_) {
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };                            // L_: linda keeper slots...
+            Keeper* const _keeper{ _linda->U->keepers.getKeeper(KeeperIndex{ static_cast<KeeperIndex::type>(lua_tointeger(L_, 2)) }) };
+            lua_remove(L_, 2);                                                                     // L_: linda slots...
+            bool const _oneSlot{ lua_gettop(L_) == 2 };
+            KeeperCallResult const _pushed{ keeper_call(*_keeper, KEEPER_API(count), L_, _linda, StackIndex{ 2 }) };
+            std::ignore = OptionalValue(_pushed, L_, "Tried to count an invalid slot");            // L_: linda slots... out|count|nil
+            if (_oneSlot) { // the keeper returned the count of the slot instead of a table
+                lua_newtable(L_);                                                                  // L_: linda slot count out
+                lua_pushvalue(L_, 2);                                                              // L_: linda slot count out slot
+                lua_pushvalue(L_, -3);                                                             // L_: linda slot count out slot count
+                lua_rawset(L_, -3);                                                                // L_: linda slot count out
+            }
+            return 1;
+        }
+    };
+
+    Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    StackIndex const _top{ lua_gettop(L_) };
+    if (_linda->keeperIndexOf(L_, StackIndex{ 2 }, _top).has_value()) {
+        return Linda::ProtectedCall(L_, _count, StackIndex{ 2 }, _top);
+    }
+
+    // the slots of a sharded linda are spread over several keepers: count them keeper by keeper, and merge the results
+    CheckKeyTypes(L_, StackIndex{ 2 }, _top);
+    STACK_GROW(L_, _top + 2);
+    lua_newtable(L_);                                                                              // L_: linda slots... out
+    for (int const _shard : std::ranges::iota_view{ 0, _linda->getNbShards() }) {
+        KeeperIndex const _keeperIndex{ _linda->getShardKeeper(_shard) };
+        lua_pushvalue(L_, 1);                                                                      // L_: linda slots... out linda
+        lua_pushinteger(L_, _keeperIndex);                                                         // L_: linda slots... out linda keeper
+        int _nargs{ 2 };
+        for (StackIndex const _i : std::ranges::iota_view{ StackIndex{ 2 }, StackIndex{ _top + 1 } }) {
+            if (_linda->keeperIndexOf(Linda::SlotId(L_, _i)) == _keeperIndex) {
+                lua_pushvalue(L_, _i);                                                             // L_: linda slots... out linda keeper slots'...
+                ++_nargs;
+            }
+        }
+        if (_top >= 2 && _nargs == 2) { // none of the slots is held by this keeper
+            lua_pop(L_, 2);                                                                        // L_: linda slots... out
+            continue;
+        }
+        if (_linda->protectedCall(L_, _countShard, _keeperIndex, _nargs) == 1) {                   // L_: linda slots... out counts
+            MergeTables(L_);                                                                       // L_: linda slots... out
+        }
+    }
+    return 1;
 }
 
 // #################################################################################################
@@ -702,38 +1841,130 @@ LUAG_FUNC(linda_deep)
 LUAG_FUNC(linda_dump)
 {
     static constexpr lua_CFunction _dump{
+        +[](lua_State* const L_) {
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };                            // L_: linda keeper
+            return Keeper::PushLindaStorage(*_linda, KeeperIndex{ static_cast<KeeperIndex::type>(lua_tointeger(L_, 2)) }, DestState{ L_ });
+        }
+    };
+    Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    lua_settop(L_, 1);                                                                             // L_: linda
+    // the slots of a sharded linda are spread over all keepers: merge their contents
+    for (int const _shard : std::ranges::iota_view{ 0, _linda->getNbShards() }) {
+        KeeperIndex const _keeperIndex{ _linda->getShardKeeper(_shard) };
+        lua_pushvalue(L_, 1);                                                                      // L_: linda [out] linda
+        lua_pushinteger(L_, _keeperIndex);                                                         // L_: linda [out] linda keeper
+        if (_linda->protectedCall(L_, _dump, _keeperIndex, 2) == 1 && lua_gettop(L_) == 3) {       // L_: linda [out] [storage]
+            MergeTables(L_);                                                                       // L_: linda out
+        }
+    }
+    return lua_gettop(L_) - 1;
+}
+
+// #################################################################################################
+
+/*
+ * fd = linda:fd([slot])
+ *
+ * Return a file descriptor that becomes readable when a value is written in the slot, or in any slot if none is provided.
+ * The descriptor is readable right away, and stays so until it is read. It is closed when the linda is destroyed.
+ */
+LUAG_FUNC(linda_fd)
+{
+    Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    luaL_argcheck(L_, lua_gettop(L_) <= 2, 3, "too many arguments");
+    std::optional<LindaSlotId> _slot{};
+    if (lua_gettop(L_) == 2) {
+        // make sure the slot is of a valid type (throws an error if not the case)
+        CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ 2 });
+        _slot.emplace(Linda::SlotId(L_, StackIndex{ 2 }));
+    }
+    int const _fd{ _linda->getNotifier(_slot) };
+    if (_fd < 0) {
+#ifdef PLATFORM_LINUX
+        raise_luaL_error(L_, "failed to create an eventfd: %s", strerror(errno));
+#else // PLATFORM_LINUX
+        raise_luaL_error(L_, "linda:fd() is not supported on this platform");
+#endif // PLATFORM_LINUX
+    }
+    lua_pushinteger(L_, _fd);
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * count, [val [, ...]]|nil,cancel_error = linda:get(key_num|str|bool|lightuserdata [, count = 1])
+ *
+ * Get one or more values from Linda.
+ */
+LUAG_FUNC(linda_get)
+{
+    static constexpr lua_CFunction _get{
         +[](lua_State* const L_) {
             Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
-            return Keeper::PushLindaStorage(*_linda, DestState{ L_ });
+            lua_Integer const _count{ luaL_optinteger(L_, 3, 1) };
+            luaL_argcheck(L_, _count >= 1, 3, "count should be >= 1");
+            luaL_argcheck(L_, lua_gettop(L_) <= 3, 4, "too many arguments");
+            // make sure the slot is of a valid type (throws an error if not the case)
+            CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ 2 });
+
+            KeeperCallResult _pushed;
+            if (_linda->cancelStatus == Linda::Active) {
+                Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+                _pushed = keeper_call(*_keeper, KEEPER_API(get), L_, _linda, StackIndex{ 2 });
+                if (_pushed.has_value() && kRestrictedChannel.equals(L_, kIdxTop)) {
+                    raise_luaL_error(L_, "Key is restricted");
+                }
+            } else { // linda is cancelled
+                // do nothing and return nil,lanes.cancel_error
+                lua_pushnil(L_);
+                kCancelError.pushKey(L_);
+                _pushed.emplace(2);
+            }
+            // an error can be raised if we attempt to read an unregistered function
+            return OptionalValue(_pushed, L_, "tried to copy unsupported types");
         }
     };
-    return Linda::ProtectedCall(L_, _dump);
+    return Linda::ProtectedCall(L_, _get);
 }
 
 // #################################################################################################
 
 /*
- * count, [val [, ...]]|nil,cancel_error = linda:get(key_num|str|bool|lightuserdata [, count = 1])
+ * number|(nil,cancel_error) = linda:incr(key_num|str|bool|lightuserdata [, delta = 1])
  *
- * Get one or more values from Linda.
+ * Atomically add delta to the number stored in a slot, with a single keeper operation. An empty slot counts as 0.
+ * Return the new value.
  */
-LUAG_FUNC(linda_get)
+LUAG_FUNC(linda_incr)
 {
-    static constexpr lua_CFunction _get{
+    static constexpr lua_CFunction _incr{
         +[](lua_State* const L_) {
             Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
-            lua_Integer const _count{ luaL_optinteger(L_, 3, 1) };
-            luaL_argcheck(L_, _count >= 1, 3, "count should be >= 1");
             luaL_argcheck(L_, lua_gettop(L_) <= 3, 4, "too many arguments");
             // make sure the slot is of a valid type (throws an error if not the case)
             CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ 2 });
+            if (lua_isnil(L_, 3)) {
+                lua_settop(L_, 2);                                                                 // L_: linda slot
+            } else {
+                luaL_checktype(L_, 3, LUA_TNUMBER);                                                // L_: linda slot delta
+            }
 
             KeeperCallResult _pushed;
             if (_linda->cancelStatus == Linda::Active) {
-                Keeper* const _keeper{ _linda->whichKeeper() };
-                _pushed = keeper_call(_keeper->K, KEEPER_API(get), L_, _linda, StackIndex{ 2 });
-                if (_pushed.has_value() && kRestrictedChannel.equals(L_, kIdxTop)) {
-                    raise_luaL_error(L_, "Key is restricted");
+                Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+                _pushed = keeper_call(*_keeper, KEEPER_API(incr), L_, _linda, StackIndex{ 2 });
+                if (_pushed.has_value()) { // no error?
+                    if (kRestrictedChannel.equals(L_, kIdxTop)) {
+                        raise_luaL_error(L_, "Key is restricted");
+                    }
+                    if (_pushed.value() == 1) {                                                    // L_: linda slot [delta] val
+                        raise_luaL_error(L_, "slot doesn't hold a number but a %s", luaL_typename(L_, kIdxTop));
+                    }
+                    LUA_ASSERT(L_, _pushed.value() == 2 && luaW_type(L_, kIdxTop) == LuaType::NUMBER); // L_: linda slot [delta] wasFull val
+                    WakeAfterReplace(_linda, Linda::SlotId(L_, StackIndex{ 2 }), lua_toboolean(L_, -2) ? true : false);
+                    lua_remove(L_, -2);                                                            // L_: linda slot [delta] val
+                    _pushed.emplace(1);
                 }
             } else { // linda is cancelled
                 // do nothing and return nil,lanes.cancel_error
@@ -741,11 +1972,11 @@ LUAG_FUNC(linda_get)
                 kCancelError.pushKey(L_);
                 _pushed.emplace(2);
             }
-            // an error can be raised if we attempt to read an unregistered function
+            // must trigger any error after keeper state has been released
             return OptionalValue(_pushed, L_, "tried to copy unsupported types");
         }
     };
-    return Linda::ProtectedCall(L_, _get);
+    return Linda::ProtectedCall(L_, _incr);
 }
 
 // #################################################################################################
@@ -783,14 +2014,14 @@ LUAG_FUNC(linda_limit)
                     lua_pop(L_, 1);                                                                // L_: linda slot
                     lua_pushinteger(L_, -1);                                                       // L_: linda slot nil
                 }
-                Keeper* const _keeper{ _linda->whichKeeper() };
-                _pushed = keeper_call(_keeper->K, KEEPER_API(limit), L_, _linda, StackIndex{ 2 });
+                Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+                _pushed = keeper_call(*_keeper, KEEPER_API(limit), L_, _linda, StackIndex{ 2 });
                 LUA_ASSERT(L_, _pushed.has_value() && (_pushed.value() == 2) && luaW_type(L_, kIdxTop) == LuaType::STRING);
                 if (_nargs == 3) { // 3 args: setting the limit
                     // changing the limit: no error, boolean value saying if we should wake blocked writer threads
                     LUA_ASSERT(L_, luaW_type(L_, StackIndex{ -2 }) == LuaType::BOOLEAN);           // L_: bool string
                     if (lua_toboolean(L_, -2)) {
-                        _linda->readHappened.notify_all(); // To be done from within the 'K' locking area
+                        _linda->wakeWaiters(Linda::Waiter::Kind::Writer, Linda::SlotId(L_, StackIndex{ 2 }), Linda::WakeMode::All); // To be done from within the 'K' locking area
                     }
                 } else { // 2 args: reading the limit
                     // reading the limit: a number >=0 or "unlimited"
@@ -811,6 +2042,54 @@ LUAG_FUNC(linda_limit)
 
 // #################################################################################################
 
+/*
+ * true|(nil,cancel_error) = linda:post(key_num|str|bool|lightuserdata, val [, ...])
+ *
+ * Send one or more values to a Linda slot without waiting for the keeper that holds it.
+ * The values are serialized in native memory, and stored in the slot either right away if the keeper is free, or by its holder when it releases it.
+ * If the slot is full or restricted at that time, they are dropped, and counted in the 'dropped_posts' field of linda:stats().
+ * The poster waits for the keeper when too many posts are already pending on it, or when its holder releases it by going to sleep.
+ * Values posted by a lane to a slot reach it in the order they were posted, and before anything the lane sends to that slot afterward.
+ */
+LUAG_FUNC(linda_post)
+{
+    static constexpr StackIndex kIdxSlot{ 2 };
+    Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    // make sure the slot is of a valid type
+    CheckKeyTypes(L_, kIdxSlot, kIdxSlot);
+    int const _nbValues{ lua_gettop(L_) - kIdxSlot };
+    if (_nbValues == 0) {
+        raise_luaL_error(L_, "no data to send");
+    }
+    if (_linda->cancelStatus != Linda::Active) {
+        // do nothing and return nil,lanes.cancel_error
+        lua_pushnil(L_);
+        kCancelError.pushKey(L_);
+        return 2;
+    }
+    KeeperIndex const _keeperIndex{ _linda->keeperIndexOf(Linda::SlotId(L_, kIdxSlot)) };
+    Keeper* const _keeper{ _linda->U->keepers.getKeeper(_keeperIndex) };
+    if (_keeper == nullptr) {
+        return 0;
+    }
+
+    // the slot is serialized along with the values, so that nothing is copied in the keeper state until the post is applied
+    PackedValue* const _packed{ PackedValue::PackAll(_linda->U, L_, kIdxSlot, 1 + _nbValues) };
+    if (_packed == nullptr) {
+        raise_luaL_error(L_, "can only post nil, booleans, numbers, strings, light userdata, and distinct flat tables of those");
+    }
+    void* const _mem{ _linda->U->internalAllocator.alloc(sizeof(PostedSend)) };
+    if (_mem == nullptr) {
+        PackedValue::FreeAll(_linda->U, _packed);
+        raise_luaL_error(L_, "not enough memory");
+    }
+    _keeper->post(new (_mem) PostedSend{ nullptr, _linda, _packed });
+    lua_pushboolean(L_, 1);
+    return 1;
+}
+
+// #################################################################################################
+
 /*
  * [val, slot] = linda:receive([timeout_secs_num=nil], key_num|str|bool|lightuserdata [, ...] )
  * Consumes a single value from the Linda, in any slot.
@@ -818,7 +2097,7 @@ LUAG_FUNC(linda_limit)
  */
 LUAG_FUNC(linda_receive)
 {
-    return Linda::ProtectedCall(L_, [](lua_State* const L_) { return ReceiveInternal(L_, false); });
+    return Linda::ProtectedCall(L_, [](lua_State* const L_) { return ReceiveInternal(L_, false); }, FirstSlotIndex(L_), StackIndex{ lua_gettop(L_) });
 }
 
 // #################################################################################################
@@ -830,7 +2109,8 @@ LUAG_FUNC(linda_receive)
  */
 LUAG_FUNC(linda_receive_batched)
 {
-    return Linda::ProtectedCall(L_, [](lua_State* const L_) { return ReceiveInternal(L_, true); });
+    StackIndex const _key_i{ FirstSlotIndex(L_) };
+    return Linda::ProtectedCall(L_, [](lua_State* const L_) { return ReceiveInternal(L_, true); }, _key_i, _key_i);
 }
 
 // #################################################################################################
@@ -859,8 +2139,8 @@ LUAG_FUNC(linda_restrict)
 
             KeeperCallResult _pushed;
             if (_linda->cancelStatus == Linda::Active) {
-                Keeper* const _keeper{ _linda->whichKeeper() };
-                _pushed = keeper_call(_keeper->K, KEEPER_API(restrict), L_, _linda, StackIndex{ 2 });
+                Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+                _pushed = keeper_call(*_keeper, KEEPER_API(restrict), L_, _linda, StackIndex{ 2 });
                 // we should get a single return value: the string describing the previous restrict mode
                 LUA_ASSERT(L_, _pushed.has_value() && (_pushed.value() == 1) && luaW_type(L_, kIdxTop) == LuaType::STRING);
             } else { // linda is cancelled
@@ -898,135 +2178,424 @@ LUAG_FUNC(linda_send)
             // make sure the slot is of a valid type
             CheckKeyTypes(L_, _key_i, _key_i);
 
-            STACK_GROW(L_, 1);
+            return SendInternal(L_, _linda, _key_i, _until, Linda::SlotId(L_, _key_i), KEEPER_API(send), KEEPER_API(send_packed));
+        }
+    };
+    StackIndex const _key_i{ FirstSlotIndex(L_) };
+    return Linda::ProtectedCall(L_, _send, _key_i, _key_i);
+}
 
-            // make sure there is something to send
-            if (lua_gettop(L_) == _key_i) {
-                raise_luaL_error(L_, "no data to send");
-            }
+// #################################################################################################
 
-            Lane* const _lane{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
-            Keeper* const _keeper{ _linda->whichKeeper() };
-            KeeperState const _K{ _keeper ? _keeper->K : KeeperState{ static_cast<lua_State*>(nullptr) } };
-            if (_K == nullptr)
-                return 0;
+/*
+ * (boolean,string)|(nil,lanes.cancel_error) = linda:set(key_num|str|bool|lightuserdata [, value [, ...]])
+ *
+ * Set one or more value to Linda. Ignores limits.
+ *
+ * Existing slot value is replaced, and possible queued entries removed.
+ */
+LUAG_FUNC(linda_set)
+{
+    static constexpr lua_CFunction _set{
+        +[](lua_State* const L_) {
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+            bool const _has_data{ lua_gettop(L_) > 2 };
+            // make sure the slot is of a valid type (throws an error if not the case)
+            CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ 2 });
 
-            bool _ret{ false };
-            CancelRequest _cancel{ CancelRequest::None };
-            KeeperCallResult _pushed{};
+            KeeperCallResult _pushed;
+            if (_linda->cancelStatus == Linda::Active) {
+                Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+                _pushed = keeper_call(*_keeper, KEEPER_API(set), L_, _linda, StackIndex{ 2 });
+                if (_pushed.has_value()) { // no error?
+                    if (kRestrictedChannel.equals(L_, kIdxTop)) {
+                        raise_luaL_error(L_, "Key is restricted");
+                    }
+                    LUA_ASSERT(L_, _pushed.value() == 2 && luaW_type(L_, kIdxTop) == LuaType::STRING && luaW_type(L_, StackIndex{ -2 }) == LuaType::BOOLEAN);
 
-            STACK_CHECK_START_REL(_K, 0);
-            for (bool _try_again{ true };;) {
-                if (_lane != nullptr) {
-                    _cancel = _lane->cancelRequest.load(std::memory_order_relaxed);
+                    LindaSlotId const _slot{ Linda::SlotId(L_, StackIndex{ 2 }) };
+                    if (_has_data) {
+                        // we put some data in the slot, tell readers that they should wake
+                        _linda->wakeWaiters(Linda::Waiter::Kind::Reader, _slot, Linda::WakeMode::All); // To be done from within the 'K' locking area
+                    }
+                    if (lua_toboolean(L_, -2)) {
+                        // the slot was full, but it is no longer the case, tell writers they should wake
+                        _linda->wakeWaiters(Linda::Waiter::Kind::Writer, _slot, Linda::WakeMode::All); // To be done from within the 'K' locking area
+                    }
                 }
-                _cancel = (_cancel != CancelRequest::None)
-                    ? _cancel
-                    : ((_linda->cancelStatus == Linda::Cancelled) ? CancelRequest::Soft : CancelRequest::None);
+            } else { // linda is cancelled
+                // do nothing and return nil,lanes.cancel_error
+                lua_pushnil(L_);
+                kCancelError.pushKey(L_);
+                _pushed.emplace(2);
+            }
 
-                // if user wants to cancel, or looped because of a timeout, the call returns without sending anything
-                if (!_try_again || _cancel != CancelRequest::None) {
-                    _pushed.emplace(0);
-                    break;
+            // must trigger any error after keeper state has been released
+            return OptionalValue(_pushed, L_, "tried to copy unsupported types");
+        }
+    };
+    return Linda::ProtectedCall(L_, _set);
+}
+
+// #################################################################################################
+// #################################################################################################
+namespace {
+    // #############################################################################################
+    // #############################################################################################
+
+    // the full userdata returned by linda:slot(), bound to a slot of a linda, resolved once and for all
+    // it holds a reference on the linda, and the KeyUD of the slot stays pinned in the keeper until the handle is collected
+    // this is not a deep userdata: it can't be transferred to another lane, that must call linda:slot() itself
+    struct SlotHandle
+    {
+        static constexpr std::string_view kMetatableName{ "LindaSlot" };
+
+        Linda* const linda;
+        KeeperIndex const keeper;
+        LindaSlotId const slot;
+        lua_Integer const ref; // the reference under which the keeper anchors the KeyUD of the slot
+
+        [[nodiscard]]
+        Keeper& getKeeper() const { return *linda->U->keepers.getKeeper(keeper); }
+
+        // call f_ with all the arguments of the method, with the keeper holding the slot acquired
+        [[nodiscard]]
+        static int ProtectedCall(lua_State* const L_, lua_CFunction const f_)
+        {
+            SlotHandle const* const _handle{ ToSlotHandle(L_, StackIndex{ 1 }) };
+            return _handle->linda->protectedCall(L_, f_, _handle->keeper, lua_gettop(L_));
+        }
+
+        // in: handle args...
+        // out: handle ref args...
+        // the keeper functions of the handle expect the reference of the pinned KeyUD where the slot is usually found
+        void insertRef(lua_State* const L_) const
+        {
+            STACK_GROW(L_, 1);
+            lua_pushinteger(L_, ref);                                                              // L_: handle args... ref
+            lua_insert(L_, 2);                                                                     // L_: handle ref args...
+        }
+
+        [[nodiscard]]
+        static SlotHandle* ToSlotHandle(lua_State* const L_, StackIndex const idx_)
+        {
+            return static_cast<SlotHandle*>(luaL_checkudata(L_, idx_, kMetatableName.data()));
+        }
+    };
+
+    // #############################################################################################
+
+    // slot:__gc()
+    // unpin the KeyUD of the slot, and release our reference on the linda
+    static LUAG_FUNC(slot_gc)
+    {
+        SlotHandle const* const _handle{ SlotHandle::ToSlotHandle(L_, StackIndex{ 1 }) };
+        Linda* const _linda{ _handle->linda };
+        // if collected after the universe, keepers are already destroyed, and there is nothing to unpin
+        Keeper* const _keeper{ _linda->acquireKeeper(_handle->keeper) };
+        if (_keeper) {
+            lua_settop(L_, 1);                                                                     // L_: handle
+            _handle->insertRef(L_);                                                                // L_: handle ref
+            [[maybe_unused]] KeeperCallResult const _pushed{ keeper_call(*_keeper, KEEPER_API(slot_unpin), L_, _linda, StackIndex{ 2 }) };
+            LUA_ASSERT(L_, _pushed.has_value() && _pushed.value() == 0);
+            _linda->releaseKeeper(_keeper);
+        }
+        if (_linda->releaseRef()) {
+            DeepFactory::DeleteDeepObject(L_, _linda);
+        }
+        return 0;
+    }
+
+    // #############################################################################################
+
+    // count, [val [, ...]]|nil,cancel_error = slot:get([count = 1])
+    static LUAG_FUNC(slot_get)
+    {
+        static constexpr lua_CFunction _get{
+            +[](lua_State* const L_) {
+                SlotHandle const* const _handle{ SlotHandle::ToSlotHandle(L_, StackIndex{ 1 }) };
+                lua_Integer const _count{ luaL_optinteger(L_, 2, 1) };
+                luaL_argcheck(L_, _count >= 1, 2, "count should be >= 1");
+                luaL_argcheck(L_, lua_gettop(L_) <= 2, 3, "too many arguments");
+
+                KeeperCallResult _pushed;
+                if (_handle->linda->cancelStatus == Linda::Active) {
+                    lua_settop(L_, 1);                                                             // L_: handle
+                    lua_pushinteger(L_, _count);                                                   // L_: handle count
+                    _handle->insertRef(L_);                                                        // L_: handle ref count
+                    _pushed = keeper_call(_handle->getKeeper(), KEEPER_API(slot_get), L_, _handle->linda, StackIndex{ 2 });
+                    if (_pushed.has_value() && kRestrictedChannel.equals(L_, kIdxTop)) {
+                        raise_luaL_error(L_, "Key is restricted");
+                    }
+                } else { // linda is cancelled
+                    // do nothing and return nil,lanes.cancel_error
+                    lua_pushnil(L_);
+                    kCancelError.pushKey(L_);
+                    _pushed.emplace(2);
                 }
+                // an error can be raised if we attempt to read an unregistered function
+                return OptionalValue(_pushed, L_, "tried to copy unsupported types");
+            }
+        };
+        return SlotHandle::ProtectedCall(L_, _get);
+    }
 
-                // all arguments of send() but the first are passed to the keeper's send function
-                STACK_CHECK(_K, 0);
-                _pushed = keeper_call(_K, KEEPER_API(send), L_, _linda, _key_i);
+    // #############################################################################################
+
+    // val|(nil,"timeout")|(nil,cancel_error) = slot:receive([timeout_secs_num=nil])
+    static LUAG_FUNC(slot_receive)
+    {
+        static constexpr lua_CFunction _receive{
+            +[](lua_State* const L_) {
+                SlotHandle const* const _handle{ SlotHandle::ToSlotHandle(L_, StackIndex{ 1 }) };
+                luaL_argcheck(L_, lua_gettop(L_) <= 2, 3, "too many arguments");
+                if (!lua_isnoneornil(L_, 2)) {
+                    luaL_checktype(L_, 2, LUA_TNUMBER);
+                }
+                [[maybe_unused]] auto const [_key_i, _until] = ProcessTimeoutArg(L_);
+                lua_settop(L_, 1);                                                                 // L_: handle
+                _handle->insertRef(L_);                                                            // L_: handle ref
+
+                Lane* const _lane{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
+                // a single value written in the slot is enough to satisfy us
+                std::condition_variable _condVar; // only used when we are not running inside a lane
+                Linda::Waiter _waiter{ (_lane != nullptr) ? _lane->lindaCondVar : _condVar, Linda::Waiter::Kind::Reader, true };
+                _waiter.slots[0] = _handle->slot;
+                _waiter.nbSlots = 1;
+                auto const [_cancel, _pushed] = ReceiveFromKeeper(L_, _lane, _handle->linda, _handle->keeper, _waiter, _until, KEEPER_API(slot_receive), StackIndex{ 2 }, _handle->slot);
                 if (!_pushed.has_value()) {
-                    break;
+                    raise_luaL_error(L_, "tried to copy unsupported types");
                 }
-                LUA_ASSERT(L_, _pushed.value() == 1);
 
-                if (kRestrictedChannel.equals(L_, StackIndex{ kIdxTop })) {
-                    raise_luaL_error(L_, "Key is restricted");
+                if (_cancel == CancelRequest::None) {
+                    if (_pushed.value() > 0) {
+                        LUA_ASSERT(L_, _pushed.value() == 1);
+                        return 1;
+                    }
+                    _handle->linda->stats.receiveTimeouts.fetch_add(1, std::memory_order_relaxed);
                 }
-                _ret = lua_toboolean(L_, -1) ? true : false;
-                lua_pop(L_, 1);
+                return PushReceiveFailure(L_, _cancel);
+            }
+        };
+        return SlotHandle::ProtectedCall(L_, _receive);
+    }
 
-                if (_ret) {
-                    // Wake up ALL waiting threads
-                    _linda->writeHappened.notify_all();
-                    break;
-                }
+    // #############################################################################################
+
+    // true|nil,cancel_error = slot:send(val [, ...])
+    // there is no timeout: a number would be indistinguishable from the first value to send
+    static LUAG_FUNC(slot_send)
+    {
+        static constexpr lua_CFunction _send{
+            +[](lua_State* const L_) {
+                SlotHandle const* const _handle{ SlotHandle::ToSlotHandle(L_, StackIndex{ 1 }) };
+                _handle->insertRef(L_);                                                            // L_: handle ref val...
+                return SendInternal(L_, _handle->linda, StackIndex{ 2 }, std::chrono::time_point<std::chrono::steady_clock>::max(), _handle->slot, KEEPER_API(slot_send), KEEPER_API(slot_send_packed));
+            }
+        };
+        return SlotHandle::ProtectedCall(L_, _send);
+    }
 
-                // instant timout to bypass the wait syscall
-                if (std::chrono::steady_clock::now() >= _until) {
-                    break; /* no wait; instant timeout */
+    // #############################################################################################
+
+    // (boolean,string)|(nil,cancel_error) = slot:set([value [, ...]])
+    static LUAG_FUNC(slot_set)
+    {
+        static constexpr lua_CFunction _set{
+            +[](lua_State* const L_) {
+                SlotHandle const* const _handle{ SlotHandle::ToSlotHandle(L_, StackIndex{ 1 }) };
+                Linda* const _linda{ _handle->linda };
+                bool const _has_data{ lua_gettop(L_) > 1 };
+
+                KeeperCallResult _pushed;
+                if (_linda->cancelStatus == Linda::Active) {
+                    _handle->insertRef(L_);                                                        // L_: handle ref val...
+                    _pushed = keeper_call(_handle->getKeeper(), KEEPER_API(slot_set), L_, _linda, StackIndex{ 2 });
+                    if (_pushed.has_value()) { // no error?
+                        if (kRestrictedChannel.equals(L_, kIdxTop)) {
+                            raise_luaL_error(L_, "Key is restricted");
+                        }
+                        LUA_ASSERT(L_, _pushed.value() == 2 && luaW_type(L_, kIdxTop) == LuaType::STRING && luaW_type(L_, StackIndex{ -2 }) == LuaType::BOOLEAN);
+                        if (_has_data) {
+                            // we put some data in the slot, tell readers that they should wake
+                            _linda->wakeWaiters(Linda::Waiter::Kind::Reader, _handle->slot, Linda::WakeMode::All); // To be done from within the 'K' locking area
+                        }
+                        if (lua_toboolean(L_, -2)) {
+                            // the slot was full, but it is no longer the case, tell writers they should wake
+                            _linda->wakeWaiters(Linda::Waiter::Kind::Writer, _handle->slot, Linda::WakeMode::All); // To be done from within the 'K' locking area
+                        }
+                    }
+                } else { // linda is cancelled
+                    // do nothing and return nil,lanes.cancel_error
+                    lua_pushnil(L_);
+                    kCancelError.pushKey(L_);
+                    _pushed.emplace(2);
                 }
 
-                // storage limit hit, wait until timeout or signalled that we should try again
-                _try_again = WaitInternal(L_, _lane, _linda, _keeper, _linda->readHappened, _until);
+                // must trigger any error after keeper state has been released
+                return OptionalValue(_pushed, L_, "tried to copy unsupported types");
             }
-            STACK_CHECK(_K, 0);
+        };
+        return SlotHandle::ProtectedCall(L_, _set);
+    }
+
+    // #############################################################################################
+
+    namespace local {
+        static luaL_Reg const sSlotHandleMT[] = {
+            { "__gc", LG_slot_gc },
+            { "get", LG_slot_get },
+            { "receive", LG_slot_receive },
+            { "send", LG_slot_send },
+            { "set", LG_slot_set },
+            { nullptr, nullptr }
+        };
+    } // namespace local
+
+    // #############################################################################################
+
+    // out: a new slot handle
+    static void PushSlotHandle(lua_State* const L_, Linda* const linda_, KeeperIndex const keeper_, LindaSlotId const slot_, lua_Integer const ref_)
+    {
+        STACK_GROW(L_, 3);
+        STACK_CHECK_START_REL(L_, 0);
+        new (luaW_newuserdatauv<SlotHandle>(L_, UserValueCount{ 0 })) SlotHandle{ linda_, keeper_, slot_, ref_ }; // L_: handle
+        linda_->addRef();
+        if (luaL_newmetatable(L_, SlotHandle::kMetatableName.data())) {                            // L_: handle mt
+            luaW_registerlibfuncs(L_, local::sSlotHandleMT);
+            lua_pushvalue(L_, -1);                                                                 // L_: handle mt mt
+            lua_setfield(L_, -2, "__index");                                                       // L_: handle mt
+        }
+        lua_setmetatable(L_, -2);                                                                  // L_: handle
+        STACK_CHECK(L_, 1);
+    }
+
+    // #############################################################################################
+    // #############################################################################################
+} // namespace
+// #################################################################################################
+// #################################################################################################
+
+/*
+ * slot = linda:slot(key_num|str|bool|lightuserdata)
+ *
+ * Return a handle on a slot of the linda, with methods send(), receive(), get() and set().
+ * They don't have to validate the slot, copy it in the keeper, and look it up there, as linda:send() and the likes do.
+ */
+LUAG_FUNC(linda_slot)
+{
+    static constexpr lua_CFunction _slot{
+        +[](lua_State* const L_) {
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+            luaL_argcheck(L_, lua_gettop(L_) <= 2, 3, "too many arguments");
+            // make sure the slot is of a valid type (throws an error if not the case)
+            CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ 2 });
 
+            LindaSlotId const _slot{ Linda::SlotId(L_, StackIndex{ 2 }) };
+            KeeperIndex const _keeperIndex{ _linda->keeperIndexOf(_slot) };
+            KeeperCallResult const _pushed{ keeper_call(*_linda->U->keepers.getKeeper(_keeperIndex), KEEPER_API(slot_pin), L_, _linda, StackIndex{ 2 }) };
             if (!_pushed.has_value()) {
                 raise_luaL_error(L_, "tried to copy unsupported types");
             }
+            LUA_ASSERT(L_, _pushed.value() == 1 && luaW_type(L_, kIdxTop) == LuaType::NUMBER);    // L_: linda slot ref
+            PushSlotHandle(L_, _linda, _keeperIndex, _slot, lua_tointeger(L_, -1));               // L_: linda slot ref handle
+            return 1;
+        }
+    };
+    return Linda::ProtectedCall(L_, _slot);
+}
 
-            switch (_cancel) {
-            case CancelRequest::Soft:
-                // if user wants to soft-cancel, the call returns nil, kCancelError
-                lua_pushnil(L_);
-                kCancelError.pushKey(L_);
-                return 2;
-
-            case CancelRequest::Hard:
-                // raise an error interrupting execution only in case of hard cancel
-                raise_cancel_error(L_); // raises an error and doesn't return
+// #################################################################################################
 
-            default:
-                if (_ret) {
-                    lua_pushboolean(L_, _ret); // true (success)
-                    return 1;
-                } else {
-                    // not enough room in the Linda slot to fulfill the request, return nil, "timeout"
-                    lua_pushnil(L_);
-                    luaW_pushstring(L_, "timeout");
-                    return 2;
-                }
+/*
+ * table = linda:stats()
+ *
+ * Return the traffic counters of the linda, of its slots, and the contention counters of the keepers holding them
+ */
+LUAG_FUNC(linda_stats)
+{
+    static constexpr lua_CFunction _stats{
+        +[](lua_State* const L_) {
+            Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };                            // L_: linda keeper
+            KeeperIndex const _keeperIndex{ static_cast<KeeperIndex::type>(lua_tointeger(L_, 2)) };
+            _linda->U->keepers.getKeeper(_keeperIndex)->pushStats(L_);                             // L_: linda keeper kstats
+            if (Keeper::PushLindaStats(*_linda, _keeperIndex, DestState{ L_ }) == 0) {             // L_: linda keeper kstats [slots]
+                lua_newtable(L_);                                                                  // L_: linda keeper kstats slots
             }
+            return 2;
         }
     };
-    return Linda::ProtectedCall(L_, _send);
+    auto _pushCounter = [L_](std::string_view const& name_, std::atomic<uint64_t> const& counter_) {
+        lua_pushinteger(L_, static_cast<lua_Integer>(counter_.load(std::memory_order_relaxed)));
+        luaW_setfield(L_, StackIndex{ -2 }, name_);
+    };
+    auto _pushDuration = [L_](std::string_view const& name_, std::atomic<std::chrono::steady_clock::rep> const& ticks_) {
+        std::chrono::steady_clock::duration const _duration{ ticks_.load(std::memory_order_relaxed) };
+        lua_pushnumber(L_, std::chrono::duration_cast<lua_Duration>(_duration).count());
+        luaW_setfield(L_, StackIndex{ -2 }, name_);
+    };
+
+    Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
+    lua_settop(L_, 1);                                                                             // L_: linda
+    STACK_GROW(L_, 6);
+    lua_createtable(L_, 0, 10);                                                                    // L_: linda out
+    Linda::Stats const& _lindaStats{ _linda->stats };
+    _pushCounter("sends", _lindaStats.sends);
+    _pushCounter("receives", _lindaStats.receives);
+    _pushCounter("bytes", _lindaStats.bytes);
+    _pushCounter("send_timeouts", _lindaStats.sendTimeouts);
+    _pushCounter("receive_timeouts", _lindaStats.receiveTimeouts);
+    _pushCounter("dropped_posts", _lindaStats.droppedPosts);
+    _pushDuration("send_wait", _lindaStats.sendWait);
+    _pushDuration("receive_wait", _lindaStats.receiveWait);
+    lua_newtable(L_);                                                                              // L_: linda out keepers
+    lua_newtable(L_);                                                                              // L_: linda out keepers slots
+    // the slots of a sharded linda are spread over all keepers: merge their counters
+    for (int const _shard : std::ranges::iota_view{ 0, _linda->getNbShards() }) {
+        KeeperIndex const _keeperIndex{ _linda->getShardKeeper(_shard) };
+        lua_pushvalue(L_, 1);                                                                      // L_: linda out keepers slots linda
+        lua_pushinteger(L_, _keeperIndex);                                                         // L_: linda out keepers slots linda keeper
+        if (_linda->protectedCall(L_, _stats, _keeperIndex, 2) == 2) {                             // L_: linda out keepers slots kstats kslots
+            lua_insert(L_, -2);                                                                    // L_: linda out keepers slots kslots kstats
+            lua_rawseti(L_, -4, _keeperIndex);                                                     // L_: linda out keepers slots kslots
+            MergeTables(L_);                                                                       // L_: linda out keepers slots
+        }
+    }
+    lua_setfield(L_, -3, "slots");                                                                 // L_: linda out keepers
+    lua_setfield(L_, -2, "keepers");                                                               // L_: linda out
+    return 1;
 }
 
 // #################################################################################################
 
 /*
- * (boolean,string)|(nil,lanes.cancel_error) = linda:set(key_num|str|bool|lightuserdata [, value [, ...]])
- *
- * Set one or more value to Linda. Ignores limits.
+ * value|(nil,cancel_error) = linda:swap(key_num|str|bool|lightuserdata, value)
  *
- * Existing slot value is replaced, and possible queued entries removed.
+ * Atomically replace the value of a slot, with a single keeper operation. Storing nil empties the slot.
+ * Return the previous value, as linda:get() would have read it.
  */
-LUAG_FUNC(linda_set)
+LUAG_FUNC(linda_swap)
 {
-    static constexpr lua_CFunction _set{
+    static constexpr lua_CFunction _swap{
         +[](lua_State* const L_) {
             Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
-            bool const _has_data{ lua_gettop(L_) > 2 };
+            luaL_argcheck(L_, lua_gettop(L_) <= 3, 4, "too many arguments");
             // make sure the slot is of a valid type (throws an error if not the case)
             CheckKeyTypes(L_, StackIndex{ 2 }, StackIndex{ 2 });
+            lua_settop(L_, 3);                                                                     // L_: linda slot value
 
             KeeperCallResult _pushed;
             if (_linda->cancelStatus == Linda::Active) {
-                Keeper* const _keeper{ _linda->whichKeeper() };
-                _pushed = keeper_call(_keeper->K, KEEPER_API(set), L_, _linda, StackIndex{ 2 });
+                Keeper* const _keeper{ _linda->whichKeeper(L_, StackIndex{ 2 }) };
+                _pushed = keeper_call(*_keeper, KEEPER_API(swap), L_, _linda, StackIndex{ 2 });
                 if (_pushed.has_value()) { // no error?
                     if (kRestrictedChannel.equals(L_, kIdxTop)) {
                         raise_luaL_error(L_, "Key is restricted");
                     }
-                    LUA_ASSERT(L_, _pushed.value() == 2 && luaW_type(L_, kIdxTop) == LuaType::STRING && luaW_type(L_, StackIndex{ -2 }) == LuaType::BOOLEAN);
-
-                    if (_has_data) {
-                        // we put some data in the slot, tell readers that they should wake
-                        _linda->writeHappened.notify_all(); // To be done from within the 'K' locking area
-                    }
-                    if (lua_toboolean(L_, -2)) {
-                        // the slot was full, but it is no longer the case, tell writers they should wake
-                        _linda->readHappened.notify_all(); // To be done from within the 'K' locking area
-                    }
+                    LUA_ASSERT(L_, _pushed.value() == 2 && luaW_type(L_, StackIndex{ -2 }) == LuaType::BOOLEAN); // L_: linda slot value wasFull old
+                    WakeAfterReplace(_linda, Linda::SlotId(L_, StackIndex{ 2 }), lua_toboolean(L_, -2) ? true : false);
+                    lua_remove(L_, -2);                                                            // L_: linda slot value old
+                    _pushed.emplace(1);
                 }
             } else { // linda is cancelled
                 // do nothing and return nil,lanes.cancel_error
@@ -1034,12 +2603,11 @@ LUAG_FUNC(linda_set)
                 kCancelError.pushKey(L_);
                 _pushed.emplace(2);
             }
-
             // must trigger any error after keeper state has been released
             return OptionalValue(_pushed, L_, "tried to copy unsupported types");
         }
     };
-    return Linda::ProtectedCall(L_, _set);
+    return Linda::ProtectedCall(L_, _swap);
 }
 
 // #################################################################################################
@@ -1059,7 +2627,12 @@ LUAG_FUNC(linda_tostring)
 LUAG_FUNC(linda_towatch)
 {
     Linda* const _linda{ ToLinda<false>(L_, StackIndex{ 1 }) };
-    int _pushed{ Keeper::PushLindaStorage(*_linda, DestState{ L_ }) };
+    int _pushed{ 0 };
+    for (int const _shard : std::ranges::iota_view{ 0, _linda->getNbShards() }) {
+        if (Keeper::PushLindaStorage(*_linda, _linda->getShardKeeper(_shard), DestState{ L_ }) == 1 && std::exchange(_pushed, 1) == 1) {
+            MergeTables(L_);
+        }
+    }
     if (_pushed == 0) {
         // if the linda is empty, don't return nil
         _pushed = LindaToString<false>(L_, StackIndex{ 1 });
@@ -1083,16 +2656,18 @@ LUAG_FUNC(linda_wake)
     // make sure we got 2 arguments: the linda and the wake targets
     luaL_argcheck(L_, lua_gettop(L_) <= 2, 2, "wrong number of arguments");
 
-    if (_who == "both") { // tell everyone to wake up
-        _linda->writeHappened.notify_all();
-        _linda->readHappened.notify_all();
-    } else if (_who == "read") { // simulate a read to wake writers
-        _linda->writeHappened.notify_all();
-    } else if (_who == "write") { // simulate a write to wake readers
-        _linda->readHappened.notify_all();
-    } else {
+    if (_who != "both" && _who != "read" && _who != "write") {
         raise_luaL_error(L_, "unknown wake hint '%s'", _who.data());
     }
+
+    if (_who == "both") { // tell everyone to wake up
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Reader);
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Writer);
+    } else if (_who == "read") { // tell blocked readers to wake up
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Reader);
+    } else if (_who == "write") { // tell blocked writers to wake up
+        _linda->wakeAllWaiters(Linda::Waiter::Kind::Writer);
+    }
     return 0;
 }
 
@@ -1110,18 +2685,26 @@ namespace {
 #if HAVE_DECODA_SUPPORT()
             { "__towatch", LG_linda_towatch }, // Decoda __towatch support
 #endif // HAVE_DECODA_SUPPORT()
+            { "batch", LG_linda_batch },
             { "cancel", LG_linda_cancel },
+            { "cas", LG_linda_cas },
             { "collectgarbage", LG_linda_collectgarbage },
             { "count", LG_linda_count },
             { "deep", LG_linda_deep },
             { "dump", LG_linda_dump },
+            { "fd", LG_linda_fd },
             { "get", LG_linda_get },
+            { "incr", LG_linda_incr },
             { "limit", LG_linda_limit },
+            { "post", LG_linda_post },
             { "receive", LG_linda_receive },
             { "receive_batched", LG_linda_receive_batched },
             { "restrict", LG_linda_restrict },
             { "send", LG_linda_send },
             { "set", LG_linda_set },
+            { "slot", LG_linda_slot },
+            { "stats", LG_linda_stats },
+            { "swap", LG_linda_swap },
             { "wake", LG_linda_wake },
             { nullptr, nullptr }
         };
@@ -1135,17 +2718,17 @@ namespace {
 // #################################################################################################
 
 /*
- * ud = lanes.linda{.name = <string>, .group = <number>, .close_handler = <callable>, .wake_period = <number>}
+ * ud = lanes.linda{.name = <string>, .group = <number>, .sharded = <boolean>, .close_handler = <callable>, .wake_period = <number>, .spin = <number>}
  *
  * returns a linda object, or raises an error if creation failed
  */
 LUAG_FUNC(linda)
 {
-    // unpack the received table on the stack, putting name wake_period group close_handler in that order
+    // unpack the received table on the stack, putting name wake_period group sharded spin close_handler in that order
     StackIndex const _top{ lua_gettop(L_) };
     luaL_argcheck(L_, _top <= 1, _top, "too many arguments");
     if (_top == 0) {
-        lua_settop(L_, 3);                                                                         // L_: nil nil nil
+        lua_settop(L_, 5);                                                                         // L_: nil nil nil nil nil
     }
     else if (!lua_istable(L_, kIdxTop)) {
         luaL_argerror(L_, 1, "expecting a table");
@@ -1168,19 +2751,30 @@ LUAG_FUNC(linda)
         }
 
         lua_getfield(L_, 1, "group");                                                              // L_: {} wake_period group
+        lua_getfield(L_, 1, "sharded");                                                            // L_: {} wake_period group sharded
+        LuaType const _shardedType{ luaW_type(L_, kIdxTop) };
+        luaL_argcheck(L_, _shardedType == LuaType::NIL || _shardedType == LuaType::BOOLEAN, 1, "sharded is not a boolean");
         int const _nbKeepers{ _U->keepers.getNbKeepers() };
-        if (lua_isnil(L_, kIdxTop)) {
+        if (lua_toboolean(L_, kIdxTop)) {
+            // the slots are spread over all keepers
+            luaL_argcheck(L_, lua_isnil(L_, -2), 1, "a sharded linda can't have a group");
+        } else if (lua_isnil(L_, -2)) {
             luaL_argcheck(L_, _nbKeepers < 2, 0, "Group is mandatory in multiple Keeper scenarios");
         } else {
-            int const _group{ static_cast<int>(lua_tointeger(L_, kIdxTop)) };
+            int const _group{ static_cast<int>(lua_tointeger(L_, -2)) };
             luaL_argcheck(L_, _group >= 0 && _group < _nbKeepers, 1, "group out of range");
         }
 
+        lua_getfield(L_, 1, "spin");                                                               // L_: {} wake_period group sharded spin
+        LuaType const _spinType{ luaW_type(L_, kIdxTop) };
+        luaL_argcheck(L_, _spinType == LuaType::NIL || _spinType == LuaType::NUMBER, 1, "spin is not a number");
+        luaL_argcheck(L_, _spinType == LuaType::NIL || lua_tonumber(L_, kIdxTop) >= 0, 1, "spin must be >= 0");
+
 #if LUA_VERSION_NUM >= 504 // to-be-closed support starts with Lua 5.4
-        lua_getfield(L_, 1, "close_handler");                                                      // L_: {} wake_period group close_handler
+        lua_getfield(L_, 1, "close_handler");                                                      // L_: {} wake_period group sharded spin close_handler
         LuaType const _handlerType{ luaW_type(L_, kIdxTop) };
         if (_handlerType == LuaType::NIL) {
-            lua_pop(L_, 1);                                                                        // L_: {} wake_period group
+            lua_pop(L_, 1);                                                                        // L_: {} wake_period group sharded spin
         } else if (_handlerType == LuaType::USERDATA || _handlerType == LuaType::TABLE) {
             luaL_argcheck(L_, luaL_getmetafield(L_, kIdxTop, "__call") != 0, 1, "__close handler is not callable");
             lua_pop(L_, 1); // luaL_getmetafield() pushed the field, we need to pop it
@@ -1189,23 +2783,90 @@ LUAG_FUNC(linda)
         }
 #endif // LUA_VERSION_NUM >= 504
 
-        auto const _nameType{ luaW_getfield(L_, StackIndex{ 1 }, "name") };                        // L_: {} wake_period group [close_handler] name
+        auto const _nameType{ luaW_getfield(L_, StackIndex{ 1 }, "name") };                        // L_: {} wake_period group sharded spin [close_handler] name
         luaL_argcheck(L_, _nameType == LuaType::NIL || _nameType == LuaType::STRING, 1, "name is not a string");
-        lua_replace(L_, 1);                                                                        // L_: name wake_period group [close_handler]
+        lua_replace(L_, 1);                                                                        // L_: name wake_period group sharded spin [close_handler]
     }
 
     // done with argument checking, let's proceed
-    if (lua_gettop(L_) == 4) {
+    if (lua_gettop(L_) == 6) {
         // if we have a __close handler, we need a uservalue slot to store it
-        LindaFactory::Instance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 1 });             // L_: name wake_period group [close_handler] linda
-        lua_replace(L_, 3);                                                                        // L_: name wake_period linda close_handler
-        lua_setiuservalue(L_, StackIndex{ 3 }, UserValueIndex{ 1 });                               // L_: name wake_period linda
+        LindaFactory::Instance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 1 });             // L_: name wake_period group sharded spin close_handler linda
+        lua_replace(L_, 5);                                                                        // L_: name wake_period group sharded linda close_handler
+        lua_setiuservalue(L_, StackIndex{ 5 }, UserValueIndex{ 1 });                               // L_: name wake_period group sharded linda
         // depending on whether we have a handler or not, the stack is not in the same state at this point
         // just make sure we have our Linda at the top
         LUA_ASSERT(L_, ToLinda<true>(L_, kIdxTop));
         return 1;
     } else { // no to-be-closed support
-        LindaFactory::Instance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 0 });             // L_: name wake_period group linda
+        LindaFactory::Instance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 0 });             // L_: name wake_period group sharded spin linda
         return 1;
     }
 }
+
+// #################################################################################################
+
+/*
+ * [linda, slot, value]|[nil, "timeout"]|[nil, lanes.cancel_error] = lanes.select([timeout,] {{linda, slot [, slot...]}, ...})
+ *
+ * Consumes a single value from the first of the listed slots that has data, the slots possibly belonging to different lindas.
+ * Returns the linda and the slot the value was read from, and the value.
+ */
+LUAG_FUNC(select)
+{
+    // the timeout is optional, if present the table of sources comes second
+    StackIndex const _sources_i{ (lua_gettop(L_) > 1) ? 2 : 1 };
+    std::chrono::time_point<std::chrono::steady_clock> _until{ std::chrono::time_point<std::chrono::steady_clock>::max() };
+    if (_sources_i == 2 && !lua_isnil(L_, 1)) {
+        lua_Duration const _duration{ luaL_checknumber(L_, 1) };
+        if (_duration.count() < 0.0) {
+            raise_luaL_argerror(L_, StackIndex{ 1 }, "duration cannot be < 0");
+        }
+        _until = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(_duration);
+    }
+    luaL_checktype(L_, _sources_i, LUA_TTABLE);
+    lua_settop(L_, _sources_i);                                                                    // L_: [timeout] {}
+    int const _nbSources{ static_cast<int>(lua_rawlen(L_, _sources_i)) };
+    luaL_argcheck(L_, _nbSources > 0, _sources_i, "nothing to select from");
+
+    Lane* const _lane{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
+    std::condition_variable _condVar; // only used when we are not running inside a lane
+    std::mutex _guard; // ditto
+    ReceiveSources _sources{ (_lane != nullptr) ? _lane->lindaCondVar : _condVar, (_lane != nullptr) ? _lane->lindaMutex : _guard };
+
+    // unpack each {linda, slot...} entry on the stack, and register its slots
+    for (int const _i : std::ranges::iota_view{ 1, _nbSources + 1 }) {
+        lua_rawgeti(L_, _sources_i, _i);                                                           // L_: [timeout] {} ... {linda, slot...}
+        if (!lua_istable(L_, kIdxTop)) {
+            raise_luaL_error(L_, "source #%d: expecting a {linda, slot...} table", _i);
+        }
+        StackIndex const _source_i{ lua_gettop(L_) };
+        int const _nbSlots{ static_cast<int>(lua_rawlen(L_, _source_i)) - 1 };
+        STACK_GROW(L_, 1 + _nbSlots);
+        lua_rawgeti(L_, _source_i, 1);                                                             // L_: [timeout] {} ... {linda, slot...} linda
+        Linda* const _linda{ ToLinda<true>(L_, kIdxTop) };
+        if (_linda == nullptr || _nbSlots < 1) {
+            raise_luaL_error(L_, "source #%d: expecting a linda followed by at least one slot", _i);
+        }
+        LUA_ASSERT(L_, _linda->U == Universe::Get(L_));
+        for (int const _j : std::ranges::iota_view{ 2, _nbSlots + 2 }) {
+            lua_rawgeti(L_, _source_i, _j);                                                        // L_: [timeout] {} ... {linda, slot...} linda slot...
+        }
+        lua_remove(L_, _source_i);                                                                 // L_: [timeout] {} ... linda slot...
+        CheckKeyTypes(L_, StackIndex{ _source_i + 1 }, StackIndex{ lua_gettop(L_) });
+        for (StackIndex const _j : std::ranges::iota_view{ StackIndex{ _source_i + 1 }, StackIndex{ lua_gettop(L_) + 1 } }) {
+            _sources.add(L_, _linda, _source_i, _j);
+        }
+    }
+
+    auto const [_cancel, _pushed] = ReceiveAcrossKeepers(L_, _lane, _sources, _until);
+    if (_cancel == CancelRequest::None) {
+        if (_pushed > 0) {                                                                         // L_: [timeout] {} ... slot value
+            lua_pushvalue(L_, _sources.getGroup(_sources.received).lindaIdx);                      // L_: [timeout] {} ... slot value linda
+            lua_insert(L_, -3);                                                                    // L_: [timeout] {} ... linda slot value
+            return 3;
+        }
+        _sources.forEachLinda([](Linda& linda_) { linda_.stats.receiveTimeouts.fetch_add(1, std::memory_order_relaxed); });
+    }
+    return PushReceiveFailure(L_, _cancel);
+}
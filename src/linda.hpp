@@ -9,6 +9,8 @@ struct Keeper;
 // #################################################################################################
 
 DECLARE_UNIQUE_TYPE(LindaGroup, int);
+// a hash of a slot key, computed identically in any state, used to match waiters with the slots they wait on
+DECLARE_UNIQUE_TYPE(LindaSlotId, uint64_t);
 
 class Linda final
 : public DeepPrelude // Deep userdata MUST start with this header
@@ -22,10 +24,103 @@ class Linda final
     };
     using enum Status;
 
+    enum class [[nodiscard]] WakeMode
+    {
+        One, // wake waiters until one that is guaranteed to consume what was made available
+        All
+    };
+
+    private:
+    struct WaiterList;
+
+    public:
+    // a thread blocked inside linda:send() or linda:receive(), registered on the slots it waits on
+    // all accesses are done with the mutex of the keeper holding these slots
+    struct Waiter
+    {
+        enum class [[nodiscard]] Kind
+        {
+            Reader, // waits for data to be written in a slot
+            Writer // waits for room to be made in a slot
+        };
+        // beyond that many slots, the waiter is woken by an operation on any slot
+        static constexpr size_t kMaxSlots{ 8 };
+
+        std::condition_variable& condVar;
+        Kind const kind;
+        // true if a single value written in its slot is enough for this waiter to complete
+        bool const exclusive;
+        std::array<LindaSlotId, kMaxSlots> slots{};
+        size_t nbSlots{}; // 0 means any slot
+        bool signalled{ false };
+        // a waiter spins at most once per operation, so that traffic on unrelated slots can't prevent it from blocking
+        bool spun{ false };
+        // when set, the waiter sleeps on this mutex instead of the keeper's, and must be signalled with it held
+        std::mutex* guard{ nullptr };
+        WaiterList* list{ nullptr };
+        Waiter* prev{ nullptr };
+        Waiter* next{ nullptr };
+
+        void signal()
+        {
+            std::unique_lock<std::mutex> _guard{};
+            if (guard != nullptr) {
+                _guard = std::unique_lock<std::mutex>{ *guard };
+            }
+            signalled = true;
+            condVar.notify_one();
+        }
+
+        [[nodiscard]]
+        bool waitsOn(LindaSlotId const slot_) const
+        {
+            return (nbSlots == 0) || std::ranges::find(std::span{ slots.data(), nbSlots }, slot_) != std::span{ slots.data(), nbSlots }.end();
+        }
+    };
+
+    // traffic counters, as reported by linda:stats()
+    struct Stats
+    {
+        std::atomic<uint64_t> sends{}; // values sent
+        std::atomic<uint64_t> receives{}; // values received
+        std::atomic<uint64_t> bytes{}; // of the values sent that were serialized in native memory
+        std::atomic<uint64_t> sendTimeouts{};
+        std::atomic<uint64_t> receiveTimeouts{};
+        std::atomic<uint64_t> droppedPosts{}; // values posted by linda:post() that the slot didn't accept
+        // cumulative time spent blocked in an operation, in std::chrono::steady_clock ticks
+        std::atomic<std::chrono::steady_clock::rep> sendWait{};
+        std::atomic<std::chrono::steady_clock::rep> receiveWait{};
+    };
+
     public:
     Universe* const U{ nullptr }; // the universe this linda belongs to
 
     private:
+    // a file descriptor made readable each time a value is written in a slot, so that external event loops can wait on it
+    struct Notifier
+    {
+        int const fd;
+        LindaSlotId const slot;
+        Notifier* next{ nullptr };
+    };
+
+    // the waiters registered with a keeper, in arrival order
+    struct WaiterList
+    {
+        Waiter* first{ nullptr };
+        Waiter* last{ nullptr };
+        // bumped each time readers are woken, so that a thread that polled the keeper before registering can tell it missed a write
+        uint64_t writes{};
+        // bumped each time waiters are woken, polled without the keeper mutex by threads spinning before they block
+        std::atomic<uint64_t> events{};
+        // the notifiers of the slots held by the keeper
+        Notifier* notifiers{ nullptr };
+    };
+
+    // a LindaSlotId holds the type of the slot in its high bits, then kSlotIdHashed if the rest is a hash of the slot instead of its value
+    static constexpr int kSlotIdTypeShift{ 61 };
+    static constexpr uint64_t kSlotIdHashed{ uint64_t{ 1 } << 60 };
+
     static constexpr size_t kEmbeddedNameLength = 24;
     using EmbeddedName = std::array<char, kEmbeddedNameLength>;
     // depending on the name length, it is either embedded inside the Linda, or allocated separately
@@ -33,12 +128,19 @@ class Linda final
     // counts the keeper operations in progress
     mutable std::atomic<int> keeperOperationCount{};
     lua_Duration wakePeriod{};
+    // how long a thread busy-waits for the operation to become possible before it blocks
+    std::chrono::steady_clock::duration spinDuration{};
+    // threads blocked in an operation on this linda: a sharded linda has one list per keeper, each protected by the mutex of its keeper
+    WaiterList ownWaiters{};
+    std::span<WaiterList> waiterLists{};
+    // the notifier of writes in any slot, created on demand
+    std::atomic<int> anyNotifier{ -1 };
 
     public:
-    std::condition_variable readHappened{};
-    std::condition_variable writeHappened{};
-    KeeperIndex const keeperIndex{ -1 }; // the keeper associated to this linda
-    Status cancelStatus{ Status::Active };
+    KeeperIndex const keeperIndex{ -1 }; // the keeper associated to this linda, if it is not sharded
+    bool const sharded{ false }; // if true, each slot is held by a keeper selected by hashing the slot
+    std::atomic<Status> cancelStatus{ Status::Active };
+    Stats stats{};
 
     public:
     [[nodiscard]]
@@ -50,7 +152,7 @@ class Linda final
     static void operator delete(void* p_) { static_cast<Linda*>(p_)->U->internalAllocator.free(p_, sizeof(Linda)); }
 
     ~Linda();
-    Linda(Universe* U_, std::string_view const& name_, lua_Duration wake_period_, LindaGroup group_);
+    Linda(Universe* U_, std::string_view const& name_, lua_Duration wake_period_, lua_Duration spin_duration_, LindaGroup group_, bool sharded_);
     Linda() = delete;
     // non-copyable, non-movable
     Linda(Linda const&) = delete;
@@ -64,16 +166,38 @@ class Linda final
     static void DeleteTimerLinda(lua_State* L_, Linda* linda_);
     void freeAllocatedName();
     void setName(std::string_view const& name_);
+    [[nodiscard]]
+    WaiterList& waitersOf(KeeperIndex const keeper_) { return waiterLists[sharded ? static_cast<size_t>(keeper_.value()) : 0]; }
 
     public:
     [[nodiscard]]
-    Keeper* acquireKeeper() const;
+    Keeper* acquireKeeper() const { return acquireKeeper(keeperIndex); }
+    [[nodiscard]]
+    Keeper* acquireKeeper(KeeperIndex keeper_) const;
+    // a reference on the linda held by something else than a proxy, such as a handle created by linda:slot()
+    void addRef() { refcount.fetch_add(1, std::memory_order_relaxed); }
+    void addWaiter(Waiter& waiter_, KeeperIndex keeper_);
+    void addWaitTime(Waiter::Kind const kind_, std::chrono::steady_clock::duration const duration_)
+    {
+        ((kind_ == Waiter::Kind::Reader) ? stats.receiveWait : stats.sendWait).fetch_add(duration_.count(), std::memory_order_relaxed);
+    }
     [[nodiscard]]
     static Linda* CreateTimerLinda(lua_State* const L_, Passkey<Universe> const) { return CreateTimerLinda(L_); }
     static void DeleteTimerLinda(lua_State* const L_, Linda* const linda_, Passkey<Universe> const) { DeleteTimerLinda(L_, linda_); }
+    // a keeper that applies posted sends runs an operation on the linda without acquiring the keeper through it
+    void enterKeeperOperation(Passkey<Keeper> const) const { keeperOperationCount.fetch_add(1, std::memory_order_seq_cst); }
+    void leaveKeeperOperation(Passkey<Keeper> const) const { keeperOperationCount.fetch_sub(1, std::memory_order_seq_cst); }
     [[nodiscard]]
     std::string_view getName() const;
     [[nodiscard]]
+    int getNotifier(std::optional<LindaSlotId> slot_);
+    [[nodiscard]]
+    int getNbShards() const { return static_cast<int>(waiterLists.size()); }
+    [[nodiscard]]
+    KeeperIndex getShardKeeper(int const shard_) const { return sharded ? KeeperIndex{ shard_ } : keeperIndex; }
+    [[nodiscard]]
+    auto getSpinDuration() const { return spinDuration; }
+    [[nodiscard]]
     auto getWakePeriod() const { return wakePeriod; }
     [[nodiscard]]
     bool inKeeperOperation() const { return keeperOperationCount.load(std::memory_order_seq_cst) != 0; }
@@ -85,10 +209,34 @@ class Linda final
         static constexpr UniqueKey kObfuscator{ 0x7B8AA1F99A3BD782ull };
         return std::bit_cast<T>(std::bit_cast<uintptr_t>(this) ^ kObfuscator.storage);
     };
+    // the keeper holding a slot
+    // a slot id is not always a hash (small integers, short strings and aligned pointers are stored as-is), so its bits are mixed first
+    [[nodiscard]]
+    KeeperIndex keeperIndexOf(LindaSlotId const slot_) const { return sharded ? KeeperIndex{ static_cast<int>(((slot_ * 0x9E3779B97F4A7C15ull) >> 32) % waiterLists.size()) } : keeperIndex; }
+    [[nodiscard]]
+    std::optional<KeeperIndex> keeperIndexOf(lua_State* L_, StackIndex first_, StackIndex last_) const;
     void releaseKeeper(Keeper* keeper_) const;
+    // returns true if that was the last reference, in which case the linda must be deleted with DeepFactory::DeleteDeepObject()
+    [[nodiscard]]
+    bool releaseRef() { return refcount.fetch_sub(1, std::memory_order_relaxed) == 1; }
+    [[nodiscard]]
+    int protectedCall(lua_State* L_, lua_CFunction f_, KeeperIndex keeper_, int nargs_);
+    [[nodiscard]]
+    static int ProtectedCall(lua_State* const L_, lua_CFunction const f_) { return ProtectedCall(L_, f_, StackIndex{ 2 }, StackIndex{ 2 }); }
     [[nodiscard]]
-    static int ProtectedCall(lua_State* L_, lua_CFunction f_);
+    static int ProtectedCall(lua_State* L_, lua_CFunction f_, StackIndex firstSlot_, StackIndex lastSlot_);
     void pushCancelString(lua_State* L_) const;
+    void removeWaiter(Waiter& waiter_);
+    [[nodiscard]]
+    static LindaSlotId SlotId(lua_State* L_, StackIndex idx_);
+    [[nodiscard]]
+    bool spinUntilEvent(KeeperIndex keeper_, std::chrono::time_point<std::chrono::steady_clock> until_);
+    void wakeAllWaiters(Waiter::Kind kind_);
+    void wakeWaiters(Waiter::Kind kind_, LindaSlotId slot_, WakeMode mode_);
     [[nodiscard]]
     Keeper* whichKeeper() const { return U->keepers.getKeeper(keeperIndex); }
+    [[nodiscard]]
+    Keeper* whichKeeper(lua_State* const L_, StackIndex const slot_) const { return sharded ? U->keepers.getKeeper(keeperIndexOf(SlotId(L_, slot_))) : whichKeeper(); }
+    [[nodiscard]]
+    uint64_t writesIn(KeeperIndex const keeper_) { return waitersOf(keeper_).writes; }
 };
@@ -74,20 +74,26 @@ void LindaFactory::deleteDeepObjectInternal(lua_State* L_, DeepPrelude* o_) cons
 {
     Linda* const _linda{ static_cast<Linda*>(o_) };
     LUA_ASSERT(L_, _linda && !_linda->inKeeperOperation());
-    Keeper* const _myKeeper{ _linda->whichKeeper() };
-    // if collected after the universe, keepers are already destroyed, and there is nothing to clear
-    if (_myKeeper) {
-        // if collected from my own keeper, we can't acquire/release it
-        // because we are already inside a protected area, and trying to do so would deadlock!
-        bool const _need_acquire_release{ _myKeeper->K != L_ };
-        // Clean associated structures in the keeper state.
-        Keeper* const _keeper{ _need_acquire_release ? _linda->acquireKeeper() : _myKeeper };
-        LUA_ASSERT(L_, _keeper == _myKeeper); // should always be the same
-        // hopefully this won't ever raise an error as we would jump to the closest pcall site while forgetting to release the keeper mutex...
-        [[maybe_unused]] KeeperCallResult const result{ keeper_call(_keeper->K, KEEPER_API(destruct), L_, _linda, kIdxNone) };
-        LUA_ASSERT(L_, result.has_value() && result.value() == 0);
-        if (_need_acquire_release) {
-            _linda->releaseKeeper(_keeper);
+    // a sharded linda can have slots in all keepers
+    for (int const _shard : std::ranges::iota_view{ 0, _linda->getNbShards() }) {
+        KeeperIndex const _keeperIndex{ _linda->getShardKeeper(_shard) };
+        Keeper* const _myKeeper{ _linda->U->keepers.getKeeper(_keeperIndex) };
+        // if collected after the universe, keepers are already destroyed, and there is nothing to clear
+        if (_myKeeper) {
+            // if collected from my own keeper, we can't acquire/release it
+            // because we are already inside a protected area, and trying to do so would deadlock!
+            bool const _need_acquire_release{ _myKeeper->K != L_ };
+            // Clean associated structures in the keeper state.
+            Keeper* const _keeper{ _need_acquire_release ? _linda->acquireKeeper(_keeperIndex) : _myKeeper };
+            LUA_ASSERT(L_, _keeper == _myKeeper); // should always be the same
+            // acquiring the keeper applied what was posted to the linda, but we may be running inside that very keeper
+            _keeper->discardPosted(_linda);
+            // hopefully this won't ever raise an error as we would jump to the closest pcall site while forgetting to release the keeper mutex...
+            [[maybe_unused]] KeeperCallResult const result{ keeper_call(*_keeper, KEEPER_API(destruct), L_, _linda, kIdxNone) };
+            LUA_ASSERT(L_, result.has_value() && result.value() == 0);
+            if (_need_acquire_release) {
+                _linda->releaseKeeper(_keeper);
+            }
         }
     }
 
@@ -109,10 +115,14 @@ std::string_view LindaFactory::moduleName() const
 DeepPrelude* LindaFactory::newDeepObjectInternal(lua_State* const L_) const
 {
     STACK_CHECK_START_REL(L_, 0);
-    // we always expect name, wake_period, group at the bottom of the stack (either can be nil). any extra stuff we ignore and keep unmodified
+    // we always expect name, wake_period, group, sharded, spin at the bottom of the stack (either can be nil). any extra stuff we ignore and keep unmodified
+    Universe* const _U{ Universe::Get(L_) };
     std::string_view _linda_name{ luaW_tostring(L_, StackIndex{ 1 }) };
     auto const _wake_period{ static_cast<lua_Duration>(lua_tonumber(L_, 2)) };
     LindaGroup const _linda_group{ static_cast<int>(lua_tointeger(L_, 3)) };
+    bool const _sharded{ lua_toboolean(L_, 4) ? true : false };
+    // when not specified, the spin duration is the one of the universe
+    lua_Duration const _spin_duration{ lua_isnil(L_, 5) ? _U->lindaSpinDuration : lua_Duration{ lua_tonumber(L_, 5) } };
 
     // store in the linda the location of the script that created it
     if (_linda_name == "auto") {
@@ -130,8 +140,7 @@ DeepPrelude* LindaFactory::newDeepObjectInternal(lua_State* const L_) const
 
     // The deep data is allocated separately of Lua stack; we might no longer be around when last reference to it is being released.
     // One can use any memory allocation scheme. Just don't use L's allocF because we don't know which state will get the honor of GCing the linda
-    Universe* const _U{ Universe::Get(L_) };
-    Linda* const _linda{ new (_U) Linda{ _U, _linda_name, _wake_period, _linda_group } };
+    Linda* const _linda{ new (_U) Linda{ _U, _linda_name, _wake_period, _spin_duration, _linda_group, _sharded } };
     STACK_CHECK(L_, 0);
     return _linda;
 }
@@ -0,0 +1,175 @@
+/*
+ * LOOKUPINDEX.CPP                  Copyright (c) 2026-, Benoit Germain
+ *
+ * Universe-wide index of the lookup database walks.
+ */
+
+/*
+===============================================================================
+
+Copyright (C) 2026- benoit Germain <bnt.germain@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+===============================================================================
+*/
+#include "_pch.hpp"
+#include "lookupindex.hpp"
+
+#include "universe.hpp"
+
+// #################################################################################################
+// ########################################### Recorder ############################################
+// #################################################################################################
+
+LookupIndex::Recorder::~Recorder()
+{
+    if (buffer) {
+        U->internalAllocator.free(buffer, capacity);
+    }
+}
+
+// #################################################################################################
+
+// makes room for size_ more bytes at the end of the buffer, and returns where to write them (nullptr if we ran out of memory)
+[[nodiscard]]
+std::byte* LookupIndex::Recorder::reserve(size_t const size_)
+{
+    if (failed) {
+        return nullptr;
+    }
+    if (size + size_ > capacity) {
+        size_t const _capacity{ std::max(size + size_, std::max(capacity * 2, size_t{ 1024 })) };
+        void* const _buffer{ U->internalAllocator.alloc(buffer, buffer ? capacity : 0, _capacity) };
+        if (!_buffer) {
+            failed = true;
+            return nullptr;
+        }
+        buffer = static_cast<std::byte*>(_buffer);
+        capacity = _capacity;
+    }
+    std::byte* const _cursor{ buffer + size };
+    size += size_;
+    return _cursor;
+}
+
+// #################################################################################################
+
+void LookupIndex::Recorder::add(lua_State* const L_, StackIndex const obj_, StackIndex const fqnKeys_, TableIndex const depth_, std::string_view const& fqn_)
+{
+    STACK_GROW(L_, 1);
+    STACK_CHECK_START_REL(L_, 0);
+    LuaType const _type{ luaW_type(L_, obj_) };
+    lua_CFunction const _cfunc{ (_type == LuaType::FUNCTION) ? lua_tocfunction(L_, obj_) : nullptr };
+    uint32_t const _nbKeys{ static_cast<uint32_t>(depth_ - pathBase) };
+    std::byte* _cursor{ reserve(sizeof(LuaType) + sizeof(lua_CFunction) + sizeof(uint32_t)) };
+    if (!_cursor) {
+        return;
+    }
+    Write(_cursor, _type);
+    Write(_cursor, _cfunc);
+    Write(_cursor, _nbKeys);
+    for (TableIndex _i{ pathBase + 1 }; _i <= depth_; ++_i) {
+        lua_rawgeti(L_, fqnKeys_, _i);                                                             // L_: ... k
+        // update_lookup_entry() only accepts strings and numbers in the fqn
+        if (luaW_type(L_, kIdxTop) == LuaType::STRING) {
+            std::string_view const _key{ luaW_tostring(L_, kIdxTop) };
+            _cursor = reserve(sizeof(LuaType) + sizeof(size_t) + _key.size());
+            if (_cursor) {
+                Write(_cursor, LuaType::STRING);
+                Write(_cursor, _key.size());
+                std::memcpy(_cursor, _key.data(), _key.size());
+            }
+        } else {
+            _cursor = reserve(sizeof(LuaType) + sizeof(lua_Number));
+            if (_cursor) {
+                Write(_cursor, LuaType::NUMBER);
+                Write(_cursor, lua_tonumber(L_, -1));
+            }
+        }
+        lua_pop(L_, 1);                                                                            // L_: ...
+        if (!_cursor) {
+            return;
+        }
+    }
+    _cursor = reserve(sizeof(size_t) + fqn_.size());
+    if (_cursor) {
+        Write(_cursor, fqn_.size());
+        std::memcpy(_cursor, fqn_.data(), fqn_.size());
+    }
+    STACK_CHECK(L_, 0);
+}
+
+// #################################################################################################
+// ######################################### LookupIndex ###########################################
+// #################################################################################################
+
+// only called when the universe is collected, when no state can access the modules anymore
+void LookupIndex::clear(Universe& U_)
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    while (first) {
+        Module* const _next{ first->next };
+        size_t const _size{ sizeof(Module) + first->nameSize + first->size };
+        first->~Module();
+        U_.internalAllocator.free(first, _size);
+        first = _next;
+    }
+}
+
+// #################################################################################################
+
+[[nodiscard]]
+LookupIndex::Module const* LookupIndex::find(std::string_view const& name_) const
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    for (Module const* _module{ first }; _module; _module = _module->next) {
+        if (_module->name() == name_) {
+            return _module;
+        }
+    }
+    return nullptr;
+}
+
+// #################################################################################################
+
+// if another state published a module of the same name in the meantime, we keep the one we already have
+void LookupIndex::publish(std::string_view const& name_, Recorder& recorder_)
+{
+    if (recorder_.failed) {
+        return;
+    }
+    std::lock_guard<std::mutex> _guard{ mutex };
+    for (Module const* _module{ first }; _module; _module = _module->next) {
+        if (_module->name() == name_) {
+            return;
+        }
+    }
+    void* const _mem{ recorder_.U->internalAllocator.alloc(sizeof(Module) + name_.size() + recorder_.size) };
+    if (!_mem) {
+        return;
+    }
+    Module* const _module{ new (_mem) Module{ name_.size(), recorder_.size } };
+    std::memcpy(_module->bytes(), name_.data(), name_.size());
+    if (recorder_.size) {
+        std::memcpy(_module->bytes() + name_.size(), recorder_.buffer, recorder_.size);
+    }
+    _module->next = first;
+    first = _module;
+}
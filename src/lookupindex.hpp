@@ -0,0 +1,172 @@
+#pragma once
+
+#include "tools.hpp"
+
+// forwards
+class Universe;
+
+// #################################################################################################
+
+// what the lookup database walk found in the modules registered by the states of a universe, kept in native memory
+// the first state that walks a module publishes the path and the fully qualified name of every object it named there
+// the states that register a module of the same name afterward bind these entries to their own objects instead of walking the module
+class LookupIndex final
+{
+    public:
+    // the walk result of a single module, immutable once published
+    class Module final
+    {
+        friend class LookupIndex;
+
+        private:
+        Module* next{ nullptr };
+        size_t const nameSize;
+        size_t const size; // number of bytes of the serialized entries, stored right after the name
+
+        Module(size_t const nameSize_, size_t const size_)
+        : nameSize{ nameSize_ }
+        , size{ size_ }
+        {
+        }
+
+        [[nodiscard]]
+        std::byte* bytes() { return reinterpret_cast<std::byte*>(this + 1); }
+        [[nodiscard]]
+        std::byte const* bytes() const { return reinterpret_cast<std::byte const*>(this + 1); }
+
+        public:
+        // non-copyable, non-movable
+        Module(Module const&) = delete;
+        Module(Module const&&) = delete;
+        Module& operator=(Module const&) = delete;
+        Module& operator=(Module const&&) = delete;
+
+        // for each entry whose path leads from the module at root_ to an object of the type that was found by the walk,
+        // pushes that object and calls onEntry_(fqn) which must pop it
+        template <typename F>
+        void forEach(lua_State* L_, StackIndex root_, F&& onEntry_) const;
+        [[nodiscard]]
+        std::string_view name() const { return std::string_view{ reinterpret_cast<char const*>(bytes()), nameSize }; }
+    };
+
+    // accumulates the entries found by a walk until it is published
+    class Recorder final
+    {
+        friend class LookupIndex;
+
+        private:
+        Universe* const U;
+        // the keys of the fqn table that come before the path of the objects (the module name, if any)
+        TableIndex const pathBase;
+        std::byte* buffer{ nullptr };
+        size_t size{ 0 };
+        size_t capacity{ 0 };
+        bool failed{ false }; // if we ran out of memory, there is nothing to publish
+
+        [[nodiscard]]
+        std::byte* reserve(size_t size_);
+
+        public:
+        Recorder(Universe* const U_, TableIndex const pathBase_)
+        : U{ U_ }
+        , pathBase{ pathBase_ }
+        {
+        }
+        ~Recorder();
+        // non-copyable, non-movable
+        Recorder(Recorder const&) = delete;
+        Recorder(Recorder const&&) = delete;
+        Recorder& operator=(Recorder const&) = delete;
+        Recorder& operator=(Recorder const&&) = delete;
+
+        // the object named fqn_ is at obj_, reached through the keys stored in the table at fqnKeys_, up to depth_
+        void add(lua_State* L_, StackIndex obj_, StackIndex fqnKeys_, TableIndex depth_, std::string_view const& fqn_);
+    };
+
+    private:
+    // protects the chain, the modules themselves are immutable
+    mutable std::mutex mutex;
+    Module* first{ nullptr };
+
+    public:
+    void clear(Universe& U_);
+    [[nodiscard]]
+    Module const* find(std::string_view const& name_) const;
+    void publish(std::string_view const& name_, Recorder& recorder_);
+
+    // the serialization helpers used by Recorder::add() and Module::forEach()
+    template <typename T>
+    static void Write(std::byte*& cursor_, T const& value_)
+    {
+        std::memcpy(cursor_, &value_, sizeof(T));
+        cursor_ += sizeof(T);
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    static T Read(std::byte const*& cursor_)
+    {
+        T _value;
+        std::memcpy(&_value, cursor_, sizeof(T));
+        cursor_ += sizeof(T);
+        return _value;
+    }
+};
+
+// #################################################################################################
+
+// each entry is serialized as: type, C function, key count, keys (type, then length and characters or number), fqn length, fqn characters
+template <typename F>
+void LookupIndex::Module::forEach(lua_State* const L_, StackIndex const root_, F&& onEntry_) const
+{
+    StackIndex const _root{ luaW_absindex(L_, root_) };
+    STACK_GROW(L_, 2);
+    STACK_CHECK_START_REL(L_, 0);
+    std::byte const* _cursor{ bytes() + nameSize };
+    std::byte const* const _end{ _cursor + size };
+    while (_cursor < _end) {
+        LuaType const _type{ Read<LuaType>(_cursor) };
+        lua_CFunction const _cfunc{ Read<lua_CFunction>(_cursor) };
+        uint32_t const _nbKeys{ Read<uint32_t>(_cursor) };
+        lua_pushvalue(L_, _root);                                                                  // L_: ... o
+        bool _found{ true };
+        for ([[maybe_unused]] uint32_t const _i : std::ranges::iota_view{ uint32_t{ 0 }, _nbKeys }) {
+            if (Read<LuaType>(_cursor) == LuaType::STRING) {
+                size_t const _len{ Read<size_t>(_cursor) };
+                if (_found) {
+                    luaW_pushstring(L_, std::string_view{ reinterpret_cast<char const*>(_cursor), _len }); // L_: ... o k
+                }
+                _cursor += _len;
+            } else {
+                lua_Number const _key{ Read<lua_Number>(_cursor) };
+                if (_found) {
+                    lua_pushnumber(L_, _key);                                                      // L_: ... o k
+                }
+            }
+            if (_found) {
+                // the walk only steps into tables
+                _found = lua_istable(L_, -2);
+                if (_found) {
+                    lua_rawget(L_, -2);                                                            // L_: ... o o[k]
+                    lua_remove(L_, -2);                                                            // L_: ... o[k]
+                } else {
+                    lua_pop(L_, 1);                                                                // L_: ... o
+                }
+            }
+        }
+        size_t const _len{ Read<size_t>(_cursor) };
+        std::string_view const _fqn{ reinterpret_cast<char const*>(_cursor), _len };
+        _cursor += _len;
+        // a native function must be the very same one, else we would give its name to another function
+        // a function that isn't native must not be a Lua function, because these are never found through the lookup database
+        _found = _found
+            && luaW_type(L_, kIdxTop) == _type
+            && (_type != LuaType::FUNCTION || (_cfunc ? lua_tocfunction(L_, -1) == _cfunc : luaW_getfuncsubtype(L_, kIdxTop) == FuncSubType::FastJIT));
+        if (_found) {
+            onEntry_(_fqn);                                                                        // L_: ...
+        } else {
+            lua_pop(L_, 1);                                                                        // L_: ...
+        }
+        STACK_CHECK(L_, 0);
+    }
+}
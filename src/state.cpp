@@ -283,7 +283,7 @@ namespace state {
             DEBUGSPEW_CODE(DebugSpew(U_) << std::source_location::current().function_name() << " LOOKUP DB CONTENTS" << std::endl);
             DEBUGSPEW_CODE(DebugSpewIndentScope _scope2{ U_ });
             // dump the lookup database contents
-            kLookupRegKey.pushValue(_L);                                                           // L: {}
+            tools::PushLookupDatabase(U_, _L);                                                     // L: {}
             lua_pushnil(_L);                                                                       // L: {} nil
             while (lua_next(_L, -2)) {                                                             // L: {} k v
                 luaW_pushstring(_L, "[");                                                          // L: {} k v "["
@@ -0,0 +1,269 @@
+/*
+ * STATEPOOL.CPP                    Copyright (c) 2026-, Benoit Germain
+ *
+ * Reuse of the Lua states of lanes that ended.
+ */
+
+/*
+===============================================================================
+
+Copyright (C) 2026- benoit Germain <bnt.germain@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+===============================================================================
+*/
+#include "_pch.hpp"
+#include "statepool.hpp"
+
+#include "universe.hpp"
+
+// #################################################################################################
+
+// xxh64 of string "kStatePoolKeyRegKey" generated at https://www.pelock.com/products/hash-calculator
+static constexpr RegistryUniqueKey kStatePoolKeyRegKey{ 0x40A61F2474757CF8ull }; // the initialization steps of the state, as a string
+
+// { [t] = shallow copy of t } for the tables restored when the state is scrubbed
+// xxh64 of string "kStatePoolSnapshotRegKey" generated at https://www.pelock.com/products/hash-calculator
+static constexpr RegistryUniqueKey kStatePoolSnapshotRegKey{ 0xB891FD531EDA2A91ull };
+
+// { [t] = metatable of t|false } for the tables of the snapshot
+// xxh64 of string "kStatePoolMetatablesRegKey" generated at https://www.pelock.com/products/hash-calculator
+static constexpr RegistryUniqueKey kStatePoolMetatablesRegKey{ 0xAA2741DEE2BD5ECCull };
+
+// #################################################################################################
+
+namespace {
+    namespace local {
+
+        // restore the tables of the snapshot and their metatables, then collect everything the lane left behind (mostly so that deep userdata such as lindas can go away)
+        // run in protected mode because anything can happen in the finalizers
+        // upvalue 1: true if the snapshot must be restored
+        [[nodiscard]]
+        static int ScrubState(lua_State* const L_)
+        {
+            STACK_GROW(L_, 6);
+            if (lua_toboolean(L_, lua_upvalueindex(1))) {
+                kStatePoolSnapshotRegKey.pushValue(L_);                                            // L_: {snapshot}|nil
+                kStatePoolMetatablesRegKey.pushValue(L_);                                          // L_: {snapshot}|nil {mts}|nil
+                if (lua_istable(L_, 1)) {
+                    lua_pushnil(L_);                                                               // L_: {snapshot} {mts} nil
+                    while (lua_next(L_, 1) != 0) {                                                 // L_: {snapshot} {mts} t {copy}
+                        // remove what is not in the copy (assigning nil to an existing field is fine while we traverse the table)
+                        lua_pushnil(L_);                                                           // L_: {snapshot} {mts} t {copy} nil
+                        while (lua_next(L_, -3) != 0) {                                            // L_: {snapshot} {mts} t {copy} k v
+                            lua_pop(L_, 1);                                                        // L_: {snapshot} {mts} t {copy} k
+                            lua_pushvalue(L_, -1);                                                 // L_: {snapshot} {mts} t {copy} k k
+                            if (luaW_rawget(L_, StackIndex{ -3 }) == LuaType::NIL) {               // L_: {snapshot} {mts} t {copy} k v|nil
+                                lua_pushvalue(L_, -2);                                             // L_: {snapshot} {mts} t {copy} k nil k
+                                lua_insert(L_, -2);                                                // L_: {snapshot} {mts} t {copy} k k nil
+                                lua_rawset(L_, -5);                                                // L_: {snapshot} {mts} t {copy} k
+                            } else {
+                                lua_pop(L_, 1);                                                    // L_: {snapshot} {mts} t {copy} k
+                            }
+                        }                                                                          // L_: {snapshot} {mts} t {copy}
+                        // then put back what the copy holds
+                        lua_pushnil(L_);                                                           // L_: {snapshot} {mts} t {copy} nil
+                        while (lua_next(L_, -2) != 0) {                                            // L_: {snapshot} {mts} t {copy} k v
+                            lua_pushvalue(L_, -2);                                                 // L_: {snapshot} {mts} t {copy} k v k
+                            lua_insert(L_, -2);                                                    // L_: {snapshot} {mts} t {copy} k k v
+                            lua_rawset(L_, -5);                                                    // L_: {snapshot} {mts} t {copy} k
+                        }                                                                          // L_: {snapshot} {mts} t {copy}
+                        lua_pop(L_, 1);                                                            // L_: {snapshot} {mts} t
+                        // and the metatable (the C API ignores a __metatable field that would protect it)
+                        lua_pushvalue(L_, -1);                                                     // L_: {snapshot} {mts} t t
+                        if (luaW_rawget(L_, StackIndex{ 2 }) != LuaType::TABLE) {                  // L_: {snapshot} {mts} t mt|false
+                            lua_pop(L_, 1);                                                        // L_: {snapshot} {mts} t
+                            lua_pushnil(L_);                                                       // L_: {snapshot} {mts} t nil
+                        }
+                        lua_setmetatable(L_, -2);                                                  // L_: {snapshot} {mts} t
+                    }                                                                              // L_: {snapshot} {mts}
+                }
+                lua_pop(L_, 2);                                                                    // L_:
+            }
+            // the lane may have stopped the GC
+            lua_gc(L_, LUA_GCRESTART, 0);
+            lua_gc(L_, LUA_GCCOLLECT, 0);
+            return 0;
+        }
+
+    } // namespace local
+} // namespace
+
+// #################################################################################################
+
+// returns an idle state that was created with the same initialization steps, or nullptr
+[[nodiscard]]
+lua_State* StatePool::acquire(std::string_view const& key_)
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    // nobody else can touch an idle state, so it's ok to read its registry here
+    for (int _i{ count }; _i > 0; --_i) {
+        lua_State* const _L{ idle[_i - 1] };
+        STACK_CHECK_START_REL(_L, 0);
+        kStatePoolKeyRegKey.pushValue(_L);                                                         // _L: "key"
+        bool const _match{ luaW_tostring(_L, kIdxTop) == key_ };
+        lua_pop(_L, 1);                                                                            // _L:
+        STACK_CHECK(_L, 0);
+        if (_match) {
+            idle[_i - 1] = idle[--count];
+            return _L;
+        }
+    }
+    return nullptr;
+}
+
+// #################################################################################################
+
+// only called when the universe is collected, once no lane can release its state anymore
+void StatePool::close()
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    for (lua_State* const _L : std::span<lua_State*>{ idle, static_cast<size_t>(count) }) {
+        lua_close(_L);
+    }
+    count = 0;
+    if (idle) {
+        U->internalAllocator.free(idle, static_cast<size_t>(capacity) * sizeof(lua_State*));
+        idle = nullptr;
+    }
+    capacity = 0;
+}
+
+// #################################################################################################
+
+void StatePool::initialize(Universe& U_, int const capacity_, Scrub const scrub_)
+{
+    U = &U_;
+    scrub = scrub_;
+    if (capacity_ > 0) {
+        idle = static_cast<lua_State**>(U_.internalAllocator.alloc(static_cast<size_t>(capacity_) * sizeof(lua_State*)));
+        capacity = idle ? capacity_ : 0;
+    }
+}
+
+// #################################################################################################
+
+// tag a newly created lane state with its initialization steps, and remember the package table as it is before the lane changes it
+void StatePool::Prepare(lua_State* const L_, std::string_view const& key_)
+{
+    STACK_GROW(L_, 1);
+    STACK_CHECK_START_REL(L_, 0);
+    kStatePoolKeyRegKey.setValue(L_, [key = key_](lua_State* L_) { luaW_pushstring(L_, key); });
+    lua_getglobal(L_, LUA_LOADLIBNAME);                                                            // L_: package|nil
+    if (lua_istable(L_, -1)) {
+        Snapshot(L_, kIdxTop);
+    }
+    lua_pop(L_, 1);                                                                                // L_:
+    STACK_CHECK(L_, 0);
+}
+
+// #################################################################################################
+
+// called in place of lua_close() with a state whose lane ended on its own
+// returns false if the state was not kept, in which case the caller must close it
+[[nodiscard]]
+bool StatePool::release(lua_State* const L_)
+{
+    if (!isEnabled()) {
+        return false;
+    }
+    // don't bother scrubbing a state we would close anyway
+    if (std::lock_guard<std::mutex> _guard{ mutex }; count == capacity) {
+        return false;
+    }
+    STACK_GROW(L_, 2);
+    LUA_ASSERT(L_, lua_gettop(L_) == 0);
+    lua_pushboolean(L_, scrub == Scrub::Globals);                                                  // L_: bool
+    lua_pushcclosure(L_, local::ScrubState, 1);                                                    // L_: ScrubState
+    if (lua_pcall(L_, 0, 0, 0) != LUA_OK) {                                                        // L_: err?
+        return false;
+    }
+    std::lock_guard<std::mutex> _guard{ mutex };
+    if (count == capacity) {
+        return false;
+    }
+    idle[count++] = L_;
+    return true;
+}
+
+// #################################################################################################
+
+// store a shallow copy of the table at idx_ and its metatable, to restore them when the state is released
+void StatePool::Snapshot(lua_State* const L_, StackIndex const idx_)
+{
+    StackIndex const _idx{ luaW_absindex(L_, idx_) };
+    STACK_GROW(L_, 5);
+    STACK_CHECK_START_REL(L_, 0);
+    std::ignore = kStatePoolSnapshotRegKey.getSubTable(L_, NArr{ 0 }, NRec{ 3 });                  // L_: {snapshot}
+    lua_pushvalue(L_, _idx);                                                                       // L_: {snapshot} t
+    lua_newtable(L_);                                                                              // L_: {snapshot} t {copy}
+    lua_pushnil(L_);                                                                               // L_: {snapshot} t {copy} nil
+    while (lua_next(L_, _idx) != 0) {                                                              // L_: {snapshot} t {copy} k v
+        lua_pushvalue(L_, -2);                                                                     // L_: {snapshot} t {copy} k v k
+        lua_insert(L_, -2);                                                                        // L_: {snapshot} t {copy} k k v
+        lua_rawset(L_, -4);                                                                        // L_: {snapshot} t {copy} k
+    }                                                                                              // L_: {snapshot} t {copy}
+    lua_rawset(L_, -3);                                                                            // L_: {snapshot}
+    lua_pop(L_, 1);                                                                                // L_:
+    std::ignore = kStatePoolMetatablesRegKey.getSubTable(L_, NArr{ 0 }, NRec{ 3 });                // L_: {mts}
+    lua_pushvalue(L_, _idx);                                                                       // L_: {mts} t
+    if (!lua_getmetatable(L_, _idx)) {                                                             // L_: {mts} t mt?
+        lua_pushboolean(L_, 0);                                                                    // L_: {mts} t false
+    }
+    lua_rawset(L_, -3);                                                                            // L_: {mts}
+    lua_pop(L_, 1);                                                                                // L_:
+    STACK_CHECK(L_, 0);
+}
+
+// #################################################################################################
+
+// once the required modules are loaded, remember _G, package.loaded, the tables it holds (the standard libraries and the required modules)
+// and the metatable of strings, as they are before the lane changes them
+void StatePool::SnapshotGlobals(lua_State* const L_)
+{
+    STACK_GROW(L_, 4);
+    STACK_CHECK_START_REL(L_, 0);
+    luaW_pushglobaltable(L_);                                                                      // L_: _G
+    Snapshot(L_, kIdxTop);
+    lua_pop(L_, 1);                                                                                // L_:
+    lua_getglobal(L_, LUA_LOADLIBNAME);                                                            // L_: package|nil
+    if (lua_istable(L_, -1)) {
+        lua_getfield(L_, -1, "loaded");                                                            // L_: package loaded|nil
+        if (lua_istable(L_, -1)) {
+            Snapshot(L_, kIdxTop);
+            lua_pushnil(L_);                                                                       // L_: package loaded nil
+            while (lua_next(L_, -2) != 0) {                                                        // L_: package loaded name module
+                if (lua_istable(L_, -1)) {
+                    Snapshot(L_, kIdxTop);
+                }
+                lua_pop(L_, 1);                                                                    // L_: package loaded name
+            }                                                                                      // L_: package loaded
+        }
+        lua_pop(L_, 1);                                                                            // L_: package
+    }
+    lua_pop(L_, 1);                                                                                // L_:
+    luaW_pushstring(L_, "");                                                                       // L_: ""
+    if (lua_getmetatable(L_, -1)) {                                                                // L_: "" mt?
+        Snapshot(L_, kIdxTop);
+        lua_pop(L_, 1);                                                                            // L_: ""
+    }
+    lua_pop(L_, 1);                                                                                // L_:
+    STACK_CHECK(L_, 0);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "uniquekey.hpp"
+
+// forwards
+class Universe;
+
+// #################################################################################################
+
+// lane states that are kept after their lane ended, to be reused by a lane created with the same libraries and required modules
+// a state is only reused by a lane that would have gone through the exact same initialization steps to create it
+class StatePool final
+{
+    public:
+    enum class [[nodiscard]] Scrub
+    {
+        Globals, // restore the contents and metatables of _G, package, package.loaded, the tables it holds and the string metatable as they were when the state was created
+        None // trust the lanes not to leave anything behind
+    };
+
+    private:
+    // protects the idle states
+    mutable std::mutex mutex;
+    Universe* U{ nullptr };
+    // capacity is 0 when the pool is disabled
+    lua_State** idle{ nullptr };
+    int capacity{ 0 };
+    int count{ 0 };
+    Scrub scrub{ Scrub::Globals };
+
+    static void Snapshot(lua_State* L_, StackIndex idx_);
+
+    public:
+    [[nodiscard]]
+    lua_State* acquire(std::string_view const& key_);
+    void close();
+    void initialize(Universe& U_, int capacity_, Scrub scrub_);
+    [[nodiscard]]
+    bool isEnabled() const { return capacity > 0; }
+    static void Prepare(lua_State* L_, std::string_view const& key_);
+    [[nodiscard]]
+    bool release(lua_State* L_);
+    static void SnapshotGlobals(lua_State* L_);
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "deep.hpp"
+
+// #################################################################################################
+
+// a single factory class for the four synchronization primitives, one instance per primitive so that each gets its own metatable
+class SyncFactory final
+: public DeepFactory
+{
+    public:
+    enum class [[nodiscard]] Kind
+    {
+        Barrier,
+        Latch,
+        Mutex,
+        Semaphore
+    };
+
+    static SyncFactory BarrierInstance;
+    static SyncFactory LatchInstance;
+    static SyncFactory MutexInstance;
+    static SyncFactory SemaphoreInstance;
+
+    Kind const kind;
+    std::string_view const name;
+
+    ~SyncFactory() override = default;
+    SyncFactory(Kind const kind_, std::string_view const& name_, luaL_Reg const syncMT_[])
+    : kind{ kind_ }
+    , name{ name_ }
+    , mSyncMT{ syncMT_ }
+    {
+    }
+
+    private:
+    luaL_Reg const* const mSyncMT{ nullptr };
+
+    void createMetatable(lua_State* L_) const override;
+    void deleteDeepObjectInternal(lua_State* L_, DeepPrelude* o_) const override;
+    [[nodiscard]]
+    std::string_view moduleName() const override;
+    [[nodiscard]]
+    DeepPrelude* newDeepObjectInternal(lua_State* L_) const override;
+};
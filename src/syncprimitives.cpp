@@ -0,0 +1,628 @@
+/*
+ * SYNCPRIMITIVES.CPP                 Copyright (c) 2026-, Benoit Germain
+ *
+ * Mutex, semaphore, barrier and latch deep userdata
+ */
+
+/*
+===============================================================================
+
+Copyright (C) 2026- benoit Germain <bnt.germain@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+===============================================================================
+*/
+
+#include "_pch.hpp"
+#include "syncprimitives.hpp"
+
+#include "cancel.hpp"
+#include "lane.hpp"
+#include "syncfactory.hpp"
+
+// #################################################################################################
+// #################################################################################################
+namespace {
+    // #############################################################################################
+    // #############################################################################################
+
+    template <typename T>
+    [[nodiscard]]
+    static T& ToSync(lua_State* const L_, SyncFactory const& factory_)
+    {
+        T* const _sync{ static_cast<T*>(factory_.toDeep(L_, StackIndex{ 1 })) };
+        if (_sync == nullptr) {
+            raise_luaL_argerror(L_, StackIndex{ 1 }, luaW_pushstring(L_, "expecting a %s object", factory_.name.data())); // doesn't return
+        }
+        LUA_ASSERT(L_, _sync->U == Universe::Get(L_));
+        return *_sync;
+    }
+
+    // #############################################################################################
+
+    // the date at which an operation given the optional timeout found at idx_ gives up
+    [[nodiscard]]
+    static std::chrono::time_point<std::chrono::steady_clock> CheckUntil(lua_State* const L_, StackIndex const idx_)
+    {
+        if (lua_isnoneornil(L_, idx_)) {
+            return std::chrono::time_point<std::chrono::steady_clock>::max();
+        }
+        lua_Duration const _duration{ luaL_checknumber(L_, idx_) };
+        if (_duration.count() < 0.0) {
+            raise_luaL_argerror(L_, idx_, "duration cannot be < 0");
+        }
+        return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(_duration);
+    }
+
+    // #############################################################################################
+
+    // sleep until try_() succeeds, until_ is reached, or the lane running L_ is cancelled
+    // try_ runs with the primitive's mutex locked, and performs the operation if it is possible
+    // in/out: guard_ holds the primitive's mutex
+    // returns the cancel request that interrupted the operation, and whether it succeeded
+    template <typename TRY>
+    [[nodiscard]]
+    static std::pair<CancelRequest, bool> WaitUntil(lua_State* const L_, SyncPrimitive& sync_, std::unique_lock<std::mutex>& guard_, std::chrono::time_point<std::chrono::steady_clock> const until_, TRY&& try_)
+    {
+        Lane* const _lane{ kLanePointerRegKey.readLightUserDataValue<Lane>(L_) };
+        Lane::Status _prev_status{ Lane::Status::Error }; // prevent 'might be used uninitialized' warnings
+        bool _waited{ false };
+        bool _signalled{ false };
+        std::pair<CancelRequest, bool> _result{ CancelRequest::None, false };
+        for (;;) {
+            _result.first = (_lane != nullptr) ? _lane->cancelRequest.load(std::memory_order_relaxed) : CancelRequest::None;
+            if (_result.first != CancelRequest::None) {
+                break;
+            }
+            if (try_()) {
+                _result.second = true;
+                break;
+            }
+            if (std::chrono::steady_clock::now() >= until_) {
+                break;
+            }
+            if (_lane != nullptr && !_waited) {
+                // change status of lane to "waiting"
+                _prev_status = _lane->status.load(std::memory_order_acquire); // Running, most likely
+                LUA_ASSERT(L_, _prev_status == Lane::Status::Running); // but check, just in case
+                _lane->status.store(Lane::Status::Waiting, std::memory_order_release);
+            }
+            _waited = true;
+            _signalled = sync_.wait(_lane, guard_, until_);
+        }
+        if (_lane != nullptr && _waited) {
+            _lane->status.store(_prev_status, std::memory_order_release);
+        }
+        // we were selected to proceed, but give up: another waiter might be able to use what woke us
+        if (_signalled && !_result.second) {
+            sync_.wake(SyncPrimitive::WakeMode::One);
+        }
+        return _result;
+    }
+
+    // #############################################################################################
+
+    // push the outcome of an operation that can block: true if it succeeded, false if it timed out, nil, lanes.cancel_error if the lane is soft-cancelled
+    // raises an error in case of hard cancel, so the primitive's mutex must be released
+    [[nodiscard]]
+    static int PushWaitResult(lua_State* const L_, std::pair<CancelRequest, bool> const result_)
+    {
+        switch (result_.first) {
+        case CancelRequest::None:
+            lua_pushboolean(L_, result_.second ? 1 : 0);
+            return 1;
+
+        case CancelRequest::Soft:
+            // if user wants to soft-cancel, the call returns nil, kCancelError
+            lua_pushnil(L_);
+            kCancelError.pushKey(L_);
+            return 2;
+
+        case CancelRequest::Hard:
+            // raise an error interrupting execution only in case of hard cancel
+            raise_cancel_error(L_); // raises an error and doesn't return
+
+        default:
+            raise_luaL_error(L_, "internal error: unknown cancel request");
+        }
+        return 0;
+    }
+
+} // namespace
+
+// #################################################################################################
+// #################################################################################################
+// ################################ SyncPrimitive implementation ###################################
+// #################################################################################################
+// #################################################################################################
+
+// sleep until signalled, or until_ is reached, or the lane is cancelled, whichever comes first
+// returns true if the thread was signalled
+bool SyncPrimitive::wait(Lane* const lane_, std::unique_lock<std::mutex>& guard_, std::chrono::time_point<std::chrono::steady_clock> const until_)
+{
+    std::condition_variable _condVar; // only used when we are not running inside a lane
+    std::mutex _mutex;
+    Waiter _waiter{ (lane_ != nullptr) ? lane_->lindaCondVar : _condVar, (lane_ != nullptr) ? lane_->lindaMutex : _mutex };
+
+    // register, in arrival order
+    _waiter.prev = last;
+    (last != nullptr ? last->next : first) = &_waiter;
+    last = &_waiter;
+
+    {
+        // acquired before we release the primitive: we can't be signalled before we sleep
+        std::unique_lock<std::mutex> _sleep{ _waiter.guard };
+        guard_.unlock();
+        // a lane cancelled since its last check doesn't sleep: it tries again, and sees the request
+        if (lane_ == nullptr || lane_->startWaiting(_waiter.condVar, _waiter.guard)) {
+            std::ignore = _waiter.condVar.wait_until(_sleep, until_);
+        }
+        if (lane_ != nullptr) {
+            lane_->stopWaiting();
+        }
+    }
+
+    guard_.lock();
+    (_waiter.prev != nullptr ? _waiter.prev->next : first) = _waiter.next;
+    (_waiter.next != nullptr ? _waiter.next->prev : last) = _waiter.prev;
+    return _waiter.signalled;
+}
+
+// #################################################################################################
+
+void SyncPrimitive::wake(WakeMode const mode_)
+{
+    for (Waiter* _waiter{ first }; _waiter != nullptr; _waiter = _waiter->next) {
+        // a waiter that was already signalled will try again anyway
+        if (_waiter->signalled) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> _guard{ _waiter->guard };
+            _waiter->signalled = true;
+            _waiter->condVar.notify_one();
+        }
+        if (mode_ == WakeMode::One) {
+            break;
+        }
+    }
+}
+
+// #################################################################################################
+
+SyncMutex::SyncMutex(Universe* const U_)
+: SyncPrimitive{ SyncFactory::MutexInstance, U_ }
+{
+}
+
+// #################################################################################################
+
+SyncSemaphore::SyncSemaphore(Universe* const U_, lua_Integer const count_, lua_Integer const max_)
+: SyncPrimitive{ SyncFactory::SemaphoreInstance, U_ }
+, count{ count_ }
+, max{ max_ }
+{
+}
+
+// #################################################################################################
+
+SyncBarrier::SyncBarrier(Universe* const U_, lua_Integer const expected_)
+: SyncPrimitive{ SyncFactory::BarrierInstance, U_ }
+, expected{ expected_ }
+{
+}
+
+// #################################################################################################
+
+void SyncBarrier::completePhaseIfDone()
+{
+    if (arrived >= expected) {
+        arrived = 0;
+        ++phase;
+        wake(WakeMode::All);
+    }
+}
+
+// #################################################################################################
+
+SyncLatch::SyncLatch(Universe* const U_, lua_Integer const count_)
+: SyncPrimitive{ SyncFactory::LatchInstance, U_ }
+, count{ count_ }
+{
+}
+
+// #################################################################################################
+
+bool SyncLatch::countDown(lua_Integer const n_)
+{
+    if (n_ > count) {
+        return false;
+    }
+    count -= n_;
+    if (count == 0) {
+        wake(WakeMode::All);
+    }
+    return true;
+}
+
+// #################################################################################################
+// ######################################### Mutex API #############################################
+// #################################################################################################
+
+/*
+ * true|false|(nil,lanes.cancel_error) = mutex:lock([timeout_secs])
+ *
+ * Wait until the mutex can be locked by the calling thread, or the timeout expires
+ */
+LUAG_FUNC(mutex_lock)
+{
+    SyncMutex& _mutex{ ToSync<SyncMutex>(L_, SyncFactory::MutexInstance) };
+    std::chrono::time_point<std::chrono::steady_clock> const _until{ CheckUntil(L_, StackIndex{ 2 }) };
+    std::thread::id const _self{ std::this_thread::get_id() };
+    std::unique_lock<std::mutex> _guard{ _mutex.mutex };
+    if (_mutex.owner == _self) {
+        _guard.unlock();
+        raise_luaL_error(L_, "mutex is already locked by this thread");
+    }
+    auto const _result{ WaitUntil(L_, _mutex, _guard, _until, [&_mutex, _self]() {
+        if (_mutex.owner != std::thread::id{}) {
+            return false;
+        }
+        _mutex.owner = _self;
+        return true;
+    }) };
+    _guard.unlock();
+    return PushWaitResult(L_, _result);
+}
+
+// #################################################################################################
+
+/*
+ * bool = mutex:try_lock()
+ *
+ * Lock the mutex if it isn't locked already
+ */
+LUAG_FUNC(mutex_try_lock)
+{
+    SyncMutex& _mutex{ ToSync<SyncMutex>(L_, SyncFactory::MutexInstance) };
+    std::lock_guard<std::mutex> _guard{ _mutex.mutex };
+    bool const _locked{ _mutex.owner == std::thread::id{} };
+    if (_locked) {
+        _mutex.owner = std::this_thread::get_id();
+    }
+    lua_pushboolean(L_, _locked ? 1 : 0);
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * mutex:unlock()
+ *
+ * Unlock a mutex locked by the calling thread, handing it over to a thread waiting for it
+ */
+LUAG_FUNC(mutex_unlock)
+{
+    SyncMutex& _mutex{ ToSync<SyncMutex>(L_, SyncFactory::MutexInstance) };
+    std::unique_lock<std::mutex> _guard{ _mutex.mutex };
+    if (_mutex.owner != std::this_thread::get_id()) {
+        _guard.unlock();
+        raise_luaL_error(L_, "mutex is not locked by this thread");
+    }
+    _mutex.owner = std::thread::id{};
+    _mutex.wake(SyncPrimitive::WakeMode::One);
+    return 0;
+}
+
+// #################################################################################################
+// ####################################### Semaphore API ###########################################
+// #################################################################################################
+
+/*
+ * true|false|(nil,lanes.cancel_error) = semaphore:acquire([timeout_secs])
+ *
+ * Wait until the count of the semaphore is positive and decrement it, or the timeout expires
+ */
+LUAG_FUNC(semaphore_acquire)
+{
+    SyncSemaphore& _semaphore{ ToSync<SyncSemaphore>(L_, SyncFactory::SemaphoreInstance) };
+    std::chrono::time_point<std::chrono::steady_clock> const _until{ CheckUntil(L_, StackIndex{ 2 }) };
+    std::unique_lock<std::mutex> _guard{ _semaphore.mutex };
+    auto const _result{ WaitUntil(L_, _semaphore, _guard, _until, [&_semaphore]() {
+        if (_semaphore.count <= 0) {
+            return false;
+        }
+        --_semaphore.count;
+        return true;
+    }) };
+    _guard.unlock();
+    return PushWaitResult(L_, _result);
+}
+
+// #################################################################################################
+
+/*
+ * semaphore:release([n = 1])
+ *
+ * Increment the count of the semaphore, waking as many threads waiting for it
+ */
+LUAG_FUNC(semaphore_release)
+{
+    SyncSemaphore& _semaphore{ ToSync<SyncSemaphore>(L_, SyncFactory::SemaphoreInstance) };
+    lua_Integer const _n{ luaL_optinteger(L_, 2, 1) };
+    luaL_argcheck(L_, _n >= 0, 2, "release count cannot be < 0");
+    std::unique_lock<std::mutex> _guard{ _semaphore.mutex };
+    if (_n > _semaphore.max - _semaphore.count) {
+        _guard.unlock();
+        raise_luaL_error(L_, "semaphore count would exceed its maximum");
+    }
+    _semaphore.count += _n;
+    if (_n > 0) {
+        _semaphore.wake((_n == 1) ? SyncPrimitive::WakeMode::One : SyncPrimitive::WakeMode::All);
+    }
+    return 0;
+}
+
+// #################################################################################################
+
+/*
+ * bool = semaphore:try_acquire()
+ *
+ * Decrement the count of the semaphore if it is positive
+ */
+LUAG_FUNC(semaphore_try_acquire)
+{
+    SyncSemaphore& _semaphore{ ToSync<SyncSemaphore>(L_, SyncFactory::SemaphoreInstance) };
+    std::lock_guard<std::mutex> _guard{ _semaphore.mutex };
+    bool const _acquired{ _semaphore.count > 0 };
+    if (_acquired) {
+        --_semaphore.count;
+    }
+    lua_pushboolean(L_, _acquired ? 1 : 0);
+    return 1;
+}
+
+// #################################################################################################
+// ######################################## Barrier API ############################################
+// #################################################################################################
+
+/*
+ * barrier:arrive_and_drop()
+ *
+ * Arrive at the barrier, and remove the calling thread from the expected ones for the current phase and the following ones
+ */
+LUAG_FUNC(barrier_arrive_and_drop)
+{
+    SyncBarrier& _barrier{ ToSync<SyncBarrier>(L_, SyncFactory::BarrierInstance) };
+    std::unique_lock<std::mutex> _guard{ _barrier.mutex };
+    if (_barrier.expected <= _barrier.arrived) {
+        _guard.unlock();
+        raise_luaL_error(L_, "barrier doesn't expect any more threads");
+    }
+    --_barrier.expected;
+    _barrier.completePhaseIfDone();
+    return 0;
+}
+
+// #################################################################################################
+
+/*
+ * true|(nil,lanes.cancel_error) = barrier:arrive_and_wait()
+ *
+ * Arrive at the barrier, and wait until the current phase completes
+ * A cancelled lane stops waiting, but its arrival still counts
+ */
+LUAG_FUNC(barrier_arrive_and_wait)
+{
+    SyncBarrier& _barrier{ ToSync<SyncBarrier>(L_, SyncFactory::BarrierInstance) };
+    std::unique_lock<std::mutex> _guard{ _barrier.mutex };
+    uint64_t const _phase{ _barrier.phase };
+    ++_barrier.arrived;
+    _barrier.completePhaseIfDone();
+    auto const _result{ WaitUntil(L_, _barrier, _guard, std::chrono::time_point<std::chrono::steady_clock>::max(), [&_barrier, _phase]() {
+        return _barrier.phase != _phase;
+    }) };
+    _guard.unlock();
+    return PushWaitResult(L_, _result);
+}
+
+// #################################################################################################
+// ######################################### Latch API #############################################
+// #################################################################################################
+
+/*
+ * true|(nil,lanes.cancel_error) = latch:arrive_and_wait([n = 1])
+ *
+ * Decrement the count of the latch, and wait until it reaches 0
+ */
+LUAG_FUNC(latch_arrive_and_wait)
+{
+    SyncLatch& _latch{ ToSync<SyncLatch>(L_, SyncFactory::LatchInstance) };
+    lua_Integer const _n{ luaL_optinteger(L_, 2, 1) };
+    luaL_argcheck(L_, _n >= 0, 2, "count cannot be < 0");
+    std::unique_lock<std::mutex> _guard{ _latch.mutex };
+    if (!_latch.countDown(_n)) {
+        _guard.unlock();
+        raise_luaL_error(L_, "latch count would become negative");
+    }
+    auto const _result{ WaitUntil(L_, _latch, _guard, std::chrono::time_point<std::chrono::steady_clock>::max(), [&_latch]() {
+        return _latch.count == 0;
+    }) };
+    _guard.unlock();
+    return PushWaitResult(L_, _result);
+}
+
+// #################################################################################################
+
+/*
+ * latch:count_down([n = 1])
+ *
+ * Decrement the count of the latch, waking the threads waiting for it when it reaches 0
+ */
+LUAG_FUNC(latch_count_down)
+{
+    SyncLatch& _latch{ ToSync<SyncLatch>(L_, SyncFactory::LatchInstance) };
+    lua_Integer const _n{ luaL_optinteger(L_, 2, 1) };
+    luaL_argcheck(L_, _n >= 0, 2, "count cannot be < 0");
+    std::unique_lock<std::mutex> _guard{ _latch.mutex };
+    if (!_latch.countDown(_n)) {
+        _guard.unlock();
+        raise_luaL_error(L_, "latch count would become negative");
+    }
+    return 0;
+}
+
+// #################################################################################################
+
+/*
+ * bool = latch:try_wait()
+ *
+ * Return true if the count of the latch reached 0
+ */
+LUAG_FUNC(latch_try_wait)
+{
+    SyncLatch& _latch{ ToSync<SyncLatch>(L_, SyncFactory::LatchInstance) };
+    std::lock_guard<std::mutex> _guard{ _latch.mutex };
+    lua_pushboolean(L_, (_latch.count == 0) ? 1 : 0);
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * true|false|(nil,lanes.cancel_error) = latch:wait([timeout_secs])
+ *
+ * Wait until the count of the latch reaches 0, or the timeout expires
+ */
+LUAG_FUNC(latch_wait)
+{
+    SyncLatch& _latch{ ToSync<SyncLatch>(L_, SyncFactory::LatchInstance) };
+    std::chrono::time_point<std::chrono::steady_clock> const _until{ CheckUntil(L_, StackIndex{ 2 }) };
+    std::unique_lock<std::mutex> _guard{ _latch.mutex };
+    auto const _result{ WaitUntil(L_, _latch, _guard, _until, [&_latch]() {
+        return _latch.count == 0;
+    }) };
+    _guard.unlock();
+    return PushWaitResult(L_, _result);
+}
+
+// #################################################################################################
+
+namespace {
+    namespace local {
+        static luaL_Reg const sBarrierMT[] = {
+            { "arrive_and_drop", LG_barrier_arrive_and_drop },
+            { "arrive_and_wait", LG_barrier_arrive_and_wait },
+            { nullptr, nullptr }
+        };
+        static luaL_Reg const sLatchMT[] = {
+            { "arrive_and_wait", LG_latch_arrive_and_wait },
+            { "count_down", LG_latch_count_down },
+            { "try_wait", LG_latch_try_wait },
+            { "wait", LG_latch_wait },
+            { nullptr, nullptr }
+        };
+        static luaL_Reg const sMutexMT[] = {
+            { "lock", LG_mutex_lock },
+            { "try_lock", LG_mutex_try_lock },
+            { "unlock", LG_mutex_unlock },
+            { nullptr, nullptr }
+        };
+        static luaL_Reg const sSemaphoreMT[] = {
+            { "acquire", LG_semaphore_acquire },
+            { "release", LG_semaphore_release },
+            { "try_acquire", LG_semaphore_try_acquire },
+            { nullptr, nullptr }
+        };
+    } // namespace local
+} // namespace
+// as for the LindaFactory, the factories are instanciated here to keep the metatables private to syncprimitives.cpp
+/*static*/ SyncFactory SyncFactory::BarrierInstance{ SyncFactory::Kind::Barrier, "Barrier", local::sBarrierMT };
+/*static*/ SyncFactory SyncFactory::LatchInstance{ SyncFactory::Kind::Latch, "Latch", local::sLatchMT };
+/*static*/ SyncFactory SyncFactory::MutexInstance{ SyncFactory::Kind::Mutex, "Mutex", local::sMutexMT };
+/*static*/ SyncFactory SyncFactory::SemaphoreInstance{ SyncFactory::Kind::Semaphore, "Semaphore", local::sSemaphoreMT };
+
+// #################################################################################################
+// #################################################################################################
+
+/*
+ * ud = lanes.barrier(expected)
+ *
+ * returns a barrier that completes a phase each time 'expected' threads arrive at it
+ */
+LUAG_FUNC(barrier)
+{
+    lua_Integer const _expected{ luaL_checkinteger(L_, 1) };
+    luaL_argcheck(L_, _expected > 0, 1, "expected count must be > 0");
+    luaL_argcheck(L_, lua_gettop(L_) == 1, 2, "too many arguments");
+    SyncFactory::BarrierInstance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 0 });          // L_: expected barrier
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * ud = lanes.latch(count)
+ *
+ * returns a latch that releases the threads waiting for it once counted down 'count' times
+ */
+LUAG_FUNC(latch)
+{
+    lua_Integer const _count{ luaL_checkinteger(L_, 1) };
+    luaL_argcheck(L_, _count >= 0, 1, "count cannot be < 0");
+    luaL_argcheck(L_, lua_gettop(L_) == 1, 2, "too many arguments");
+    SyncFactory::LatchInstance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 0 });            // L_: count latch
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * ud = lanes.mutex()
+ *
+ * returns an unlocked mutex
+ */
+LUAG_FUNC(mutex)
+{
+    luaL_argcheck(L_, lua_gettop(L_) == 0, 1, "too many arguments");
+    SyncFactory::MutexInstance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 0 });            // L_: mutex
+    return 1;
+}
+
+// #################################################################################################
+
+/*
+ * ud = lanes.semaphore([count = 0 [, max = math.maxinteger]])
+ *
+ * returns a counting semaphore
+ */
+LUAG_FUNC(semaphore)
+{
+    lua_Integer const _count{ luaL_optinteger(L_, 1, 0) };
+    lua_Integer const _max{ luaL_optinteger(L_, 2, std::numeric_limits<lua_Integer>::max()) };
+    luaL_argcheck(L_, _count >= 0, 1, "count cannot be < 0");
+    luaL_argcheck(L_, _max > 0 && _max >= _count, 2, "max must be > 0 and >= count");
+    luaL_argcheck(L_, lua_gettop(L_) <= 2, 3, "too many arguments");
+    lua_settop(L_, 0);                                                                             // L_:
+    lua_pushinteger(L_, _count);                                                                   // L_: count
+    lua_pushinteger(L_, _max);                                                                     // L_: count max
+    SyncFactory::SemaphoreInstance.pushDeepUserdata(DestState{ L_ }, UserValueCount{ 0 });        // L_: count max semaphore
+    return 1;
+}
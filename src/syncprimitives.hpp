@@ -0,0 +1,140 @@
+#pragma once
+
+#include "deep.hpp"
+#include "universe.hpp"
+
+// forwards
+class Lane;
+
+// #################################################################################################
+
+// the part shared by the synchronization primitives: what the primitive counts is protected by 'mutex'
+// a thread that can't proceed registers a waiter, and sleeps on a mutex it owns rather than on the primitive's,
+// so that a cancel request never locks a mutex that could be destroyed with the primitive (see Lane::startWaiting())
+class SyncPrimitive
+: public DeepPrelude // Deep userdata MUST start with this header
+{
+    public:
+    // a thread blocked in one of the primitive's operations
+    // all accesses are done with the mutex of the primitive
+    struct Waiter
+    {
+        std::condition_variable& condVar;
+        // the mutex the thread sleeps on, that must be held to signal it
+        std::mutex& guard;
+        bool signalled{ false };
+        Waiter* prev{ nullptr };
+        Waiter* next{ nullptr };
+    };
+
+    enum class [[nodiscard]] WakeMode
+    {
+        One,
+        All
+    };
+
+    public:
+    Universe* const U{ nullptr }; // the universe this primitive belongs to
+    // protects the state of the primitive and its waiters
+    std::mutex mutex;
+
+    private:
+    // the waiters, in arrival order
+    Waiter* first{ nullptr };
+    Waiter* last{ nullptr };
+
+    protected:
+    SyncPrimitive(DeepFactory& factory_, Universe* const U_)
+    : DeepPrelude{ factory_ }
+    , U{ U_ }
+    {
+    }
+
+    public:
+    // always "in-place constructed" by SyncPrimitive::Create(), the size is the one of the actual primitive
+    static void operator delete(void* p_, size_t size_) { static_cast<SyncPrimitive*>(p_)->U->internalAllocator.free(p_, size_); }
+
+    ~SyncPrimitive() = default;
+    SyncPrimitive() = delete;
+    // non-copyable, non-movable
+    SyncPrimitive(SyncPrimitive const&) = delete;
+    SyncPrimitive(SyncPrimitive const&&) = delete;
+    SyncPrimitive& operator=(SyncPrimitive const&) = delete;
+    SyncPrimitive& operator=(SyncPrimitive const&&) = delete;
+
+    template <typename T, typename... ARGS>
+    [[nodiscard]]
+    static T* Create(Universe* const U_, ARGS&&... args_)
+    {
+        void* const _mem{ U_->internalAllocator.alloc(sizeof(T)) };
+        return _mem ? new (_mem) T{ U_, std::forward<ARGS>(args_)... } : nullptr;
+    }
+
+    // in/out: guard_ holds the primitive's mutex
+    [[nodiscard]]
+    bool wait(Lane* lane_, std::unique_lock<std::mutex>& guard_, std::chrono::time_point<std::chrono::steady_clock> until_);
+    // in: the primitive's mutex is locked
+    void wake(WakeMode mode_);
+};
+
+// #################################################################################################
+
+// std::mutex semantics: a single thread at a time owns the mutex, and only that thread can unlock it
+class SyncMutex final
+: public SyncPrimitive
+{
+    public:
+    // default-constructed when the mutex is not locked
+    std::thread::id owner{};
+
+    SyncMutex(Universe* U_);
+};
+
+// #################################################################################################
+
+// std::counting_semaphore semantics: acquire() waits until the count is positive and decrements it, release() increments it
+class SyncSemaphore final
+: public SyncPrimitive
+{
+    public:
+    lua_Integer count{};
+    lua_Integer const max{};
+
+    SyncSemaphore(Universe* U_, lua_Integer count_, lua_Integer max_);
+};
+
+// #################################################################################################
+
+// std::barrier semantics: a phase completes when the expected number of threads arrived, and the barrier is then reused
+class SyncBarrier final
+: public SyncPrimitive
+{
+    public:
+    // the number of threads expected for the current phase and the following ones
+    lua_Integer expected{};
+    lua_Integer arrived{};
+    // bumped each time a phase completes
+    uint64_t phase{};
+
+    SyncBarrier(Universe* U_, lua_Integer expected_);
+
+    // in: the primitive's mutex is locked
+    void completePhaseIfDone();
+};
+
+// #################################################################################################
+
+// std::latch semantics: a single-use counter that threads wait to reach 0
+class SyncLatch final
+: public SyncPrimitive
+{
+    public:
+    lua_Integer count{};
+
+    SyncLatch(Universe* U_, lua_Integer count_);
+
+    // in: the primitive's mutex is locked
+    // returns false if the count would become negative, in which case it is left unchanged
+    [[nodiscard]]
+    bool countDown(lua_Integer n_);
+};
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "tools.hpp"
 
 #include "debugspew.hpp"
+#include "lookupindex.hpp"
 #include "universe.hpp"
 
 DEBUGSPEW_CODE(std::string_view const DebugSpewIndentScope::debugspew_indent{ "----+----!----+----!----+----!----+----!----+----!----+----!----+----!----+" });
@@ -43,6 +44,11 @@ DEBUGSPEW_CODE(std::string_view const DebugSpewIndentScope::debugspew_indent{ "-
 // xxh64 of string "kLookupCacheRegKey" generated at https://www.pelock.com/products/hash-calculator
 static constexpr RegistryUniqueKey kLookupCacheRegKey{ 0x9BF75F84E54B691Bull };
 
+// the modules registered in a state that are bound from the universe lookup index instead of being walked
+// [0] = number of modules already bound, [i] = { module, "name" }
+// xxh64 of string "kLookupBindingsRegKey" generated at https://www.pelock.com/products/hash-calculator
+static constexpr RegistryUniqueKey kLookupBindingsRegKey{ 0x90BB2DC5F25613ABull };
+
 // #################################################################################################
 
 namespace {
@@ -157,7 +163,7 @@ namespace tools {
  * if we already had an entry of type [o] = ..., replace the name if the new one is shorter
  * pops the processed object from the stack
  */
-static void update_lookup_entry(lua_State* const L_, StackIndex const ctxBase_, TableIndex const depth_)
+static void update_lookup_entry(lua_State* const L_, StackIndex const ctxBase_, TableIndex const depth_, LookupIndex::Recorder* const recorder_)
 {
     // slot 1 in the stack contains the table that receives everything we found
     StackIndex const _dest{ ctxBase_ };
@@ -180,6 +186,10 @@ static void update_lookup_entry(lua_State* const L_, StackIndex const ctxBase_,
     lua_rawseti(L_, _fqn, _deeper);                                                                // L_: ... {bfc} k o name?
     // generate name
     std::string_view const _newName{ tools::PushFQN(L_, _fqn) };                                   // L_: ... {bfc} k o name? "f.q.n"
+    // remember how we got there, so that other states can bind the same name without walking
+    if (recorder_) {
+        recorder_->add(L_, StackIndex{ -3 }, _fqn, _deeper, _newName);
+    }
     // Lua 5.2 introduced a hash randomizer seed which causes table iteration to yield a different key order
     // on different VMs even when the tables are populated the exact same way.
     // Also, when Lua is built with compatibility options (such as LUA_COMPAT_ALL), some base libraries register functions under multiple names.
@@ -221,7 +231,7 @@ static void update_lookup_entry(lua_State* const L_, StackIndex const ctxBase_,
 
 // #################################################################################################
 
-static void populate_lookup_table_recur(lua_State* const L_, StackIndex const dbIdx_, StackIndex const i_, TableIndex const depth_)
+static void populate_lookup_table_recur(lua_State* const L_, StackIndex const dbIdx_, StackIndex const i_, TableIndex const depth_, LookupIndex::Recorder* const recorder_)
 {
     // slot dbIdx_ contains the lookup database table
     // slot dbIdx_ + 1 contains a table that, when concatenated, produces the fully qualified name of scanned elements in the table provided at slot i_
@@ -282,15 +292,15 @@ static void populate_lookup_table_recur(lua_State* const L_, StackIndex const db
             lua_pushvalue(L_, -2);                                                                 // L_: ... {i_} {bfc} k {} k {}
             lua_rawset(L_, _breadthFirstCache);                                                    // L_: ... {i_} {bfc} k {}
             // generate a name, and if we already had one name, keep whichever is the shorter
-            update_lookup_entry(L_, dbIdx_, depth_);                                               // L_: ... {i_} {bfc} k
+            update_lookup_entry(L_, dbIdx_, depth_, recorder_);                                    // L_: ... {i_} {bfc} k
         } else if (lua_isfunction(L_, kIdxTop) && (luaW_getfuncsubtype(L_, kIdxTop) != FuncSubType::Bytecode)) {
             // generate a name, and if we already had one name, keep whichever is the shorter
             // this pops the function from the stack
-            update_lookup_entry(L_, dbIdx_, depth_);                                               // L_: ... {i_} {bfc} k
+            update_lookup_entry(L_, dbIdx_, depth_, recorder_);                                    // L_: ... {i_} {bfc} k
         } else if (luaW_type(L_, kIdxTop) == LuaType::USERDATA) {
             // generate a name, and if we already had one name, keep whichever is the shorter
             // this pops the userdata from the stack
-            update_lookup_entry(L_, dbIdx_, depth_);                                               // L_: ... {i_} {bfc} k
+            update_lookup_entry(L_, dbIdx_, depth_, recorder_);                                    // L_: ... {i_} {bfc} k
         } else {
             lua_pop(L_, 1);                                                                        // L_: ... {i_} {bfc} k
         }
@@ -319,7 +329,7 @@ static void populate_lookup_table_recur(lua_State* const L_, StackIndex const db
         // push table name in fqn stack (note that concatenation will crash if name is a not string!)
         lua_pushvalue(L_, -2);                                                                     // L_: ... {i_} {bfc} k {} k
         lua_rawseti(L_, _fqn, _deeper);                                                            // L_: ... {i_} {bfc} k {}
-        populate_lookup_table_recur(L_, dbIdx_, StackIndex{ lua_gettop(L_) }, _deeper);
+        populate_lookup_table_recur(L_, dbIdx_, StackIndex{ lua_gettop(L_) }, _deeper, recorder_);
         lua_pop(L_, 1);                                                                            // L_: ... {i_} {bfc} k
         STACK_CHECK(L_, 2);
     }
@@ -334,27 +344,161 @@ static void populate_lookup_table_recur(lua_State* const L_, StackIndex const db
 
 // #################################################################################################
 
+// binds the object at the top of the stack to a name found in the universe lookup index, keeping the name update_lookup_entry() would select
+// pops the object from the stack
+static void bind_lookup_entry(lua_State* const L_, StackIndex const dbIdx_, std::string_view const& fqn_)
+{
+    STACK_CHECK_START_REL(L_, 0);
+    lua_pushvalue(L_, -1);                                                                         // L_: ... o o
+    lua_rawget(L_, dbIdx_);                                                                        // L_: ... o name?
+    std::string_view const _prevName{ luaW_tostring(L_, kIdxTop) };
+    if (!_prevName.empty() && ((_prevName.size() < fqn_.size()) || (_prevName <= fqn_))) {
+        lua_pop(L_, 2);                                                                            // L_: ...
+    } else {
+        if (!_prevName.empty()) {
+            // t[prevName] = nil
+            lua_pushnil(L_);                                                                       // L_: ... o prevName nil
+            lua_rawset(L_, dbIdx_);                                                                // L_: ... o
+        } else {
+            lua_pop(L_, 1);                                                                        // L_: ... o
+        }
+        luaW_pushstring(L_, fqn_);                                                                 // L_: ... o "f.q.n"
+        lua_pushvalue(L_, -1);                                                                     // L_: ... o "f.q.n" "f.q.n"
+        lua_pushvalue(L_, -3);                                                                     // L_: ... o "f.q.n" "f.q.n" o
+        // t["f.q.n"] = o
+        lua_rawset(L_, dbIdx_);                                                                    // L_: ... o "f.q.n"
+        // t[o] = "f.q.n"
+        lua_rawset(L_, dbIdx_);                                                                    // L_: ...
+    }
+    STACK_CHECK(L_, -1);
+}
+
+// #################################################################################################
+
+// bind the modules registered since the last time, in registration order
+static void bind_pending_modules(Universe* const U_, lua_State* const L_)
+{
+    STACK_GROW(L_, 5);
+    STACK_CHECK_START_REL(L_, 0);
+    kLookupBindingsRegKey.pushValue(L_);                                                           // L_: {b}|nil
+    if (lua_isnil(L_, -1)) {
+        lua_pop(L_, 1);                                                                            // L_:
+        return;
+    }
+    lua_rawgeti(L_, -1, 0);                                                                        // L_: {b} bound
+    int const _bound{ static_cast<int>(lua_tointeger(L_, -1)) };
+    int const _count{ static_cast<int>(lua_rawlen(L_, -2)) };
+    lua_pop(L_, 1);                                                                                // L_: {b}
+    if (_bound < _count) {
+        DEBUGSPEW_CODE(DebugSpew(U_) << L_ << ": binding " << (_count - _bound) << " module(s) from the lookup index" << std::endl);
+        kLookupRegKey.pushValue(L_);                                                               // L_: {b} {db}
+        StackIndex const _dbIdx{ lua_gettop(L_) };
+        for (int const _i : std::ranges::iota_view{ _bound + 1, _count + 1 }) {
+            lua_rawgeti(L_, -2, _i);                                                               // L_: {b} {db} {m}
+            lua_rawgeti(L_, -1, 1);                                                                // L_: {b} {db} {m} module
+            lua_rawgeti(L_, -2, 2);                                                                // L_: {b} {db} {m} module "name"
+            LookupIndex::Module const* const _module{ U_->lookupIndex.find(luaW_tostring(L_, kIdxTop)) };
+            LUA_ASSERT(L_, _module != nullptr); // modules are never removed from the index
+            _module->forEach(L_, StackIndex{ -2 }, [L_, _dbIdx](std::string_view const& fqn_) { bind_lookup_entry(L_, _dbIdx, fqn_); });
+            lua_pop(L_, 3);                                                                        // L_: {b} {db}
+        }
+        lua_pop(L_, 1);                                                                            // L_: {b}
+        lua_pushinteger(L_, _count);                                                               // L_: {b} count
+        lua_rawseti(L_, -2, 0);                                                                    // L_: {b}
+    }
+    lua_pop(L_, 1);                                                                                // L_:
+    STACK_CHECK(L_, 0);
+}
+
+// #################################################################################################
+
+// walk the table module at in_base_, and record what we find there if requested
+// the lookup database must be at the top of the stack, the walk stores its context right above it
+static void walk_module(lua_State* const L_, StackIndex const in_base_, std::string_view const& name_, LookupIndex::Recorder* const recorder_)
+{
+    StackIndex const _dbIdx{ lua_gettop(L_) };
+    LUA_ASSERT(L_, lua_istable(L_, _dbIdx));
+    STACK_GROW(L_, 3);
+    STACK_CHECK_START_REL(L_, 0);
+    lua_newtable(L_);                                                                              // L_: {fqn}
+    TableIndex _startDepth{ 0 };
+    if (!name_.empty()) {
+        luaW_pushstring(L_, name_);                                                                // L_: {fqn} "name"
+        // generate a name, and if we already had one name, keep whichever is the shorter
+        lua_pushvalue(L_, in_base_);                                                               // L_: {fqn} "name" t
+        update_lookup_entry(L_, _dbIdx, _startDepth, recorder_);                                   // L_: {fqn} "name"
+        // don't forget to store the name at the bottom of the fqn stack
+        lua_rawseti(L_, -2, ++_startDepth);                                                        // L_: {fqn}
+        STACK_CHECK(L_, 1);
+    }
+    if (recorder_) {
+        // other states bind only what we record: the walk must not skip the tables this state already visited through other modules
+        lua_newtable(L_);                                                                          // L_: {fqn} {cache}
+    } else {
+        // retrieve the cache, create it if we haven't done it yet
+        std::ignore = kLookupCacheRegKey.getSubTable(L_, NArr{ 0 }, NRec{ 0 });                    // L_: {fqn} {cache}
+    }
+    // process everything we find in that table, filling in lookup data for all functions and tables we see there
+    populate_lookup_table_recur(L_, _dbIdx, in_base_, _startDepth, recorder_);
+    lua_pop(L_, 2);                                                                                // L_:
+    STACK_CHECK(L_, 0);
+}
+
+// #################################################################################################
+
 namespace tools {
 
+    // walk the modules that were only bound from the universe index, to find what the index doesn't know about
+    // (the module registered in this state under a given name can differ from the one that was walked to build the index)
+    // returns false if there is nothing left to walk
+    [[nodiscard]]
+    bool CompleteLookupDatabase(Universe* const U_, lua_State* const L_)
+    {
+        STACK_GROW(L_, 5);
+        STACK_CHECK_START_REL(L_, 0);
+        bind_pending_modules(U_, L_);
+        kLookupBindingsRegKey.pushValue(L_);                                                       // L_: {b}|nil
+        if (lua_isnil(L_, -1)) {
+            lua_pop(L_, 1);                                                                        // L_:
+            return false;
+        }
+        int const _count{ static_cast<int>(lua_rawlen(L_, -1)) };
+        DEBUGSPEW_CODE(DebugSpew(U_) << L_ << ": walking " << _count << " module(s) missing from the lookup index" << std::endl);
+        for (int const _i : std::ranges::iota_view{ 1, _count + 1 }) {
+            lua_rawgeti(L_, -1, _i);                                                               // L_: {b} {m}
+            lua_rawgeti(L_, -1, 1);                                                                // L_: {b} {m} module
+            lua_rawgeti(L_, -2, 2);                                                                // L_: {b} {m} module "name"
+            kLookupRegKey.pushValue(L_);                                                           // L_: {b} {m} module "name" {db}
+            walk_module(L_, StackIndex{ lua_gettop(L_) - 2 }, luaW_tostring(L_, StackIndex{ -2 }), nullptr);
+            lua_pop(L_, 4);                                                                        // L_: {b}
+        }
+        lua_pop(L_, 1);                                                                            // L_:
+        // these modules are fully known now
+        kLookupBindingsRegKey.setValue(L_, [](lua_State* L_) { lua_pushnil(L_); });
+        STACK_CHECK(L_, 0);
+        return _count > 0;
+    }
+
+    // #############################################################################################
+
     // create a "fully.qualified.name" <-> function equivalence database
+    // a table module that was already walked in another state is only bound on the first lookup, from what the universe index recorded
     void PopulateFuncLookupTable(lua_State* const L_, StackIndex const i_, std::string_view const& name_)
     {
         StackIndex const _in_base{ luaW_absindex(L_, i_) };
-        DEBUGSPEW_CODE(Universe* _U = Universe::Get(L_));
+        Universe* const _U{ Universe::Get(L_) };
         std::string_view _name{ name_.empty() ? std::string_view{} : name_ };
         DEBUGSPEW_CODE(DebugSpew(_U) << L_ << ": PopulateFuncLookupTable('" << _name << "')" << std::endl);
         DEBUGSPEW_CODE(DebugSpewIndentScope _scope{ _U });
         STACK_GROW(L_, 3);
         STACK_CHECK_START_REL(L_, 0);
-        kLookupRegKey.pushValue(L_);                                                               // L_: {}
-        StackIndex const _dbIdx{ lua_gettop(L_) };
-        STACK_CHECK(L_, 1);
-        LUA_ASSERT(L_, lua_istable(L_, -1));
         LuaType const _moduleType{ luaW_type(L_, _in_base) };
         if ((_moduleType == LuaType::FUNCTION) || (_moduleType == LuaType::USERDATA)) { // for example when a module is a simple function
             if (_name.empty()) {
                 _name = "nullptr";
             }
+            kLookupRegKey.pushValue(L_);                                                           // L_: {}
+            LUA_ASSERT(L_, lua_istable(L_, -1));
             lua_pushvalue(L_, _in_base);                                                           // L_: {} f
             luaW_pushstring(L_, _name);                                                            // L_: {} f name_
             lua_rawset(L_, -3);                                                                    // L_: {}
@@ -362,31 +506,48 @@ namespace tools {
             lua_pushvalue(L_, _in_base);                                                           // L_: {} name_ f
             lua_rawset(L_, -3);                                                                    // L_: {}
             lua_pop(L_, 1);                                                                        // L_:
-        } else if (luaW_type(L_, _in_base) == LuaType::TABLE) {
-            lua_newtable(L_);                                                                      // L_: {} {fqn}
-            TableIndex _startDepth{ 0 };
-            if (!_name.empty()) {
-                STACK_CHECK(L_, 2);
-                luaW_pushstring(L_, _name);                                                        // L_: {} {fqn} "name"
-                // generate a name, and if we already had one name, keep whichever is the shorter
-                lua_pushvalue(L_, _in_base);                                                       // L_: {} {fqn} "name" t
-                update_lookup_entry(L_, _dbIdx, _startDepth);                                      // L_: {} {fqn} "name"
-                // don't forget to store the name at the bottom of the fqn stack
-                lua_rawseti(L_, -2, ++_startDepth);                                                // L_: {} {fqn}
-                STACK_CHECK(L_, 2);
+        } else if (_moduleType == LuaType::TABLE) {
+            if (_U && _U->lookupIndex.find(_name)) {
+                // remember the module, it will be bound when the database is needed
+                std::ignore = kLookupBindingsRegKey.getSubTable(L_, NArr{ 1 }, NRec{ 0 });         // L_: {b}
+                lua_createtable(L_, 2, 0);                                                         // L_: {b} {m}
+                lua_pushvalue(L_, _in_base);                                                       // L_: {b} {m} module
+                lua_rawseti(L_, -2, 1);                                                            // L_: {b} {m}
+                luaW_pushstring(L_, _name);                                                        // L_: {b} {m} "name"
+                lua_rawseti(L_, -2, 2);                                                            // L_: {b} {m}
+                lua_rawseti(L_, -2, static_cast<int>(lua_rawlen(L_, -2)) + 1);                     // L_: {b}
+                lua_pop(L_, 1);                                                                    // L_:
+            } else {
+                // modules registered earlier must be processed first so that we select the same names as a full walk would
+                if (_U) {
+                    bind_pending_modules(_U, L_);
+                }
+                kLookupRegKey.pushValue(L_);                                                       // L_: {}
+                LUA_ASSERT(L_, lua_istable(L_, -1));
+                if (_U) {
+                    LookupIndex::Recorder _recorder{ _U, TableIndex{ _name.empty() ? 0 : 1 } };
+                    walk_module(L_, _in_base, _name, &_recorder);
+                    _U->lookupIndex.publish(_name, _recorder);
+                } else {
+                    walk_module(L_, _in_base, _name, nullptr);
+                }
+                lua_pop(L_, 1);                                                                    // L_:
             }
-            // retrieve the cache, create it if we haven't done it yet
-            std::ignore = kLookupCacheRegKey.getSubTable(L_, NArr{ 0 }, NRec{ 0 });                // L_: {} {fqn} {cache}
-            // process everything we find in that table, filling in lookup data for all functions and tables we see there
-            populate_lookup_table_recur(L_, _dbIdx, _in_base, _startDepth);
-            lua_pop(L_, 3);                                                                        // L_:
         } else {
-            lua_pop(L_, 1);                                                                        // L_:
             raise_luaL_error(L_, "unsupported module type %s", luaW_typename(L_, _in_base).data());
         }
         STACK_CHECK(L_, 0);
     }
 
+    // #############################################################################################
+
+    // the lookup database of the state, with the modules registered since the last time bound in it
+    void PushLookupDatabase(Universe* const U_, lua_State* const L_)
+    {
+        bind_pending_modules(U_, L_);
+        kLookupRegKey.pushValue(L_);                                                               // L_: {}
+    }
+
 } // namespace tools
 
 // #################################################################################################
@@ -34,9 +34,12 @@ static constexpr RegistryUniqueKey kLookupRegKey{ 0xBF1FC5CF3C6DD47Bull }; // re
 // #################################################################################################
 
 namespace tools {
+    [[nodiscard]]
+    bool CompleteLookupDatabase(Universe* U_, lua_State* L_);
     void PopulateFuncLookupTable(lua_State* L_, StackIndex i_, std::string_view const& name_);
     [[nodiscard]]
     std::string_view PushFQN(lua_State* L_, StackIndex t_);
     void PushFunctionBytecode(SourceState L1_, DestState L2_, int strip_);
+    void PushLookupDatabase(Universe* U_, lua_State* L_);
     void SerializeRequire(lua_State* L_);
 } // namespace tools
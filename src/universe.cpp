@@ -187,6 +187,10 @@ Universe* Universe::Create(lua_State* const L_)
     }
     lua_pop(L_, 1);                                                                                // L_: settings
 
+    std::ignore = luaW_getfield(L_, kIdxSettings, "linda_spin");                                   // L_: settings linda_spin
+    _U->lindaSpinDuration = lua_Duration{ lua_tonumber(L_, kIdxTop) };
+    lua_pop(L_, 1);                                                                                // L_: settings
+
     std::ignore = luaW_getfield(L_, kIdxSettings, "strip_functions");                              // L_: settings strip_functions
     _U->stripFunctions = lua_toboolean(L_, -1) ? true : false;
     lua_pop(L_, 1);                                                                                // L_: settings
@@ -209,6 +213,25 @@ Universe* Universe::Create(lua_State* const L_)
     _U->keepers.initialize(*_U, L_, static_cast<size_t>(_nbUserKeepers), _keepers_gc_threshold);
     STACK_CHECK(L_, 0);
 
+    std::ignore = luaW_getfield(L_, kIdxSettings, "state_pool_scrub");                            // L_: settings state_pool_scrub
+    StatePool::Scrub const _scrub{ (luaW_tostring(L_, kIdxTop) == "none") ? StatePool::Scrub::None : StatePool::Scrub::Globals };
+    lua_pop(L_, 1);                                                                                // L_: settings
+    std::ignore = luaW_getfield(L_, kIdxSettings, "state_pool");                                   // L_: settings state_pool
+    _U->statePool.initialize(*_U, static_cast<int>(lua_tointeger(L_, kIdxTop)), _scrub);
+    lua_pop(L_, 1);                                                                                // L_: settings
+    STACK_CHECK(L_, 0);
+
+    std::ignore = luaW_getfield(L_, kIdxSettings, "max_running");                                  // L_: settings max_running
+    if (luaW_type(L_, kIdxTop) == LuaType::NUMBER) {
+        _U->workerPool.initialize(*_U, static_cast<int>(lua_tointeger(L_, kIdxTop)));
+    } else {
+        LUA_ASSERT(L_, luaW_tostring(L_, kIdxTop) == "auto");
+        // hardware_concurrency() can be 0 when it can't tell
+        _U->workerPool.initialize(*_U, 2 * static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)));
+    }
+    lua_pop(L_, 1);                                                                                // L_: settings
+    STACK_CHECK(L_, 0);
+
     // Initialize 'timerLinda'; a common Linda object shared by all states
     _U->timerLinda = Linda::CreateTimerLinda(L_, PK);
     return _U;
@@ -396,7 +419,7 @@ bool Universe::terminateFreeRunningLanes(lua_Duration const shutdownTimeout_, Ca
                 // attempt the requested cancel with a small timeout.
                 // if waiting on a linda, they will raise a cancel_error.
                 // if a cancellation hook is desired, it will be installed to try to raise an error
-                if (_lane->thread.joinable()) {
+                if (_lane->isStarted()) {
                     std::ignore = _lane->cancel(op_, std::chrono::steady_clock::now() + 1us, WakeLane::Yes, 1);
                 }
                 _lane = _lane->selfdestruct_next;
@@ -502,6 +525,12 @@ int Universe::UniverseGC(lua_State* const L_)
     // we don't reach that point if some lanes are still running
     // ---------------------------------------------------------
 
+    // all lanes are done, but their workers may still be on their way back to the pool
+    _U->workerPool.close();
+
+    // the idle states may hold proxies to lindas, so they must be closed while the keepers are still there
+    _U->statePool.close();
+
     // no need to mutex-protect this as all lanes in the universe are gone at that point
     Linda::DeleteTimerLinda(L_, std::exchange(_U->timerLinda, nullptr), PK);
 
@@ -509,6 +538,8 @@ int Universe::UniverseGC(lua_State* const L_)
         raise_luaL_error(L_, "INTERNAL ERROR: Keepers closed more than once");
     }
 
+    _U->lookupIndex.clear(*_U);
+
     // remove the protected allocator, if any
     _U->protectedAllocator.removeFrom(L_);
 
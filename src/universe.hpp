@@ -4,9 +4,12 @@
 #include "cancel.hpp"
 #include "keeper.hpp"
 #include "lanesconf.h"
+#include "lookupindex.hpp"
+#include "statepool.hpp"
 #include "threading.hpp"
 #include "tracker.hpp"
 #include "uniquekey.hpp"
+#include "workerpool.hpp"
 
 // #################################################################################################
 
@@ -110,6 +113,8 @@ class Universe final
     uint32_t convertMaxAttempts{ 1 };
 
     lua_Duration lindaWakePeriod{};
+    // how long threads blocked in a linda operation busy-wait before they actually block, when the linda doesn't say otherwise
+    lua_Duration lindaSpinDuration{};
 
     // Initialized by 'init_once_LOCKED()': the deep userdata Linda object
     // used for timers (each lane will get a proxy to this)
@@ -117,6 +122,15 @@ class Universe final
 
     LaneTracker tracker;
 
+    // what the lookup database walks found in each module, to bind them in other states without walking them again
+    LookupIndex lookupIndex;
+
+    // the states of the lanes that ended, ready for reuse (disabled unless configured)
+    StatePool statePool;
+
+    // the OS threads that run the lanes, when they don't get one each (disabled unless configured)
+    WorkerPool workerPool;
+
     // Protects modifying the selfdestruct chain
     mutable std::mutex selfdestructMutex;
 
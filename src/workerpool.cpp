@@ -0,0 +1,207 @@
+/*
+ * WORKERPOOL.CPP                   Copyright (c) 2026-, Benoit Germain
+ *
+ * Bounded pool of OS threads running the lanes.
+ */
+
+/*
+===============================================================================
+
+Copyright (C) 2026- benoit Germain <bnt.germain@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+===============================================================================
+*/
+#include "_pch.hpp"
+#include "workerpool.hpp"
+
+#include "lane.hpp"
+#include "universe.hpp"
+
+// #################################################################################################
+
+// only called when the universe is collected: all lanes are done, and the workers are either idle or about to be
+void WorkerPool::close()
+{
+    if (!isEnabled()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> _guard{ mutex };
+        assert(firstQueued == nullptr);
+        stopping = true;
+    }
+    workCondVar.notify_all();
+    // no worker can start or exit anymore, so we can walk the chain without the mutex
+    while (workers) {
+        Worker* const _worker{ std::exchange(workers, workers->next) };
+        if (_worker->thread.joinable()) {
+            _worker->thread.join();
+        }
+        _worker->~Worker();
+        U->internalAllocator.free(_worker, sizeof(Worker));
+    }
+    maxRunning = 0;
+}
+
+// #################################################################################################
+
+// start a queued lane if the bound allows it, waking an idle worker or starting a new one to run it
+// each event that can make a lane startable (submission, a lane that blocks, a lane that ends) calls this once
+void WorkerPool::dispatch()
+{
+    int const _startable{ std::min(nbQueued, maxRunning - nbRunning) };
+    if (_startable <= 0) {
+        return;
+    }
+    // an idle worker that was notified but didn't wake yet is still counted as idle: it will pick a lane when it does
+    if (nbIdle < _startable) {
+        spawnWorker();
+    } else {
+        workCondVar.notify_one();
+    }
+}
+
+// #################################################################################################
+
+void WorkerPool::initialize(Universe& U_, int const maxRunning_)
+{
+    U = &U_;
+    maxRunning = maxRunning_;
+}
+
+// #################################################################################################
+
+// in: the mutex the lane is about to wait on is locked, which is fine because the pool never locks another mutex while it holds its own
+void WorkerPool::laneBlocks()
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    --nbRunning;
+    dispatch();
+}
+
+// #################################################################################################
+
+// the lane doesn't wait for a slot before it proceeds, because it still holds the mutex it waited on
+// the bound is temporarily exceeded instead, and no queued lane starts until enough running lanes block or end
+void WorkerPool::laneResumes()
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    ++nbRunning;
+}
+
+// #################################################################################################
+
+void WorkerPool::release(Lane& lane_)
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    lane_.workerReleased = true;
+    releaseCondVar.notify_all();
+}
+
+// #################################################################################################
+
+void WorkerPool::run(Worker& worker_)
+{
+    THREAD_SETNAME("lanes worker");
+    std::unique_lock<std::mutex> _guard{ mutex };
+    // spawnWorker() already counted us as idle
+    for (;;) {
+        workCondVar.wait(_guard, [this]() { return stopping || (nbQueued > 0 && nbRunning < maxRunning); });
+        --nbIdle;
+        if (stopping) {
+            break;
+        }
+        Lane* const _lane{ std::exchange(firstQueued, firstQueued->nextQueued) };
+        if (firstQueued == nullptr) {
+            lastQueued = nullptr;
+        }
+        --nbQueued;
+        ++nbRunning;
+        _guard.unlock();
+        if (!Lane::RunOnWorker(_lane)) {
+            // the universe is gone, and the pool with it: nothing left to touch
+            return;
+        }
+        _guard.lock();
+        --nbRunning;
+        // don't keep more idle workers than the lanes that can run at the same time
+        bool const _exit{ nbIdle >= maxRunning };
+        if (!_exit) {
+            ++nbIdle;
+        }
+        dispatch();
+        if (_exit) {
+            break;
+        }
+    }
+    worker_.exited = true;
+}
+
+// #################################################################################################
+
+void WorkerPool::spawnWorker()
+{
+    // reuse the slot of a worker that exited, if any
+    Worker* _worker{ workers };
+    while (_worker && !_worker->exited) {
+        _worker = _worker->next;
+    }
+    if (_worker) {
+        // it flagged itself with the mutex we hold, and it doesn't touch it anymore
+        _worker->thread.join();
+        _worker->exited = false;
+    } else {
+        void* const _mem{ U->internalAllocator.alloc(sizeof(Worker)) };
+        if (_mem == nullptr) {
+            return;
+        }
+        _worker = new (_mem) Worker{};
+        _worker->next = workers;
+        workers = _worker;
+    }
+    // the new worker counts as idle right away, so that we don't start another one for the same lane before it gets the mutex
+    ++nbIdle;
+    _worker->thread = std::thread([this, _worker]() { run(*_worker); });
+}
+
+// #################################################################################################
+
+void WorkerPool::submit(Lane& lane_)
+{
+    std::lock_guard<std::mutex> _guard{ mutex };
+    lane_.nextQueued = nullptr;
+    if (lastQueued) {
+        lastQueued->nextQueued = &lane_;
+    } else {
+        firstQueued = &lane_;
+    }
+    lastQueued = &lane_;
+    ++nbQueued;
+    dispatch();
+}
+
+// #################################################################################################
+
+void WorkerPool::waitForRelease(Lane const& lane_)
+{
+    std::unique_lock<std::mutex> _guard{ mutex };
+    releaseCondVar.wait(_guard, [&lane_]() { return lane_.workerReleased; });
+}
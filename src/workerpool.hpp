@@ -0,0 +1,60 @@
+#pragma once
+
+// forwards
+class Lane;
+class Universe;
+
+// #################################################################################################
+
+// runs the lanes on reused OS threads instead of a std::thread per lane, at most 'maxRunning' of them running Lua code at the same time
+// the others wait in the queue until a running lane blocks or ends
+// a lane that blocks in a Lanes operation (linda, synchronization primitive, lanes.wait_any(), join, or yielding as a coroutine) gives its slot to a queued lane
+// the worker stays with its blocked lane, and more workers are started so that the queued lanes can run: this bounds concurrency, not the number of threads
+class WorkerPool final
+{
+    private:
+    struct Worker
+    {
+        std::thread thread;
+        Worker* next{ nullptr };
+        bool exited{ false }; // protected by mutex, true when the thread is done and can be joined
+    };
+
+    Universe* U{ nullptr };
+    // protects everything below, and Lane::nextQueued and Lane::workerReleased of the lanes handled by the pool
+    std::mutex mutex;
+    // the workers wait there for a lane to run
+    std::condition_variable workCondVar;
+    // the threads that want to delete a lane wait there for the worker to let go of it
+    std::condition_variable releaseCondVar;
+    Worker* workers{ nullptr };
+    // lanes waiting for a worker, in submission order
+    Lane* firstQueued{ nullptr };
+    Lane* lastQueued{ nullptr };
+    int nbQueued{ 0 };
+    int nbIdle{ 0 }; // workers waiting for a lane
+    int nbRunning{ 0 }; // lanes that run on a worker, and are not blocked
+    int maxRunning{ 0 }; // 0 when the pool is disabled
+    bool stopping{ false };
+
+    // in: mutex is locked
+    void dispatch();
+    void run(Worker& worker_);
+    // in: mutex is locked
+    void spawnWorker();
+
+    public:
+    // only called when the universe is collected, once all lanes are done
+    void close();
+    void initialize(Universe& U_, int maxRunning_);
+    [[nodiscard]]
+    bool isEnabled() const { return maxRunning > 0; }
+    // called by a lane running on a worker when it starts and stops blocking
+    void laneBlocks();
+    void laneResumes();
+    // called by a lane running on a worker when it no longer needs it, after which the lane can be deleted
+    void release(Lane& lane_);
+    void submit(Lane& lane_);
+    // wait until the worker that ran the lane is done with it
+    void waitForRelease(Lane const& lane_);
+};
@@ -1,35 +1,56 @@
+--
+-- PINGPONG.LUA
+--
+-- Two lanes bounce a counter back and forth through a linda, which measures the latency of a linda handoff
+--
+-- Usage:
+--      lua pingpong.lua [rounds] [spin...]
+--
+--      rounds: number of round trips (default 1000)
+--      spin: the spin durations of the lindas to compare, in seconds (default 0 and 0.00005)
+--
+-- For each spin duration, reports the average round trip time, and the CPU time spent by the process during the run.
+-- A CPU time close to twice the wall time means both lanes were busy-waiting most of the time.
+--
+
 local lanes = require "lanes"
-local q = lanes.linda()
 
-local pingpong = function(name, qr, qs, start)
-    print("start " .. name, qr, qs, start)
+local rounds = tonumber(arg and arg[1]) or 1000
+local spins = {}
+for i = 2, (arg and #arg or 0) do
+    spins[#spins + 1] = assert(tonumber(arg[i]), "spin durations must be numbers")
+end
+if #spins == 0 then
+    spins = {0, 0.00005}
+end
+
+local pingpong = function(q, qr, qs, start, rounds)
     local count = 0
     if start then
-        print(name .. ": sending " .. qs .. " 0")
         q:send(qs, 0)
     end
-    while count < 10 do
-        print(name .. ": receiving " .. qr)
+    while count < rounds do
         local key, val = q:receive(qr)
         if val == nil then
-            print(name .. ": timeout")
-            break
+            return "timeout"
         end
-        print(name .. ":" .. val)
-        val = val + 1
-        print(name .. ": sending " .. qs .. " " .. tostring(val + 1))
-        q:send(qs, val)
+        q:send(qs, val + 1)
         count = count + 1
     end
     return "ping!"
 end
 
--- pingpong("L1", '0', '1', true)
-local t1, err1 = lanes.gen("*", { name = 'auto' }, pingpong)("L1", 'a', 'b', true)
-local t2, err2 = lanes.gen("*", { name = 'auto' }, pingpong)("L2", 'b', 'a', false)
-
-local r1, ret1 = t1:join()
-assert(r1 == true and ret1 == "ping!")
-local r2, ret2 = t2:join()
-assert(r2 == true and ret2 == "ping!")
+local gen = lanes.gen("*", { name = 'auto' }, pingpong)
+for _, spin in ipairs(spins) do
+    local q = lanes.linda{ name = "pingpong", spin = spin }
+    local wall0, cpu0 = lanes.now_secs(), os.clock()
+    local t1 = gen(q, 'a', 'b', true, rounds)
+    local t2 = gen(q, 'b', 'a', false, rounds)
+    local r1, ret1 = t1:join()
+    assert(r1 == true and ret1 == "ping!", ret1)
+    local r2, ret2 = t2:join()
+    assert(r2 == true and ret2 == "ping!", ret2)
+    local wall, cpu = lanes.now_secs() - wall0, os.clock() - cpu0
+    print(string.format("spin %gs: %d round trips in %.3fs (%.2fus per round trip), CPU %.3fs (%d%% of wall time)", spin, rounds, wall, wall * 1e6 / rounds, cpu, math.floor(cpu * 100 / wall)))
+end
 print "TEST OK"
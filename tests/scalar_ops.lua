@@ -0,0 +1,81 @@
+--
+-- SCALAR_OPS.LUA
+--
+-- Measures the cost of single-threaded linda operations that only carry scalars (numbers, short strings, booleans)
+--
+-- Usage:
+--      lua scalar_ops.lua [count] [-save=file|-compare=file]
+--
+--      count: number of times each operation is repeated (default 200000)
+--      -save: also writes the results in 'file'
+--      -compare: reads the results of a previous run from 'file', and reports the difference with this run for each operation
+--
+-- For each operation, reports the average time per call. The scalar rows only copy their arguments and results through
+-- the direct path of InterCopyContext::interCopy(). Each "table" row repeats the previous operation with a value that
+-- forces the generic path (cache table and interCopyOne() dispatch): the difference bounds the per-op saving, although
+-- it also includes the copy of that table itself. The table is nested so that linda:send() doesn't store it packed.
+--
+-- To measure the saving itself, save the results of a run with Lanes built with LANES_NO_SCALAR_COPY_PATH defined,
+-- then compare them with a run with the regular build. 'make scalar_ops-compare' does both.
+--
+
+local lanes = require "lanes"
+
+local count = 200000
+local save_file, compare_file
+for _, v in ipairs(arg or {}) do
+    if v:sub(1, 6) == "-save=" then
+        save_file = v:sub(7)
+    elseif v:sub(1, 9) == "-compare=" then
+        compare_file = v:sub(10)
+    else
+        count = assert(tonumber(v), "unexpected argument " .. v)
+    end
+end
+
+-- ns/op of each operation of a previous run, by name
+local baseline = {}
+if compare_file then
+    for line in io.lines(compare_file) do
+        local name, ns = line:match("^(.-)\t(.+)$")
+        baseline[name] = tonumber(ns)
+    end
+end
+local results = {}
+
+print(string.format("%s%s, count = %d", _VERSION, jit and (" (" .. jit.version .. ")") or "", count))
+local l = lanes.linda{name = "scalar_ops"}
+local nested = {{}}
+
+local measure = function(name_, op_)
+    collectgarbage()
+    local t1 = lanes.now_secs()
+    for i = 1, count do
+        op_(i)
+    end
+    local ns = (lanes.now_secs() - t1) * 1e9 / count
+    table.insert(results, string.format("%s\t%.17g", name_, ns))
+    local before = baseline[name_]
+    if before then
+        print(string.format("%-28s %8.1f ns/op (was %8.1f, saved %6.1f ns/op, %5.1f%%)", name_, ns, before, before - ns, (before - ns) * 100 / before))
+    else
+        print(string.format("%-28s %8.1f ns/op", name_, ns))
+    end
+end
+
+measure("set(k, number)", function(i) l:set("k", i) end)
+measure("set(k, table)", function(i) l:set("k", nested) end)
+measure("set(k, string)", function(i) l:set("k", "x") end)
+measure("get(k)", function(i) l:get("k") end)
+measure("send(k, number)", function(i) l:send("q", i) end)
+measure("receive(k) -> number", function(i) l:receive("q") end)
+measure("send(k, table)", function(i) l:send("q", nested) end)
+measure("receive(k) -> table", function(i) l:receive("q") end)
+measure("incr(k)", function(i) l:incr("n") end)
+measure("count(k)", function(i) l:count("k") end)
+
+if save_file then
+    local f = assert(io.open(save_file, "w"))
+    f:write(table.concat(results, "\n"), "\n")
+    f:close()
+end
@@ -94,6 +94,151 @@ TEST_CASE("misc.deep_userdata.example")
     }
 }
 
+// #################################################################################################
+// #################################################################################################
+
+TEST_CASE("misc.deep_userdata.blob")
+{
+    LuaState S{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
+    S.requireSuccess(" lanes = require 'lanes'.configure()");
+
+    SECTION("creation")
+    {
+        S.requireFailure(" lanes.blob()");
+        S.requireFailure(" lanes.blob({})");
+        S.requireFailure(" lanes.blob('a', 'b')");
+        S.requireSuccess(" b = lanes.blob('') assert(#b == 0 and b:len() == 0 and b:tostring() == '')");
+        S.requireSuccess(" b = lanes.blob('hello\\0world') assert(type(b) == 'userdata' and getmetatable(b) == 'Blob')");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("accessors")
+    {
+        S.requireSuccess(" b = lanes.blob('hello world')");
+        S.requireSuccess(" assert(#b == 11 and b:len() == 11)");
+        S.requireSuccess(" assert(tostring(b) == 'hello world' and b:tostring() == 'hello world')");
+        S.requireSuccess(" assert(b .. '!' == 'hello world!' and '>' .. b == '>hello world')");
+        // sub() and byte() behave like their string counterparts, including negative and out-of-range positions
+        S.requireSuccess(" for _, r in ipairs{{1}, {7}, {-5}, {3, 5}, {0, 100}, {-100, 2}, {5, 3}, {12}, {-1, -1}} do local u = table.unpack or unpack assert(b:sub(u(r)) == ('hello world'):sub(u(r))) end");
+        S.requireSuccess(" assert(b:byte() == 104 and select('#', b:byte(5, 3)) == 0)");
+        S.requireSuccess(" local x, y, z = b:byte(-3, -1) assert(x == 114 and y == 108 and z == 100)");
+        S.requireSuccess(" assert(select('#', b:byte(1, -1)) == 11)");
+        S.requireFailure(" b:sub()");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("sharing")
+    {
+        // the blob goes through the linda by reference, the bytes are never copied
+        S.requireSuccess(
+            " b = lanes.blob(string.rep('x', 1000000))"
+            " l = lanes.linda()"
+            " l:send('k', b)"
+            " local _, b2 = l:receive('k')"
+            " assert(b2 == b)"                             // same state, same proxy
+        );
+        S.requireSuccess(
+            " local g = lanes.gen('*', function(b_) return b_:len(), b_:sub(-3) end)"
+            " local r, n, tail = g(b):join()"
+            " assert(r == true and n == 1000000 and tail == 'xxx')"
+        );
+    }
+}
+
+// #################################################################################################
+// #################################################################################################
+
+TEST_CASE("misc.deep_userdata.sync")
+{
+    LuaState S{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
+    S.requireSuccess(" lanes = require 'lanes'.configure()");
+
+    SECTION("creation")
+    {
+        S.requireFailure(" lanes.mutex(1)");
+        S.requireFailure(" lanes.semaphore(-1)");
+        S.requireFailure(" lanes.semaphore(2, 1)");
+        S.requireFailure(" lanes.barrier(0)");
+        S.requireFailure(" lanes.latch(-1)");
+        S.requireSuccess(" m = lanes.mutex() assert(type(m) == 'userdata' and getmetatable(m) == 'Mutex')");
+        S.requireSuccess(" s = lanes.semaphore() assert(getmetatable(s) == 'Semaphore')");
+        S.requireSuccess(" b = lanes.barrier(2) assert(getmetatable(b) == 'Barrier')");
+        S.requireSuccess(" l = lanes.latch(0) assert(getmetatable(l) == 'Latch')");
+        // methods check the kind of the primitive they are called on
+        S.requireFailure(" lanes.mutex().lock(lanes.semaphore())");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("mutex")
+    {
+        S.requireSuccess(" m = lanes.mutex()");
+        S.requireFailure(" m:unlock()");                      // not locked
+        S.requireSuccess(" assert(m:lock() == true)");
+        S.requireFailure(" m:lock()");                        // would deadlock
+        S.requireSuccess(" assert(m:try_lock() == false)");
+        // another lane can't lock it until we release it
+        S.requireSuccess(
+            " local g = lanes.gen('*', function(m_) local r = m_:lock(0.1) if r then m_:unlock() end return r end)"
+            " local r, locked = g(m):join()"
+            " assert(r == true and locked == false)"
+        );
+        S.requireSuccess(" m:unlock() assert(m:try_lock() == true) m:unlock()");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("semaphore")
+    {
+        S.requireSuccess(" s = lanes.semaphore(1, 2)");
+        S.requireSuccess(" assert(s:try_acquire() == true and s:try_acquire() == false)");
+        S.requireSuccess(" assert(s:acquire(0) == false)");
+        S.requireSuccess(" s:release(2)");
+        S.requireFailure(" s:release()");                     // exceeds max
+        S.requireSuccess(" assert(s:acquire() == true and s:acquire(0) == true and s:try_acquire() == false)");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("barrier and latch")
+    {
+        // the last lane to arrive releases the others, and the barrier can be reused
+        S.requireSuccess(
+            " local b, l = lanes.barrier(3), lanes.latch(2)"
+            " local g = lanes.gen('*', function(b_, l_) assert(b_:arrive_and_wait()) assert(b_:arrive_and_wait()) l_:count_down() return true end)"
+            " local h1, h2 = g(b, l), g(b, l)"
+            " assert(b:arrive_and_wait() == true)"
+            " b:arrive_and_drop()"
+            " assert(l:wait(5) == true and l:try_wait() == true)"
+            " assert(h1:join() == true and h2:join() == true)"
+        );
+        S.requireSuccess(" local l = lanes.latch(1) assert(l:wait(0) == false and l:try_wait() == false)");
+        S.requireFailure(" lanes.latch(1):count_down(2)");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("cancellation")
+    {
+        // a lane blocked on a primitive is woken by a cancel request
+        S.requireSuccess(
+            " local m = lanes.mutex() m:lock()"
+            " local g = lanes.gen('*', function(m_) return m_:lock() end)"
+            " local h = g(m)"
+            " repeat until h.status == 'waiting'"
+            " assert(h:cancel('soft', 1, true))"
+            " local r, v, e = h:join()"
+            " assert(r == true and v == nil and e == lanes.cancel_error)"
+            " m:unlock()"
+        );
+    }
+}
+
+// #################################################################################################
+// #################################################################################################
+
 #define MAKE_TEST_CASE(DIR, FILE, CONDITION) \
     TEST_CASE("scripted_tests." #DIR "." #FILE) \
     { \
@@ -441,6 +441,41 @@ TEST_CASE("lanes.configure.keepers_gc_threshold")
 
 // #################################################################################################
 
+TEST_CASE("lanes.configure.linda_spin")
+{
+    LuaState L{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
+
+    // linda_spin should be a number >= 0
+
+    SECTION("linda_spin = <string>")
+    {
+        L.requireFailure("require 'lanes'.configure{linda_spin = 'gluh'}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("linda_spin = <negative number>")
+    {
+        L.requireFailure("require 'lanes'.configure{linda_spin = -0.001}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("linda_spin = 0")
+    {
+        L.requireSuccess("require 'lanes'.configure{linda_spin = 0}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("linda_spin = 0.0001s")
+    {
+        L.requireSuccess("require 'lanes'.configure{linda_spin = 0.0001}");
+    }
+}
+
+// #################################################################################################
+
 TEST_CASE("lanes.configure.linda_wake_period")
 {
     LuaState L{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
@@ -497,6 +532,62 @@ TEST_CASE("lanes.configure.linda_wake_period")
 
 // #################################################################################################
 
+TEST_CASE("lanes.configure.max_running")
+{
+    LuaState L{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
+
+    // max_running should be 'auto' or an integer in [0, 1000]
+
+    SECTION("max_running = <string>")
+    {
+        L.requireFailure("require 'lanes'.configure{max_running = 'gluh'}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("max_running = <negative number>")
+    {
+        L.requireFailure("require 'lanes'.configure{max_running = -1}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("max_running = <non-integer number>")
+    {
+        L.requireFailure("require 'lanes'.configure{max_running = 2.5}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("max_running = 1001")
+    {
+        L.requireFailure("require 'lanes'.configure{max_running = 1001}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("max_running = 0")
+    {
+        L.requireSuccess("require 'lanes'.configure{max_running = 0}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("max_running = 'auto'")
+    {
+        L.requireSuccess("require 'lanes'.configure{max_running = 'auto'}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("max_running = 1, with timers")
+    {
+        L.requireSuccess("local lanes = require 'lanes'.configure{max_running = 1, with_timers = true}; assert(lanes.gen('*', function() return 42 end)()[1] == 42)");
+    }
+}
+
+// #################################################################################################
+
 TEST_CASE("lanes.configure.nb_user_keepers")
 {
     LuaState L{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
@@ -695,6 +786,90 @@ TEST_CASE("lanes.configure.shutdown_timeout")
 
 // #################################################################################################
 
+TEST_CASE("lanes.configure.state_pool")
+{
+    LuaState L{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
+
+    // state_pool should be an integer in [0, 1000]
+
+    SECTION("state_pool = <string>")
+    {
+        L.requireFailure("require 'lanes'.configure{state_pool = 'gluh'}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool = <negative number>")
+    {
+        L.requireFailure("require 'lanes'.configure{state_pool = -1}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool = <non-integer number>")
+    {
+        L.requireFailure("require 'lanes'.configure{state_pool = 1.5}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool = 1001")
+    {
+        L.requireFailure("require 'lanes'.configure{state_pool = 1001}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool = 0")
+    {
+        L.requireSuccess("require 'lanes'.configure{state_pool = 0}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool = 4")
+    {
+        L.requireSuccess("require 'lanes'.configure{state_pool = 4}");
+    }
+}
+
+// #################################################################################################
+
+TEST_CASE("lanes.configure.state_pool_scrub")
+{
+    LuaState L{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
+
+    // state_pool_scrub should be 'globals' or 'none'
+
+    SECTION("state_pool_scrub = <number>")
+    {
+        L.requireFailure("require 'lanes'.configure{state_pool_scrub = 1}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool_scrub = <unknown string>")
+    {
+        L.requireFailure("require 'lanes'.configure{state_pool_scrub = 'gluh'}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool_scrub = 'globals'")
+    {
+        L.requireSuccess("require 'lanes'.configure{state_pool = 2, state_pool_scrub = 'globals'}");
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    SECTION("state_pool_scrub = 'none'")
+    {
+        L.requireSuccess("require 'lanes'.configure{state_pool = 2, state_pool_scrub = 'none'}");
+    }
+}
+
+// #################################################################################################
+
 TEST_CASE("lanes.configure.strip_functions")
 {
     LuaState L{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ false } };
@@ -449,15 +449,22 @@ TEST_CASE("scripted_tests." #DIR "." #FILE) \
 
 MAKE_TEST_CASE(lane, body_is_a_c_function, AssertNoLuaError)
 MAKE_TEST_CASE(lane, cooperative_shutdown, AssertNoLuaError)
+MAKE_TEST_CASE(lane, lookup_index, AssertNoLuaError)
+MAKE_TEST_CASE(lane, parallel, AssertNoLuaError)
+MAKE_TEST_CASE(lane, state_pool, AssertNoLuaError)
+MAKE_TEST_CASE(lane, workers, AssertNoLuaError)
+MAKE_TEST_CASE(lane, workers_join, AssertNoLuaError)
 MAKE_TEST_CASE_54(lane, uncooperative_shutdown, AssertWarns) // NOTE: when this test ends, there are resource leaks and a dangling thread
 MAKE_TEST_CASE(lane, tasking_basic, AssertNoLuaError)
 MAKE_TEST_CASE(lane, tasking_cancelling_with_hook, AssertNoLuaError)
 MAKE_TEST_CASE(lane, tasking_cancelling, AssertNoLuaError)
+MAKE_TEST_CASE(lane, tasking_cancel_wakeup, AssertNoLuaError)
 MAKE_TEST_CASE(lane, tasking_comms_criss_cross, AssertNoLuaError)
 MAKE_TEST_CASE(lane, tasking_communications, AssertNoLuaError)
 MAKE_TEST_CASE(lane, tasking_error, AssertNoLuaError)
 MAKE_TEST_CASE(lane, tasking_join_test, AssertNoLuaError)
 MAKE_TEST_CASE(lane, tasking_send_receive_code, AssertNoLuaError)
+MAKE_TEST_CASE(lane, tasking_wait_any_all, AssertNoLuaError)
 MAKE_TEST_CASE(lane, stdlib_naming, AssertNoLuaError)
 MAKE_TEST_CASE(coro, cancelling_suspended, AssertNoLuaError)
 MAKE_TEST_CASE_54(coro, collect_yielded_lane, AssertNoLuaError)
@@ -1,6 +1,11 @@
 #include "_pch.hpp"
 #include "shared.h"
 
+#ifdef PLATFORM_LINUX
+#include <poll.h>
+#include <unistd.h>
+#endif // PLATFORM_LINUX
+
 // #################################################################################################
 
 TEST_CASE("linda.single_keeper.creation/no_argument")
@@ -109,6 +114,22 @@ TEST_CASE("linda.single_keeper.creation/wake_period")
 
 // #################################################################################################
 
+TEST_CASE("linda.single_keeper.creation/spin")
+{
+    LuaState S{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ true } };
+    S.requireSuccess("lanes = require 'lanes'");
+
+    // spin should be a number >= 0
+    S.requireFailure("lanes.linda{spin = false}");
+    S.requireFailure("lanes.linda{spin = 'bob'}");
+    S.requireFailure("lanes.linda{spin = {}}");
+    S.requireFailure("lanes.linda{spin = -1}");
+    S.requireSuccess("lanes.linda{spin = 0}");
+    S.requireSuccess("lanes.linda{spin = 0.0001}");
+}
+
+// #################################################################################################
+
 TEST_CASE("linda.single_keeper.indexing")
 {
     LuaState S{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ true } };
@@ -365,6 +386,59 @@ TEST_CASE("linda.single_keeper.the_rest")
     }
 }
 
+// #################################################################################################
+
+#ifdef PLATFORM_LINUX
+TEST_CASE("linda.single_keeper.fd()")
+{
+    LuaState S{ LuaState::WithBaseLibs{ true }, LuaState::WithFixture{ true } };
+    S.requireSuccess("lanes = require 'lanes'");
+    S.requireSuccess("l = lanes.linda()");
+
+    S.requireFailure("l:fd({})");
+    S.requireFailure("l:fd('slot', 'other')");
+
+    auto const _fdOf = [&S](std::string_view const& script_) { return std::stoi(std::string{ S.doStringAndRet(script_) }); };
+    auto const _isReadable = [](int const fd_) {
+        pollfd _pfd{ fd_, POLLIN, 0 };
+        return poll(&_pfd, 1, 0) == 1;
+    };
+    auto const _drain = [](int const fd_) {
+        uint64_t _count{};
+        return read(fd_, &_count, sizeof(_count)) == sizeof(_count);
+    };
+
+    SECTION("slot fd")
+    {
+        int const _fd{ _fdOf("return tostring(l:fd('slot'))") };
+        // the same slot always yields the same descriptor
+        REQUIRE(_fdOf("return tostring(l:fd('slot'))") == _fd);
+        // readable right away, so that data sent before it was created is not missed
+        REQUIRE(_isReadable(_fd));
+        REQUIRE(_drain(_fd));
+        REQUIRE(!_isReadable(_fd));
+        // writes in other slots don't signal it
+        S.requireSuccess("l:send('other', 1)");
+        REQUIRE(!_isReadable(_fd));
+        S.requireSuccess("l:send('slot', 1)");
+        REQUIRE(_isReadable(_fd));
+        REQUIRE(_drain(_fd));
+        S.requireSuccess("l:set('slot', 1)");
+        REQUIRE(_isReadable(_fd));
+    }
+
+    SECTION("linda fd")
+    {
+        int const _fd{ _fdOf("return tostring(l:fd())") };
+        REQUIRE(_fdOf("return tostring(l:fd())") == _fd);
+        REQUIRE(_drain(_fd));
+        REQUIRE(!_isReadable(_fd));
+        S.requireSuccess("l:send('other', 1)");
+        REQUIRE(_isReadable(_fd));
+    }
+}
+#endif // PLATFORM_LINUX
+
 // #################################################################################################
 // #################################################################################################
 
@@ -380,6 +454,12 @@ TEST_CASE("linda.multi Keeper")
     S.requireSuccess("lanes.linda{group = 2}");
     S.requireSuccess("lanes.linda{group = 3}");
     S.requireFailure("lanes.linda{group = 4}");
+
+    // a sharded linda spreads its slots over all keepers, so it has no group
+    S.requireSuccess("lanes.linda{sharded = true}");
+    S.requireSuccess("lanes.linda{sharded = false, group = 1}");
+    S.requireFailure("lanes.linda{sharded = true, group = 1}");
+    S.requireFailure("lanes.linda{sharded = 1}");
 }
 
 // #################################################################################################
@@ -395,11 +475,24 @@ TEST_CASE("scripted_tests." #DIR "." #FILE) \
     _runner.performTest(FileRunnerParam{ #DIR "/" #FILE, TestType::AssertNoLuaError }); \
 }
 
+MAKE_TEST_CASE(linda, atomics)
+MAKE_TEST_CASE(linda, batch)
+MAKE_TEST_CASE(linda, keeper_gc)
 MAKE_TEST_CASE(linda, multiple_keepers)
+MAKE_TEST_CASE(linda, post)
+MAKE_TEST_CASE(linda, select)
 MAKE_TEST_CASE(linda, send_receive)
 MAKE_TEST_CASE(linda, send_receive_func_and_string)
+MAKE_TEST_CASE(linda, send_receive_packed)
+MAKE_TEST_CASE(linda, send_receive_same_func)
 MAKE_TEST_CASE(linda, send_receive_tables)
+MAKE_TEST_CASE(linda, send_receive_wraparound)
 MAKE_TEST_CASE(linda, send_registered_userdata)
+MAKE_TEST_CASE(linda, sharded)
+MAKE_TEST_CASE(linda, slots)
+MAKE_TEST_CASE(linda, spin)
+MAKE_TEST_CASE(linda, stats)
+MAKE_TEST_CASE(linda, targeted_wakeups)
 MAKE_TEST_CASE(linda, wake_period)
 
 /*
@@ -0,0 +1,29 @@
+local lanes = require "lanes".configure()
+
+-- the lookup database of a lane is bound from what was found in the master state
+-- native functions and tables of the standard libraries go both ways
+local l = lanes.linda{name = "lookup_index"}
+local gen = lanes.gen("*", { name = 'auto' }, function()
+	local _, f, t = l:receive("to lane", 2)
+	assert(f == string.format and t == string)
+	l:send("to master", io.write, string.rep, os)
+	return f("%d", 42)
+end)
+l:send("to lane", string.format, string)
+local h = gen()
+local _, w, r, o = l:receive_batched("to master", 3)
+assert(w == io.write and r == string.rep and o == os)
+assert(h[1] == "42")
+
+-- a module registered under a name that is already indexed, but with different contents, is walked when the index doesn't know what we look for
+lanes.register("lookup_index_module", { lower = string.lower })
+local other = lanes.gen("*", { name = 'auto' }, function()
+	local upper = string.upper
+	-- only the module knows about this function now
+	string.upper = nil
+	lanes.register("lookup_index_module", { upper = upper })
+	l:send("self", upper)
+	local _, f = l:receive("self")
+	return f == upper and f("a")
+end)
+assert(other()[1] == "A")
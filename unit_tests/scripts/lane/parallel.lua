@@ -0,0 +1,65 @@
+local lanes = require "lanes".configure()
+
+-- bad arguments
+assert(pcall(lanes.parallel_for, -1, function() end) == false)
+assert(pcall(lanes.parallel_for, 1.5, function() end) == false)
+assert(pcall(lanes.parallel_for, 10, "not a function") == false)
+assert(pcall(lanes.parallel_for, 10, function() end, { workers = 0 }) == false)
+assert(pcall(lanes.parallel_for, 10, function() end, { chunk = "big" }) == false)
+assert(pcall(lanes.parallel_for, 10, function() end, { unknown_option = true }) == false)
+assert(pcall(lanes.map, "not a table", function() end) == false)
+
+-- empty jobs don't start any lane
+local r, n = lanes.parallel_for(0, function(i_) return i_ end)
+assert(next(r) == nil and n == 0)
+r, n = lanes.map({}, function(v_) return v_ end)
+assert(next(r) == nil and n == 0)
+
+-- results are gathered in order, whatever the chunking
+for _, opts in ipairs{ {}, { workers = 1 }, { workers = 3, chunk = 1 }, { workers = 8, chunk = 7 }, { chunk = 1000 } } do
+	r, n = lanes.parallel_for(100, function(i_) return i_ * i_ end, opts)
+	assert(n == 100)
+	for i = 1, 100 do
+		assert(r[i] == i * i)
+	end
+end
+
+-- upvalues of the body are transferred with it
+local offset = 1000
+r, n = lanes.parallel_for(50, function(i_) return i_ + offset end, { workers = 4 })
+for i = 1, 50 do
+	assert(r[i] == i + offset)
+end
+
+-- map passes the value and its index
+local words = {}
+for i = 1, 200 do
+	words[i] = "w" .. i
+end
+r, n = lanes.map(words, function(v_, i_) return v_ .. ":" .. i_ end, { workers = 4, chunk = 9 })
+assert(n == 200)
+for i = 1, 200 do
+	assert(r[i] == "w" .. i .. ":" .. i)
+end
+
+-- nil results leave holes
+r, n = lanes.map({ 1, 2, 3, 4 }, function(v_) if v_ % 2 == 0 then return v_ end end, { workers = 2, chunk = 1 })
+assert(n == 4 and r[1] == nil and r[2] == 2 and r[3] == nil and r[4] == 4)
+
+-- an error in the body is raised in the caller
+local ok, err = pcall(lanes.parallel_for, 100, function(i_) if i_ == 42 then error("boom at " .. i_, 0) end return i_ end, { workers = 4, chunk = 5 })
+assert(ok == false and err == "boom at 42", tostring(err))
+ok, err = pcall(lanes.map, { 1, 2, 3 }, function(v_) if v_ == 2 then error("bad value", 0) end end)
+assert(ok == false and err == "bad value", tostring(err))
+
+-- each index is processed exactly once, lane options are forwarded to the workers
+local l = lanes.linda{name = "parallel"}
+r = lanes.parallel_for(64, function(i_)
+	l:incr("items")
+	return l:incr("seen" .. i_)
+end, { workers = 4, chunk = 3, name = "parallel worker" })
+for i = 1, 64 do
+	assert(r[i] == 1)
+end
+local _, items = l:get("items")
+assert(items == 64)
@@ -0,0 +1,51 @@
+local lanes = require "lanes".configure{state_pool = 2}
+
+-- a lane that ended on its own gives its state back to the pool, where the next lane with the same libs and requires finds it
+local first = lanes.gen("*", { name = 'auto' }, function()
+	-- the registry is not restored: this shows up in the next lane that reuses the state
+	debug.getregistry().state_pool_marker = true
+	leftover = "global"
+	package.loaded.leftover = true
+	package.path = "nowhere"
+	-- the standard libraries and the metatables of _G and of strings are restored
+	string.leftover = true
+	string.rep = nil
+	setmetatable(_G, {})
+	getmetatable("").leftover = true
+	return package.path
+end)
+assert(first()[1] == "nowhere")
+
+local second = lanes.gen("*", { name = 'auto' }, function(path_)
+	assert(debug.getregistry().state_pool_marker == true, "the state was not reused")
+	assert(getmetatable(_G) == nil)
+	assert(leftover == nil and package.loaded.leftover == nil)
+	assert(string.leftover == nil and getmetatable("").leftover == nil)
+	assert(("x"):rep(2) == "xx")
+	-- the package of the new lane is transferred as usual
+	assert(package.path == path_)
+	-- the lane helpers are installed again, for the new lane
+	assert(type(lane_threadname) == "function" and type(set_finalizer) == "function")
+	return true
+end)
+assert(second(package.path)[1] == true)
+
+-- a lane with other libraries never sees that state
+local other = lanes.gen("base,string,debug", { name = 'auto' }, function()
+	return debug.getregistry().state_pool_marker == nil
+end)
+assert(other()[1] == true)
+
+-- a cancelled lane closes its state
+local linda = lanes.linda()
+local cancelled = lanes.gen("*", { name = 'auto' }, function()
+	debug.getregistry().state_pool_marker = "cancelled"
+	linda:receive("never")
+end)()
+assert(cancelled:cancel("soft", 1) == true)
+-- gathering the results of the lane is what releases its state
+cancelled:join()
+local third = lanes.gen("*", { name = 'auto' }, function()
+	return debug.getregistry().state_pool_marker ~= "cancelled"
+end)
+assert(third()[1] == true)
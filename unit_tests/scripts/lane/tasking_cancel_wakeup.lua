@@ -0,0 +1,24 @@
+local lanes = require "lanes".configure{linda_wake_period = 'never'}
+
+-- lindas that never wake by themselves: only the cancel request can end the wait before the timeout
+local l = lanes.linda{name = "wakeup"}
+local ls = lanes.linda{name = "sharded wakeup", sharded = true}
+
+local blockers = {
+	receive = function() return l:receive(30, "empty") end,
+	send = function() l:limit("full", 0) return l:send(30, "full", "x") end,
+	select = function() return lanes.select(30, {{l, "empty"}, {ls, "a", "b", "c"}}) end,
+	sleep = function() return lanes.sleep(30) end,
+}
+
+-- cancel right after launching, without waiting for the lane to block, so that the request can land at any point of the blocking sequence
+for name, blocker in pairs(blockers) do
+	local gen = lanes.gen("*", { name = name }, blocker)
+	for i = 1, 50 do
+		local h = gen()
+		local t0 = lanes.now_secs()
+		local r, status = h:cancel("soft", 5, true)
+		assert(r == true, name .. " lane was not woken by the cancel request: " .. tostring(status))
+		assert(lanes.now_secs() - t0 < 5, name .. " lane woke too late")
+	end
+end
@@ -0,0 +1,78 @@
+local lanes = require "lanes".configure()
+
+-- lanes that end when told so through a linda
+local l = lanes.linda{name = "wait_any_all"}
+local gen = lanes.gen("*", { name = 'auto' }, function(i_)
+	local _, v = l:receive("go" .. i_)
+	if v == "error" then
+		error "boom"
+	end
+	return i_
+end)
+
+local handles = {}
+for i = 1, 10 do
+	handles[i] = gen(i)
+end
+
+-- bad arguments
+assert(pcall(lanes.wait_any) == false)
+assert(pcall(lanes.wait_any, {}) == false)
+assert(pcall(lanes.wait_any, {"not a lane"}) == false)
+assert(pcall(lanes.wait_all, -1, handles) == false)
+
+-- nothing completed yet
+local i, h = lanes.wait_any(0, handles)
+assert(i == nil and h == "timeout")
+assert(lanes.wait_all(0.1, handles) == nil)
+
+-- the first lane to complete is reported with its position, whether the lanes are given in an array or as arguments
+l:send("go7", true)
+i, h = lanes.wait_any(handles)
+assert(i == 7 and h == handles[7] and h.status == "done" and h[1] == 7)
+i, h = lanes.wait_any(5, handles[1], handles[7])
+assert(i == 2 and h == handles[7])
+
+-- errors complete lanes too
+l:send("go3", "error")
+i, h = lanes.wait_any(5, handles[1], handles[2], handles[3])
+assert(i == 3 and h.status == "error")
+
+-- wait_all waits for the last one
+local sender = lanes.gen("*", function()
+	for j = 10, 1, -1 do
+		l:send("go" .. j, true)
+	end
+	return true
+end)()
+assert(lanes.wait_all(5, handles) == true)
+for j = 1, 10 do
+	local status = handles[j].status
+	assert(status == "done" or status == "error")
+end
+assert(lanes.wait_all(0, handles) == true)
+assert(sender:join() == true)
+
+-- a lane waiting in wait_any() is woken by a cancel request
+-- lane handles can't be transferred, so the waiting lane waits on a lane of its own
+local lb = lanes.linda{name = "blocker"}
+local canceled = lanes.gen("*", function()
+	local blocked = lanes.gen("*", function() return lb:receive("never") end)()
+	return lanes.wait_any(blocked)
+end)()
+repeat until canceled.status == "waiting"
+assert(canceled:cancel("soft", 5, true))
+local r, i, h = canceled:join()
+assert(r == true and i == nil and h == lanes.cancel_error)
+lb:cancel("both")
+
+-- scatter/gather over many lanes
+local square = lanes.gen("*", function(i_) return i_ * i_ end)
+local many = {}
+for j = 1, 200 do
+	many[j] = square(j)
+end
+assert(lanes.wait_all(many) == true)
+for j = 1, 200 do
+	assert(many[j][1] == j * j)
+end
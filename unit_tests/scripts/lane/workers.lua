@@ -0,0 +1,55 @@
+local lanes = require "lanes".configure{max_running = 2}
+
+-- more lanes than workers, that all block until the last one is created: they must all get a worker eventually
+local l = lanes.linda{name = "workers"}
+local N = 10
+local gen = lanes.gen("*", { name = 'auto' }, function(i_)
+	l:send("started", i_)
+	local _, v = l:receive("go")
+	return v + i_
+end)
+local h = {}
+for i = 1, N do
+	h[i] = gen(i)
+end
+-- they all block at the same time, each on a worker of its own
+for _ = 1, N do
+	local k = l:receive(3, "started")
+	assert(k == "started", "a lane didn't get a worker")
+end
+for _ = 1, N do
+	l:send("go", 100)
+end
+for i = 1, N do
+	assert(h[i][1] == 100 + i)
+end
+
+-- each lane waits for a value from the lane created after it: the queued lanes run while the previous ones are blocked
+local chain = lanes.gen("*", { name = 'auto' }, function(i_, n_)
+	local v = 0
+	if i_ < n_ then
+		local _
+		_, v = l:receive("chain" .. (i_ + 1))
+	end
+	l:send("chain" .. i_, v + 1)
+	return v + 1
+end)
+local c = {}
+for i = 1, N do
+	c[i] = chain(i, N)
+end
+assert(c[1][1] == N)
+
+-- coroutine lanes give their worker back while suspended
+local coro = lanes.coro("*", { name = 'auto' }, function()
+	coroutine.yield(1)
+	return 2
+end)
+local co = {}
+for i = 1, N do
+	co[i] = coro()
+	assert(co[i]:resume() == 1)
+end
+for i = 1, N do
+	assert(co[i][1] == 2)
+end
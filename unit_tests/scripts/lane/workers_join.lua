@@ -0,0 +1,36 @@
+local lanes = require "lanes".configure{max_running = 1}
+
+-- with a single worker, a lane that waits for a lane it created must give its worker back, else the child never runs
+
+-- join()
+local joiner = lanes.gen("*", { name = 'auto' }, function()
+	local lanes = require "lanes"
+	local child = lanes.gen("*", { name = 'auto' }, function() return 42 end)()
+	local ok, v = child:join()
+	return ok and v
+end)()
+local ok, v = joiner:join(5)
+assert(ok == true and v == 42, "joining a child lane deadlocked")
+
+-- indexing the results
+local indexer = lanes.gen("*", { name = 'auto' }, function()
+	local lanes = require "lanes"
+	local child = lanes.gen("*", { name = 'auto' }, function() return 43 end)()
+	return child[1]
+end)()
+ok, v = indexer:join(5)
+assert(ok == true and v == 43, "reading the results of a child lane deadlocked")
+
+-- resume()
+local resumer = lanes.gen("*", { name = 'auto' }, function()
+	local lanes = require "lanes"
+	local child = lanes.coro("*", { name = 'auto' }, function(a_)
+		local b = coroutine.yield(a_ + 1)
+		return b + 1
+	end)(1)
+	-- resume() returns the yielded values, and passes its arguments to the coroutine as the results of yield()
+	local y = child:resume(10)
+	return y, child[1]
+end)()
+local ok2, y, r = resumer:join(5)
+assert(ok2 == true and y == 2 and r == 11, "resuming a child coroutine lane deadlocked")
@@ -0,0 +1,90 @@
+local lanes = require "lanes"
+
+local l = lanes.linda{name = "atomics"}
+
+-- an empty slot counts as 0
+assert(l:incr("n") == 1)
+assert(l:incr("n", 41) == 42)
+assert(l:incr("n", -2) == 40)
+assert(l:get("n") == 40)
+-- a fractional delta turns the counter into a float
+assert(l:incr("n", 0.5) == 40.5)
+-- a slot that doesn't hold a number can't be incremented
+l:set("s", "hello")
+assert(pcall(l.incr, l, "s") == false)
+assert(l:get("s") == "hello")
+-- the delta must be a number
+assert(pcall(l.incr, l, "n", "1") == false)
+
+-- cas replaces the value only if it is the expected one
+assert(l:cas("c", nil, "first") == true)
+local ok, cur = l:cas("c", nil, "second")
+assert(ok == false and cur == "first")
+assert(l:cas("c", "first", "second") == true)
+assert(l:get("c") == "second")
+-- storing nil empties the slot
+assert(l:cas("c", "second", nil) == true)
+assert(l:count("c") == 0)
+
+-- swap returns the previous value
+assert(l:swap("w", 1) == nil)
+assert(l:swap("w", 2) == 1)
+assert(l:swap("w", nil) == 2)
+assert(l:count("w") == 0)
+
+-- atomics see the oldest value of a slot filled by send(), and replace all of its contents
+assert(l:send("q", 10, 20, 30) == true)
+assert(l:swap("q", "x") == 10)
+assert(l:count("q") == 1 and l:get("q") == "x")
+l:set("q")
+assert(l:send("q", 5) == true)
+assert(l:incr("q", 1) == 6)
+assert(l:count("q") == 1)
+
+-- the limit is ignored
+l:limit("full", 1)
+assert(l:send("full", 1) == true)
+assert(l:incr("full") == 2)
+assert(l:count("full") == 1)
+
+-- atomics are forbidden on slots restricted to send/receive
+l:restrict("r", "send/receive")
+assert(pcall(l.incr, l, "r") == false)
+assert(pcall(l.cas, l, "r", nil, 1) == false)
+assert(pcall(l.swap, l, "r", 1) == false)
+l:restrict("r", "none")
+
+-- a value written by an atomic operation wakes a blocked reader
+local reader = lanes.gen("*", function(l_) return l_:receive(5, "wake") end)(l)
+repeat until reader.status == "waiting"
+assert(l:swap("wake", "up") == nil)
+local r, k, v = reader:join()
+assert(r == true and k == "wake" and v == "up")
+
+-- genatomic counters are consistent when several lanes hammer them
+local counter = lanes.genatomic(l, "counter")
+local hammer = lanes.gen("*", function(l_, n_)
+	for i = 1, n_ do
+		l_:incr("counter")
+	end
+	return true
+end)
+local lanes_ = {}
+for i = 1, 4 do
+	lanes_[i] = hammer(l, 1000)
+end
+for i = 1, 4 do
+	assert(lanes_[i]:join() == true)
+end
+assert(counter(0) == 4000)
+assert(counter() == 4001)
+assert(counter(-1) == 4000)
+
+-- a cancelled linda refuses atomic operations
+l:cancel("both")
+local v, e = l:incr("n")
+assert(v == nil and e == lanes.cancel_error)
+v, e = l:cas("n", 40.5, 0)
+assert(v == nil and e == lanes.cancel_error)
+v, e = l:swap("n", 0)
+assert(v == nil and e == lanes.cancel_error)
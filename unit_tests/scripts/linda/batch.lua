@@ -0,0 +1,72 @@
+-- additional keepers, so that the slots of a sharded linda are spread over several of them
+local lanes = require "lanes".configure{nb_user_keepers = 3}
+
+local l = lanes.linda{name = "batch"}
+
+-- each operation gets a table of its results, with a field 'n'
+local r = l:batch{
+	{"send", "a", 1, 2, 3},
+	{"set", "b", "x", "y"},
+	{"receive", "a"},
+	{"get", "b", 2},
+	{"limit", "c", 1},
+	{"limit", "c"},
+}
+assert(#r == 6)
+assert(r[1].n == 1 and r[1][1] == true)
+assert(r[2].n == 1 and r[2][1] == false)
+assert(r[3].n == 1 and r[3][1] == 1)
+assert(r[4].n == 3 and r[4][1] == 2 and r[4][2] == "x" and r[4][3] == "y")
+assert(r[5].n == 2 and r[5][1] == false)
+assert(r[6].n == 2 and r[6][1] == 1)
+assert(l:count("a") == 2)
+
+-- nothing blocks: a full slot refuses the data, an empty slot returns nothing
+r = l:batch{
+	{"send", "c", "first"},
+	{"send", "c", "second"},
+	{"receive", "empty"},
+	{"limit", "c", "unlimited"},
+	{"send", "c", "third"},
+}
+assert(r[1][1] == true and r[2][1] == false and r[3].n == 0 and r[5][1] == true)
+assert(l:receive(0, "c") == "c" and l:count("c") == 1)
+
+-- an empty batch is fine
+assert(#l:batch{} == 0)
+
+-- malformed operations are rejected before anything runs
+assert(pcall(l.batch, l, {{"send", "a"}}) == false)
+assert(pcall(l.batch, l, {{"peek", "a"}}) == false)
+assert(pcall(l.batch, l, {{"get", "a", 0}}) == false)
+assert(pcall(l.batch, l, {{"limit", "a", -1}}) == false)
+assert(pcall(l.batch, l, {{"receive", "a", "b"}}) == false)
+assert(pcall(l.batch, l, {"send"}) == false)
+assert(pcall(l.batch, l, {{"send", {}, 1}}) == false)
+assert(l:count("a") == 2)
+
+-- a restricted slot makes the whole batch fail, none of its operations run
+l:restrict("r", "set/get")
+local ok, err = pcall(l.batch, l, {{"send", "a", 4}, {"send", "r", 1}})
+assert(ok == false and string.find(err, "operation #2", 1, true))
+assert(l:count("a") == 2)
+
+-- lanes blocked on a slot are woken by a batch
+local reader = lanes.gen("*", function(l_) return l_:receive(5, "wake") end)(l)
+repeat until reader.status == "waiting"
+l:batch{{"send", "wake", "up"}}
+local k, v = reader:join()
+assert(k == "wake" and v == "up")
+
+-- all the slots of a batch must be held by the same keeper
+local s = lanes.linda{name = "sharded batch", sharded = true}
+local slots = {}
+for i = 1, 32 do
+	slots[#slots + 1] = {"send", "k" .. i, i}
+end
+assert(pcall(s.batch, s, slots) == false)
+
+-- a cancelled linda is reported
+l:cancel("both")
+local c, e = l:batch{{"get", "b"}}
+assert(c == nil and e == lanes.cancel_error)
@@ -0,0 +1,19 @@
+-- keeper GC is stopped, and stepped by the keeper operations once memory usage reaches 500 KB
+local lanes = require "lanes".configure{nb_user_keepers = 1, keepers_gc_threshold = 500}
+
+local l = lanes.linda{name = "gc", group = 1}
+
+local s = l:stats()
+assert(s.keepers[1].gc_steps == 0 and s.keepers[1].gc == 0)
+
+-- nested tables can't be packed: they are copied inside the keeper state, where they become garbage once received
+for i = 1, 20000 do
+	assert(l:send("slot", {{i, tostring(i)}}) == true)
+	local k, v = l:receive("slot")
+	assert(k == "slot" and v[1][1] == i)
+end
+
+-- garbage was collected a bit at a time, and never raised a threshold error
+s = l:stats()
+assert(s.keepers[1].gc_steps > 0 and s.keepers[1].gc > 0)
+assert(s.keepers[1].gc <= s.keepers[1].hold)
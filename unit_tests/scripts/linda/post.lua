@@ -0,0 +1,84 @@
+local lanes = require "lanes"
+
+local l = lanes.linda{name = "post"}
+
+-- posted values are visible to the next operation on the linda
+assert(l:post("k", 1, 2, 3) == true)
+assert(l:post("k", "four", {5}) == true)
+assert(l:count("k") == 5)
+local k, a, b, c = l:receive_batched("k", 3)
+assert(k == "k" and a == 1 and b == 2 and c == 3)
+local _, four = l:receive("k")
+assert(four == "four")
+local _, t = l:receive("k")
+assert(type(t) == "table" and t[1] == 5)
+
+-- a lane's posts and sends to a slot reach it in the order they were made
+for i = 1, 10 do
+	if i % 2 == 0 then
+		l:send("order", i)
+	else
+		l:post("order", i)
+	end
+end
+for i = 1, 10 do
+	local _, v = l:receive(0, "order")
+	assert(v == i)
+end
+
+-- values that can't be serialized in native memory can't be posted
+assert(pcall(l.post, l, "k", print) == false)
+assert(pcall(l.post, l, "k", {{1}}) == false)
+assert(pcall(l.post, l, "k") == false)
+assert(pcall(l.post, l, {}, 1) == false)
+
+-- posts don't wait for room in the slot: the values that don't fit are dropped, and counted as such
+l:limit("full", 1)
+assert(l:stats().dropped_posts == 0)
+assert(l:post("full", "a") == true)
+assert(l:post("full", "b", "c") == true)
+assert(l:count("full") == 1)
+assert(select(2, l:get("full")) == "a")
+assert(l:stats().dropped_posts == 2)
+l:set("full")
+
+-- values posted to a restricted slot are dropped too
+l:restrict("r", "set/get")
+assert(l:post("r", 1) == true)
+assert(l:count("r") == 0)
+assert(l:stats().dropped_posts == 3)
+
+-- a lane blocked on a slot is woken by a post
+local reader = lanes.gen("*", function(l_) return l_:receive(5, "wake") end)(l)
+repeat until reader.status == "waiting"
+assert(l:post("wake", "up") == true)
+local wk, wv = reader:join()
+assert(wk == "wake" and wv == "up")
+
+-- several lanes posting at the same time: each one's values arrive in order
+local N, M = 4, 200
+local poster = lanes.gen("*", function(l_, id_, m_)
+	for i = 1, m_ do
+		l_:post("many", id_, i)
+	end
+	return true
+end)
+local posters = {}
+for id = 1, N do
+	posters[id] = poster(l, id, M)
+end
+for id = 1, N do
+	assert(posters[id]:join() == true)
+end
+local last = {}
+for _ = 1, N * M do
+	local _, id, i = l:receive_batched(0, "many", 2)
+	assert(i == (last[id] or 0) + 1)
+	last[id] = i
+end
+assert(l:count("many") == nil or l:count("many") == 0)
+
+-- a cancelled linda is reported
+l:cancel("both")
+local r, e = l:post("k", 1)
+assert(r == nil and e == lanes.cancel_error)
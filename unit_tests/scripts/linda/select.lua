@@ -0,0 +1,59 @@
+local lanes = require "lanes".configure{nb_user_keepers = 2}
+
+-- lindas that never wake up on their own: a waiting select() must be woken by the writes themselves
+local la = lanes.linda{name = "A", group = 1, wake_period = "never"}
+local lb = lanes.linda{name = "B", group = 2, wake_period = "never"}
+local ls = lanes.linda{name = "S", sharded = true, wake_period = "never"}
+
+-- bad arguments
+assert(pcall(lanes.select) == false)
+assert(pcall(lanes.select, {}) == false)
+assert(pcall(lanes.select, {{la}}) == false)
+assert(pcall(lanes.select, {{"not a linda", "k"}}) == false)
+assert(pcall(lanes.select, {{la, {}}}) == false)
+assert(pcall(lanes.select, -1, {{la, "k"}}) == false)
+-- a slot can't be listed twice, even in different sources of the same linda
+local ok, err = pcall(lanes.select, 0, {{la, "k1", "k2"}, {lb, "k1"}, {la, "k1"}})
+assert(ok == false and err:find("listed twice"), err)
+
+-- nothing to read
+local l, k, v = lanes.select(0, {{la, "k1"}, {lb, "k2"}})
+assert(l == nil and k == "timeout")
+
+-- sources are checked in order, then the slots of each source
+assert(lb:send("k2", "b") == true)
+assert(la:send("k1", "a") == true)
+l, k, v = lanes.select(0, {{la, "k0", "k1"}, {lb, "k2"}})
+assert(l == la and k == "k1" and v == "a")
+l, k, v = lanes.select(0, {{la, "k1"}, {lb, "k2"}})
+assert(l == lb and k == "k2" and v == "b")
+
+-- nil can be received
+assert(ls:send("k3", lanes.null) == true)
+l, k, v = lanes.select(0, {{la, "k1"}, {ls, "k3"}})
+assert(l == ls and k == "k3" and v == nil)
+
+-- a lane blocked on slots of several lindas is woken by a write in any of them
+local selector = lanes.gen("*", function(...) return lanes.select(5, {...}) end)
+for _, target in ipairs{la, lb, ls} do
+	local h = selector({la, "k1"}, {lb, "k2"}, {ls, "k3", "k4"})
+	repeat until h.status == "waiting"
+	local slot = (target == la) and "k1" or (target == lb) and "k2" or "k4"
+	assert(target:send(slot, tostring(target)) == true)
+	local r, l, k, v = h:join()
+	assert(r == true and l == target and k == slot and v == tostring(target))
+end
+
+-- cancelling any of the lindas wakes such a lane
+local h = selector({la, "k1"}, {lb, "k2"})
+repeat until h.status == "waiting"
+lb:cancel("read")
+local r, l, k = h:join()
+assert(r == true and l == nil and k == lanes.cancel_error)
+lb:cancel("none")
+
+-- and so does cancelling the lane
+h = selector({la, "k1"}, {lb, "k2"})
+repeat until h.status == "waiting"
+assert(h:cancel("soft", 1, true))
+assert(h.status == "done")
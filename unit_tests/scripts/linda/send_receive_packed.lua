@@ -0,0 +1,111 @@
+local lanes = require "lanes"
+local unpack = table.unpack or unpack
+
+local l = lanes.linda{name = "packed"}
+
+-- =================================================================================================
+-- scalars, strings and flat tables are stored packed, and come back unchanged
+-- =================================================================================================
+
+local flat = {1, 2.5, "three", true, [10] = false, name = "flat", [2.25] = "quarter"}
+local big = string.rep("0123456789", 1000) .. "\0tail"
+assert(l:send("k", 1, -2.5, "", "a\0b", true, false, nil, lanes.null, flat, big) == true)
+assert(l:count("k") == 10)
+
+-- get() peeks at the values without consuming them
+local n, v1, v2, v3 = l:get("k", 3)
+assert(n == 3 and v1 == 1 and v2 == -2.5 and v3 == "")
+
+local k, a, b, c, d, e, f, g, h, t, s = l:receive_batched("k", 10)
+assert(k == "k" and a == 1 and b == -2.5 and c == "" and d == "a\0b" and e == true and f == false)
+-- nil and lanes.null both come out as nil, as they do when stored in the keeper
+assert(g == nil and h == nil)
+assert(type(t) == "table" and t ~= flat and t[1] == 1 and t[2] == 2.5 and t[3] == "three" and t[4] == true)
+assert(t[10] == false and t.name == "flat" and t[2.25] == "quarter")
+assert(s == big)
+assert(l:count("k") == 0)
+if math.type then
+	assert(math.type(a) == "integer" and math.type(b) == "float")
+end
+
+-- =================================================================================================
+-- values that can't be packed go through the keeper, without disturbing the ordering
+-- =================================================================================================
+
+local nested = {sub = {1, 2, 3}}
+local with_mt = setmetatable({}, {__index = {x = "mt"}})
+local fn = function() return 42 end
+l:send("mixed", 1, "two")
+l:send("mixed", nested, 3)
+l:send("mixed", fn)
+l:send("mixed", 4)
+l:send("mixed", with_mt)
+local expected = {1, "two", "nested", 3, "fn", 4, "with_mt"}
+for i, x in ipairs(expected) do
+	local _k, _v = l:receive(0, "mixed")
+	if x == "nested" then
+		assert(type(_v) == "table" and _v.sub[3] == 3)
+	elseif x == "fn" then
+		assert(type(_v) == "function" and _v() == 42)
+	elseif x == "with_mt" then
+		assert(type(_v) == "table" and _v.x == "mt")
+	else
+		assert(_v == x, "value #" .. i)
+	end
+end
+assert(l:receive(0, "mixed") == nil)
+
+-- =================================================================================================
+-- a table given several times goes through the keeper, so that it is still a single table once received
+-- =================================================================================================
+
+local twice = {1, 2}
+assert(l:send("twice", twice, "sep", twice) == true)
+local _k, t1, sep, t2 = l:receive_batched("twice", 3)
+assert(type(t1) == "table" and t1 ~= twice and t1[2] == 2 and sep == "sep")
+assert(rawequal(t1, t2))
+-- distinct but identical tables are still delivered as distinct tables
+assert(l:send("twice", {1}, {1}) == true)
+_k, t1, t2 = l:receive_batched("twice", 2)
+assert(t1[1] == 1 and t2[1] == 1 and not rawequal(t1, t2))
+-- post() can't go through the keeper
+assert(pcall(l.post, l, "twice", twice, twice) == false)
+
+-- =================================================================================================
+-- dump() shows the packed values, set() discards them
+-- =================================================================================================
+
+l:send("dumped", "x", {y = 1})
+local dump = l:dump()
+assert(dump.dumped.count == 2 and dump.dumped.fifo[1] == "x" and dump.dumped.fifo[2].y == 1)
+assert(l:set("dumped", "z") == false)
+assert(select(2, l:get("dumped")) == "z")
+l:set("dumped")
+
+-- =================================================================================================
+-- packed values wait with the sender until there is room in the slot
+-- =================================================================================================
+
+l:limit("limited", 1)
+assert(l:send("limited", "first") == true)
+assert(l:send(0.1, "limited", "second") == nil)
+local sender = lanes.gen("*", function(linda_)
+	return linda_:send(5, "limited", "second")
+end)
+local h = sender(l)
+repeat until h.status == "waiting"
+assert(select(2, l:receive("limited")) == "first")
+assert(h:join() == true)
+local _k, _v = l:receive(0, "limited")
+assert(_v == "second")
+
+-- =================================================================================================
+-- a linda collected with packed values still in its slots frees them
+-- =================================================================================================
+
+do
+	local tmp = lanes.linda()
+	tmp:send("k", "some", "packed", {"values"})
+end
+collectgarbage()
+collectgarbage()
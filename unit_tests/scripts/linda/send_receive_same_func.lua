@@ -0,0 +1,42 @@
+local lanes = require "lanes"
+
+local l = lanes.linda()
+
+-- the bytecode of a function sent several times is dumped once, but its upvalues are copied each time
+local counter = 0
+local f = function() return counter end
+for i = 1, 5 do
+	counter = i
+	l:send("k", f)
+	local k, g = l:receive("k")
+	assert(k == "k" and g ~= f and g() == i, "got " .. tostring(g()))
+end
+
+-- different closures of the same prototype each carry their own upvalues
+local make = function(x) return function() return x end end
+l:send("k", make(1), make(2))
+local k, g1, g2 = l:receive_batched("k", 2)
+assert(g1() == 1 and g2() == 2)
+
+-- the function still reaches lanes intact after having been cached
+local lane = lanes.gen("*", { name = 'auto' }, function(f_) return f_() end)
+for i = 1, 3 do
+	counter = 10 * i
+	local ok, r = lane(f):join()
+	assert(ok == true and r == 10 * i)
+end
+
+-- the cache is emptied once it holds too much bytecode, which doesn't change what is transferred
+local load = loadstring or load
+local bigs = {}
+for i = 1, 40 do
+	bigs[i] = load("return " .. i .. ", '" .. string.rep("x", 10000) .. "'")
+end
+for _ = 1, 2 do
+	for i = 1, 40 do
+		l:send("k", bigs[i])
+		local k, g = l:receive("k")
+		local n, s = g()
+		assert(n == i and #s == 10000)
+	end
+end
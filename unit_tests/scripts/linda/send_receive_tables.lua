@@ -135,3 +135,126 @@ if true then
 	assert(c1_as_key == c1_as_value)
 	assert(c2_as_key == c2_as_value)
 end
+
+-- =================================================================================================
+-- send tables with an array part, a hash part, or both, making sure all entries are copied once
+-- =================================================================================================
+
+if true then
+	-- the subtable makes sure the tables are not stored packed, but copied through the keeper
+	local sub = {"sub"}
+	local arr = {}
+	for i = 1, 1000 do
+		arr[i] = (i % 4 == 0) and sub or (i % 4 == 1) and i or (i % 4 == 2) and ("s" .. i) or (i % 3 == 0)
+	end
+	arr[1001] = 1.5
+	local mixed = {10, 20, sub, 40, [6] = 60, [2.5] = "float key", [-1] = "negative", [0] = "zero", x = "x", [sub] = "table key"}
+	local holes = {1, nil, 3, nil, 5, sub}
+
+	l:send("data", arr, mixed, holes)
+	local k, a, m, h = l:receive_batched("data", 3)
+	assert(k == "data")
+
+	assert(#a == 1001 and a[1001] == 1.5)
+	for i = 1, 1000 do
+		local expected = arr[i]
+		if type(expected) == "table" then
+			assert(a[i] == a[4] and a[i][1] == "sub")
+		else
+			assert(a[i] == expected, "entry " .. i)
+		end
+	end
+	if math.type then
+		assert(math.type(a[1]) == "integer" and math.type(a[1001]) == "float")
+	end
+
+	local count = 0
+	for _ in pairs(m) do
+		count = count + 1
+	end
+	assert(count == 10, "got " .. count)
+	assert(m[1] == 10 and m[2] == 20 and m[3][1] == "sub" and m[4] == 40 and m[5] == nil and m[6] == 60)
+	assert(m[2.5] == "float key" and m[-1] == "negative" and m[0] == "zero" and m.x == "x" and m[m[3]] == "table key")
+
+	assert(h[1] == 1 and h[2] == nil and h[3] == 3 and h[4] == nil and h[5] == 5 and h[6][1] == "sub")
+
+	-- the same tables, as lane arguments
+	local check = lanes.gen("*", function(a_, m_, h_)
+		return #a_, a_[1001], a_[4] == a_[8], m_[6], m_[m_[3]], h_[5], h_[6] == a_[4]
+	end)
+	local ok, n, last, shared, six, tk, five, same = check(arr, mixed, holes):join()
+	assert(ok == true and n == 1001 and last == 1.5 and shared == true and six == 60 and tk == "table key" and five == 5 and same == true)
+end
+
+-- =================================================================================================
+-- send records, with shapes that repeat, change, grow and shrink, making sure the keys are never mixed up
+-- =================================================================================================
+
+if true then
+	-- the payload subtable makes sure the records are not stored packed, but copied through the keeper
+	local make = function(i_)
+		return {id = i_, ts = i_ * 0.5, payload = {i_}}
+	end
+	local check = function(r_, i_)
+		local count = 0
+		for _ in pairs(r_) do
+			count = count + 1
+		end
+		assert(count == 3 and r_.id == i_ and r_.ts == i_ * 0.5 and r_.payload[1] == i_)
+	end
+	for i = 1, 100 do
+		l:send("records", make(i))
+	end
+	for i = 1, 100 do
+		local k, r = l:receive("records")
+		assert(k == "records")
+		check(r, i)
+	end
+
+	-- records that share some keys with the previous ones
+	local variants = {
+		{id = 1, ts = 2, payload = {}, extra = "more"}, -- a longer shape
+		{id = 1, payload = {}}, -- a shorter one
+		{id = 1, ts = 2, other = {}}, -- a different key
+		{id = 1, ts = 2, payload = {}, [1] = "array", [2.5] = "number key"}, -- not a record
+		{id = 1, ts = 2, payload = {}, [string.rep("k", 100)] = "long key"}, -- a key too long to be cached
+		{}, -- empty
+	}
+	for _ = 1, 3 do
+		for _, v in ipairs(variants) do
+			l:send("variants", v)
+			local k, r = l:receive("variants")
+			assert(k == "variants")
+			local count = 0
+			for key, val in pairs(v) do
+				count = count + 1
+				if type(val) == "table" then
+					assert(type(r[key]) == "table")
+				else
+					assert(r[key] == val, "key " .. tostring(key))
+				end
+			end
+			for _ in pairs(r) do
+				count = count - 1
+			end
+			assert(count == 0)
+		end
+		-- go back to the first shape
+		l:send("records", make(42))
+		local _, r = l:receive("records")
+		check(r, 42)
+	end
+
+	-- records as lane arguments
+	local sum = lanes.gen("*", function(...)
+		local s = 0
+		for i = 1, select('#', ...) do
+			local r = select(i, ...)
+			assert(r.payload[1] == r.id)
+			s = s + r.id + r.ts
+		end
+		return s
+	end)
+	local ok, s = sum(make(1), make(2), make(3)):join()
+	assert(ok == true and s == 6 + 3)
+end
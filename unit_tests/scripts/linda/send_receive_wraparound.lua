@@ -0,0 +1,50 @@
+local lanes = require "lanes"
+
+-- interleave sends and receives so that the slot storage has to wrap around and grow while not empty
+local l = lanes.linda()
+local sent, received = 0, 0
+for round = 1, 50 do
+    for i = 1, round do
+        sent = sent + 1
+        assert(l:send("k", sent) == true)
+    end
+    for i = 1, math.floor(round / 2) do
+        received = received + 1
+        local k, v = l:receive(0, "k")
+        assert(k == "k" and v == received, "got " .. tostring(v) .. " instead of " .. received)
+    end
+end
+
+-- dump() shows the remaining values at their logical position, in order
+local t = l:dump().k
+assert(t.count == sent - received and t.first == received + 1, t.first .. " " .. t.count)
+for i = t.first, t.first + t.count - 1 do
+    assert(t.fifo[i] == i)
+end
+
+-- get() peeks at the oldest values without consuming them
+local n, v1, v2 = l:get("k", 2)
+assert(n == 2 and v1 == received + 1 and v2 == received + 2)
+
+-- batched receive extracts values in order across the wrap-around
+while received < sent do
+    local k, v1, v2, v3 = l:receive_batched(0, "k", 1, 3)
+    assert(k == "k")
+    for _, v in ipairs{v1, v2, v3} do
+        received = received + 1
+        assert(v == received)
+    end
+end
+assert(l:count("k") == 0)
+local t = l:dump().k
+assert(t.first == 1 and t.count == 0 and next(t.fifo) == nil)
+
+-- a limited slot keeps its limit semantics
+l:limit("l", 3)
+assert(l:send(0, "l", 1, 2) == true)
+local k, v = l:receive(0, "l")
+assert(k == "l" and v == 1)
+assert(l:send(0, "l", 3, 4) == true)
+local r, e = l:send(0, "l", 5)
+assert(r == nil and e == "timeout")
+assert(select('#', l:receive_batched(0, "l", 3)) == 4)
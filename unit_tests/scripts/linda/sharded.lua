@@ -0,0 +1,79 @@
+-- 3 keepers in addition to the one reserved for the timer linda: the slots of a sharded linda are spread over all 4
+local lanes = require "lanes".configure{nb_user_keepers = 3}
+local unpack = table.unpack or unpack
+
+-- a sharded linda can't have a group
+assert(pcall(lanes.linda, {sharded = true, group = 1}) == false)
+assert(pcall(lanes.linda, {sharded = "yes"}) == false)
+
+local l = lanes.linda{name = "sharded", sharded = true}
+
+-- single slot operations behave as usual, whatever the keeper that holds the slot
+local N_SLOTS = 32
+for s = 1, N_SLOTS do
+	assert(l:send("slot" .. s, s, s * 2) == true)
+	assert(l:set(s, "value" .. s) == false)
+end
+for s = 1, N_SLOTS do
+	local n, v = l:get(s)
+	assert(n == 1 and v == "value" .. s)
+	local k, v1, v2 = l:receive_batched("slot" .. s, 2)
+	assert(k == "slot" .. s and v1 == s and v2 == s * 2)
+end
+
+-- whole linda operations gather the slots of all keepers
+for s = 1, N_SLOTS do
+	assert(l:send("slot" .. s, s) == true)
+end
+local counts = l:count()
+local nb_slots = 0
+for k, n in pairs(counts) do
+	nb_slots = nb_slots + 1
+	assert(n == 1)
+end
+assert(nb_slots == 2 * N_SLOTS)
+local some = l:count("slot1", "slot2", "slot3", "slot4", "slot5", "unknown")
+assert(some.slot1 == 1 and some.slot5 == 1 and some.unknown == nil)
+local dump = l:dump()
+for s = 1, N_SLOTS do
+	assert(dump["slot" .. s].count == 1 and dump["slot" .. s].fifo[dump["slot" .. s].first] == s)
+	assert(dump[s].count == 1)
+end
+l:collectgarbage()
+
+-- receive() on slots held by different keepers polls them in turn
+local slots = {}
+for s = 1, 8 do
+	slots[s] = "slot" .. s
+end
+local seen = {}
+for i = 1, 8 do
+	local k, v = l:receive(0, unpack(slots))
+	assert(k and seen[k] == nil and v == tonumber(k:sub(5)))
+	seen[k] = true
+end
+assert(l:receive(0.1, unpack(slots)) == nil)
+
+-- a reader blocked on slots held by different keepers is woken by a write in any of them
+local multi = lanes.gen("*", function(linda_, ...) return linda_:receive(5, ...) end)
+local h = multi(l, unpack(slots))
+repeat until h.status == "waiting"
+l:send("slot8", "hello")
+local r, k, v = h:join()
+assert(r == true and k == "slot8" and v == "hello")
+
+-- cancelling the linda wakes such a reader too
+h = multi(l, unpack(slots))
+repeat until h.status == "waiting"
+l:cancel("read")
+local r, k, v = h:join()
+assert(r == true and k == nil and v == lanes.cancel_error)
+l:cancel("none")
+
+-- a sharded linda can't wait on too many slots spread over several keepers, and says so
+local too_many = {}
+for s = 1, 2 * N_SLOTS do
+	too_many[s] = "slot" .. s
+end
+local ok, err = pcall(l.receive, l, 0, unpack(too_many))
+assert(ok == false and err:find("more than %d+ slots"), err)
@@ -0,0 +1,90 @@
+local lanes = require "lanes"
+
+local l = lanes.linda{name = "slots"}
+
+-- a slot handle works on the same data as the linda itself
+local h = l:slot("k")
+assert(h:send(1, 2, 3) == true)
+assert(l:count("k") == 3)
+assert(h:receive() == 1)
+local k, v = l:receive("k")
+assert(k == "k" and v == 2)
+assert(l:send("k", 4) == true)
+assert(h:receive(0) == 3)
+assert(h:receive(0) == 4)
+local r, e = h:receive(0)
+assert(r == nil and e == "timeout")
+
+-- values that can't be serialized in native memory are copied as usual
+assert(h:send({1, {2}}, print) == true)
+local t = h:receive()
+assert(type(t) == "table" and t[1] == 1 and t[2][1] == 2)
+assert(h:receive() == print)
+
+-- get and set
+assert(h:set("a", "b") == false)
+local n, a, b = h:get(2)
+assert(n == 2 and a == "a" and b == "b")
+assert(l:get("k") == "a")
+-- emptying the slot doesn't invalidate the handle
+assert(h:set() == false)
+assert(l:count("k") == 0)
+assert(l:send("k", "again") == true)
+assert(h:get() == 1)
+assert(h:receive() == "again")
+assert(pcall(h.get, h, 0) == false)
+assert(pcall(h.send, h) == false)
+
+-- several handles on the same slot
+local h2 = l:slot("k")
+assert(h:send("shared") == true)
+assert(h2:receive() == "shared")
+
+-- restrictions are enforced
+l:restrict("r", "set/get")
+local hr = l:slot("r")
+assert(pcall(hr.send, hr, 1) == false)
+assert(pcall(hr.receive, hr, 0) == false)
+assert(hr:set(1) == false)
+l:restrict("r", "send/receive")
+assert(pcall(hr.set, hr, 1) == false)
+assert(pcall(hr.get, hr) == false)
+
+-- limits are enforced, and a blocked handle is woken like a blocked linda operation
+l:limit("lim", 1)
+local hl = l:slot("lim")
+assert(hl:send("x") == true)
+local writer = lanes.gen("*", function(l_) return l_:slot("lim"):send("y") end)(l)
+repeat until writer.status == "waiting"
+assert(hl:receive() == "x")
+assert(writer:join() == true)
+assert(hl:receive() == "y")
+
+-- a reader blocked on a handle is woken by linda:send()
+local reader = lanes.gen("*", function(l_) return l_:slot("wake"):receive(5) end)(l)
+repeat until reader.status == "waiting"
+assert(l:send("wake", "up") == true)
+local ok, up = reader:join()
+assert(ok == true and up == "up")
+
+-- handles can't be sent through a linda
+assert(pcall(l.send, l, "h", h) == false)
+
+-- handles keep the linda alive
+local hk = lanes.linda():slot("orphan")
+collectgarbage()
+assert(hk:send("still") == true)
+assert(hk:receive() == "still")
+
+-- once the handles are collected, an empty slot can be removed from the linda again
+h, h2, hk = nil, nil, nil
+collectgarbage()
+collectgarbage()
+l:set("k")
+assert(l:dump()["k"] == nil)
+
+-- a cancelled linda is reported
+l:cancel("both")
+local hc = l:slot("k")
+local r2, e2 = hc:get()
+assert(r2 == nil and e2 == lanes.cancel_error)
@@ -0,0 +1,37 @@
+local lanes = require "lanes".configure{linda_spin = 0.0001}
+
+-- values go through a spinning linda just as through a blocking one
+local pingpong = lanes.gen("*", function(q, qr, qs, start, rounds)
+	if start then
+		q:send(qs, 0)
+	end
+	local val
+	for i = 1, rounds do
+		local key
+		key, val = q:receive(1, qr)
+		assert(key == qr, "receive timed out")
+		q:send(qs, val + 1)
+	end
+	return val
+end)
+for _, q in ipairs{lanes.linda{name = "default spin"}, lanes.linda{name = "no spin", spin = 0}, lanes.linda{name = "long spin", spin = 1}} do
+	local h1 = pingpong(q, "a", "b", true, 100)
+	local h2 = pingpong(q, "b", "a", false, 100)
+	local r1, v1 = h1:join()
+	local r2, v2 = h2:join()
+	assert(r1 == true and r2 == true)
+	assert(v1 == 199 and v2 == 198)
+end
+
+-- spinning never extends an operation past its timeout
+local l = lanes.linda{name = "spin", spin = 10}
+local t0 = lanes.now_secs()
+assert(l:receive(0.2, "empty") == nil)
+assert(lanes.now_secs() - t0 < 2)
+
+-- cancelling the linda interrupts a spinning lane
+local h = lanes.gen("*", function() return l:receive(5, "empty") end)()
+repeat until h.status == "waiting"
+l:cancel("read")
+local r, k = h:join()
+assert(r == true and k == lanes.cancel_error)
@@ -0,0 +1,56 @@
+local lanes = require "lanes".configure{nb_user_keepers = 2}
+
+local l = lanes.linda{name = "stats", group = 1}
+
+-- a fresh linda has no traffic
+local s = l:stats()
+assert(s.sends == 0 and s.receives == 0 and s.bytes == 0)
+assert(s.send_timeouts == 0 and s.receive_timeouts == 0)
+assert(s.send_wait == 0 and s.receive_wait == 0)
+assert(next(s.slots) == nil)
+assert(s.keepers[1].acquisitions > 0 and s.keepers[1].wait >= 0 and s.keepers[1].hold >= 0)
+
+-- sends and receives are counted per value, per linda and per slot
+assert(l:send("a", 1, 2, 3) == true)
+assert(l:send("b", "hello") == true)
+assert(l:receive("a") == "a")
+assert(select("#", l:receive_batched("a", 2)) == 3)
+s = l:stats()
+assert(s.sends == 4 and s.receives == 3)
+-- the values sent were serialized in native memory
+assert(s.bytes > 0)
+assert(s.slots.a.sends == 3 and s.slots.a.receives == 3 and s.slots.a.count == 0 and s.slots.a.max_count == 3)
+assert(s.slots.b.sends == 1 and s.slots.b.receives == 0 and s.slots.b.count == 1 and s.slots.b.max_count == 1)
+assert(s.slots.b.bytes > 0)
+
+-- timeouts
+assert(l:receive(0, "empty") == nil)
+l:limit("b", 1)
+assert(l:send(0, "b", "full") == nil)
+s = l:stats()
+assert(s.receive_timeouts == 1 and s.send_timeouts == 1)
+-- a failed send doesn't count
+assert(s.sends == 4 and s.slots.b.sends == 1)
+
+-- time spent blocked is accumulated
+assert(l:receive(0.2, "empty") == nil)
+assert(l:send(0.2, "b", "full") == nil)
+s = l:stats()
+assert(s.receive_wait > 0.1 and s.send_wait > 0.1)
+
+-- a sharded linda reports the slots and the keepers of all its shards
+local sl = lanes.linda{name = "sharded stats", sharded = true}
+for i = 1, 16 do
+	sl:send(i, i)
+end
+s = sl:stats()
+assert(s.sends == 16)
+local nb_slots, nb_keepers = 0, 0
+for k, v in pairs(s.slots) do
+	nb_slots = nb_slots + 1
+	assert(v.sends == 1 and v.count == 1)
+end
+for k, v in pairs(s.keepers) do
+	nb_keepers = nb_keepers + 1
+end
+assert(nb_slots == 16 and nb_keepers == 3)
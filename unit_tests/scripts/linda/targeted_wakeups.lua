@@ -0,0 +1,105 @@
+local lanes = require "lanes"
+
+-- readers blocked on separate slots, each one only woken by writes in its own slot
+local l = lanes.linda{name = "targeted wakeups"}
+
+local reader = function(linda_, slot_, count_)
+	local sum = 0
+	for i = 1, count_ do
+		local k, v = linda_:receive(5, slot_)
+		assert(k == slot_, "receive on " .. tostring(slot_) .. " failed: " .. tostring(v))
+		sum = sum + v
+	end
+	return sum
+end
+
+-- several readers per slot: single-value sends wake one reader at a time, and every value must be consumed
+local N_SLOTS, N_READERS, N_VALUES = 4, 3, 20
+local readers = {}
+for s = 1, N_SLOTS do
+	for r = 1, N_READERS do
+		readers[#readers + 1] = lanes.gen("*", reader)(l, "slot" .. s, N_VALUES)
+	end
+end
+-- wait until all readers are blocked
+for _, h in ipairs(readers) do
+	repeat until h.status == "waiting"
+end
+local expected = {}
+for s = 1, N_SLOTS do
+	expected["slot" .. s] = 0
+	for i = 1, N_VALUES * N_READERS do
+		assert(l:send("slot" .. s, i) == true)
+		expected["slot" .. s] = expected["slot" .. s] + i
+	end
+end
+local total = {}
+for i, h in ipairs(readers) do
+	local slot = "slot" .. (math.floor((i - 1) / N_READERS) + 1)
+	local r, sum = h:join()
+	assert(r == true, "reader failed: " .. tostring(sum))
+	total[slot] = (total[slot] or 0) + sum
+end
+for s = 1, N_SLOTS do
+	assert(total["slot" .. s] == expected["slot" .. s])
+	assert(l:count("slot" .. s) == 0)
+end
+
+-- a reader waiting on several slots is woken by a write in any of them
+local multi = lanes.gen("*", function(linda_) return linda_:receive(5, "a", "b", "c") end)(l)
+repeat until multi.status == "waiting"
+l:send("c", "hello")
+local r, k, v = multi:join()
+assert(r == true and k == "c" and v == "hello")
+
+-- a writer blocked on a full slot is woken when room is made in that slot
+l:limit("full", 1)
+assert(l:send("full", 1) == true)
+local writer = lanes.gen("*", function(linda_) return linda_:send(5, "full", 2) end)(l)
+repeat until writer.status == "waiting"
+-- reading another slot doesn't unblock the writer
+l:send("other", 0)
+l:receive("other")
+assert(writer.status == "waiting")
+local k, v = l:receive("full")
+assert(k == "full" and v == 1)
+local r, sent = writer:join()
+assert(r == true and sent == true)
+assert(select(2, l:get("full")) == 2)
+
+-- a cancelled reader doesn't prevent the other readers of the slot from being served
+local waiting = lanes.gen("*", function(linda_) return linda_:receive(5, "baton") end)
+local h1, h2 = waiting(l), waiting(l)
+repeat until h1.status == "waiting" and h2.status == "waiting"
+assert(h1:cancel("soft", 1, true))
+l:send("baton", "ok")
+local r, k, v = h2:join()
+assert(r == true and k == "baton" and v == "ok")
+
+-- slots of different types that hash alike are told apart: a single-value send to false doesn't stop at a reader of 0
+local zero = lanes.gen("*", function(linda_) return linda_:receive(5, 0) end)(l)
+repeat until zero.status == "waiting"
+local nope = lanes.gen("*", function(linda_) return linda_:receive(5, false) end)(l)
+repeat until nope.status == "waiting"
+assert(l:send(false, "f") == true)
+local rf, kf, vf = nope:join(2)
+assert(rf == true and kf == false and vf == "f", "the reader of false wasn't woken")
+assert(l:send(0, "z") == true)
+local rz, kz, vz = zero:join()
+assert(rz == true and kz == 0 and vz == "z")
+
+-- slots of the same type whose ids collide are not told apart: a single-value send wakes all their readers
+-- these two floats differ only in the lowest bit of their mantissa, which their slot id doesn't keep
+local f1, f2 = 0.5, 0.5 + 2^-53
+assert(f1 ~= f2)
+local first = lanes.gen("*", function(linda_, slot_) return linda_:receive(5, slot_) end)(l, f1)
+repeat until first.status == "waiting"
+local second = lanes.gen("*", function(linda_, slot_) return linda_:receive(5, slot_) end)(l, f2)
+repeat until second.status == "waiting"
+assert(l:send(f2, "second") == true)
+local r2, k2, v2 = second:join(2)
+assert(r2 == true and k2 == f2 and v2 == "second", "the reader of the colliding slot wasn't woken")
+assert(first.status == "waiting")
+assert(l:send(f1, "first") == true)
+local r1, k1, v1 = first:join()
+assert(r1 == true and k1 == f1 and v1 == "first")